@@ -1941,8 +1941,8 @@ void CApplication::Render()
 
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
-  // isn't called)
-  g_infoManager.ResetCache();
+  // isn't called). Conditions whose sources did not change keep their value.
+  g_infoManager.ResetFrameCache();
 
   if (hasRendered)
   {
@@ -2819,6 +2819,7 @@ bool CApplication::Cleanup()
     g_localizeStrings.Clear();
     g_LangCodeExpander.Clear();
     g_charsetConverter.clear();
+    g_directoryCache.Flush();
     g_directoryCache.Clear();
     CButtonTranslator::GetInstance().Clear();
 #ifdef HAS_EVENT_SERVER
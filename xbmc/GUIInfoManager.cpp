@@ -149,6 +149,10 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowTime = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
+  m_dirtySources = INFO::SOURCE_CONSTANT;
+  m_playerState = 0;
+  m_boolEvaluations = 0;
+  m_lastBoolEvaluations = 0;
   ResetLibraryBools();
 }
 
@@ -6832,12 +6836,53 @@ bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWin
   return result;
 }
 
+/// \brief Returns the INFO::InfoSource flags whose change may alter the value of the condition.
+/// Anything not known to depend only on skin settings or the player state is volatile.
+unsigned int CGUIInfoManager::GetConditionSources(int condition) const
+{
+  condition = abs(condition);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    switch (abs(m_multiInfo[condition - MULTI_INFO_START].m_info))
+    {
+    case SKIN_BOOL:
+    case SKIN_STRING:
+      return INFO::SOURCE_SKIN;
+    default:
+      return INFO::SOURCE_VOLATILE;
+    }
+  }
+
+  switch (condition)
+  {
+  case SYSTEM_ALWAYS_TRUE:
+  case SYSTEM_ALWAYS_FALSE:
+  case SYSTEM_ETHERNET_LINK_ACTIVE:
+  case SYSTEM_PLATFORM_LINUX:
+  case SYSTEM_PLATFORM_WINDOWS:
+  case SYSTEM_PLATFORM_DARWIN:
+  case SYSTEM_PLATFORM_DARWIN_OSX:
+  case SYSTEM_PLATFORM_DARWIN_IOS:
+  case SYSTEM_PLATFORM_ANDROID:
+  case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+    return INFO::SOURCE_CONSTANT;
+  case PLAYER_HAS_MEDIA:
+  case PLAYER_HAS_AUDIO:
+  case PLAYER_HAS_VIDEO:
+  case PLAYER_PAUSED:
+    return INFO::SOURCE_PLAYER;
+  default:
+    return INFO::SOURCE_VOLATILE;
+  }
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
 {
   bool bReturn = false;
   int condition = abs(condition1);
+  m_boolEvaluations++;
 
   if (condition >= LISTITEM_START && condition < LISTITEM_END)
   {
@@ -10797,6 +10842,50 @@ void CGUIInfoManager::ResetCache()
     (*i)->SetDirty();
 }
 
+void CGUIInfoManager::ResetFrameCache()
+{
+  // the player does not notify about all of its state changes, so compare
+  // against what we saw last frame
+  int playerState = 0;
+  if (g_application.m_pPlayer->IsPlaying())
+  {
+    playerState |= 0x01;
+    if (g_application.m_pPlayer->IsPlayingAudio())
+      playerState |= 0x02;
+    if (g_application.m_pPlayer->IsPlayingVideo())
+      playerState |= 0x04;
+    if (g_application.m_pPlayer->IsPausedPlayback())
+      playerState |= 0x08;
+  }
+
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+
+  CSingleLock lock(m_critInfo);
+  unsigned int sources = INFO::SOURCE_VOLATILE | m_dirtySources;
+  m_dirtySources = INFO::SOURCE_CONSTANT;
+  if (playerState != m_playerState)
+  {
+    m_playerState = playerState;
+    sources |= INFO::SOURCE_PLAYER;
+  }
+
+  // mark only those infobools dirty that may have changed
+  for (std::vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
+  {
+    if ((*i)->GetSources() & sources)
+      (*i)->SetDirty();
+  }
+
+  m_lastBoolEvaluations = m_boolEvaluations.exchange(0);
+}
+
+void CGUIInfoManager::SetDirty(unsigned int sources)
+{
+  CSingleLock lock(m_critInfo);
+  m_dirtySources |= sources;
+}
+
 std::string CGUIInfoManager::GetPictureLabel(int info)
 {
   if (info == SLIDE_FILE_NAME)
@@ -38,6 +38,7 @@
 #include "cores/IPlayer.h"
 #include "FileItem.h"
 
+#include <atomic>
 #include <memory>
 #include <list>
 #include <map>
@@ -213,7 +214,28 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Mark all info bools dirty, forcing them to be re-evaluated on next use
+   \sa ResetFrameCache
+   */
   void ResetCache();
+
+  /*! \brief Per-frame cache reset
+   Only marks those info bools dirty that depend on volatile sources, or on a
+   source that changed since the last frame.
+   \sa SetDirty, ResetCache
+   */
+  void ResetFrameCache();
+
+  /*! \brief Notify that a source of info bools changed
+   The affected info bools are re-evaluated from the next frame on. Safe to call from any thread.
+   \param sources INFO::InfoSource flags that changed
+   */
+  void SetDirty(unsigned int sources);
+
+  /*! \brief Number of conditions evaluated during the last frame
+   */
+  unsigned int GetBoolEvaluations() const { return m_lastBoolEvaluations; }
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -247,6 +269,7 @@ protected:
   friend class INFO::InfoSingle;
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
+  unsigned int GetConditionSources(int condition) const;
 
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
@@ -337,6 +360,10 @@ protected:
   int m_prevWindowID;
 
   std::vector<INFO::InfoPtr> m_bools;
+  unsigned int m_dirtySources;             ///< INFO::InfoSource flags changed since the last frame
+  int m_playerState;                       ///< player state flags seen during the last frame
+  std::atomic<unsigned int> m_boolEvaluations;
+  unsigned int m_lastBoolEvaluations;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   int m_libraryHasMusic;
@@ -70,6 +70,13 @@ CAddonCallbacksAudioEngine::CAddonCallbacksAudioEngine(CAddon* addon)
   m_callbacks->AEStream_SetResampleRatio      = AEStream_SetResampleRatio;
 }
 
+// the options of add-ons are passed on to the engine as they are
+static_assert(AUDIO_STREAM_FORCE_RESAMPLE == (int)AESTREAM_FORCE_RESAMPLE &&
+              AUDIO_STREAM_PAUSED == (int)AESTREAM_PAUSED &&
+              AUDIO_STREAM_AUTOSTART == (int)AESTREAM_AUTOSTART &&
+              AUDIO_STREAM_BYPASS_ADSP == (int)AESTREAM_BYPASS_ADSP &&
+              AUDIO_STREAM_LOW_LATENCY == (int)AESTREAM_LOW_LATENCY, "stream options of add-ons and engine differ");
+
 AEStreamHandle* CAddonCallbacksAudioEngine::AudioEngine_MakeStream(AudioEngineFormat StreamFormat, unsigned int Options)
 {
   AEAudioFormat format;
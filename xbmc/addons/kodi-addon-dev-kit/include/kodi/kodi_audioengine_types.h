@@ -75,6 +75,18 @@ extern "C" {
    */
   typedef void AEStreamHandle;
 
+  /**
+   * Bit options to pass to MakeStream
+   */
+  typedef enum AudioEngineStreamOptions
+  {
+    AUDIO_STREAM_FORCE_RESAMPLE = 1 << 0,   /* force resample even if rates match */
+    AUDIO_STREAM_PAUSED         = 1 << 1,   /* create the stream paused */
+    AUDIO_STREAM_AUTOSTART      = 1 << 2,   /* autostart the stream when enough data is buffered */
+    AUDIO_STREAM_BYPASS_ADSP    = 1 << 3,   /* bypass the ADSP-System */
+    AUDIO_STREAM_LOW_LATENCY    = 1 << 4    /* keep buffering to a minimum, i.e. for games and interactive sounds */
+  } AudioEngineStreamOptions;
+
   /**
    * The audio format structure that fully defines a stream's audio information
    */
@@ -110,7 +110,7 @@ public:
    * @param DataFormat The data format the incoming audio will be in (eg, AE_FMT_S16LE)
    * @param SampleRate The sample rate of the audio data (eg, 48000)
    * @param ChannelLayout The order of the channels in the audio data
-   * @param Options A bit field of stream options (see: enum AEStreamOptions)
+   * @param Options A bit field of stream options (see: enum AudioEngineStreamOptions)
    * @return a new Handle to an IAEStream that will accept data in the requested format
    */
   CAddonAEStream* MakeStream(AudioEngineFormat Format, unsigned int Options = 0)
@@ -25,6 +25,7 @@ using namespace ActiveAE;
 #include "ActiveAEStream.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSPProcess.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
@@ -41,6 +42,9 @@ using namespace ActiveAE;
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
+#define LOW_LATENCY_CACHE_LEVEL 0.005 // total cache time of low latency streams in seconds
+#define LOW_LATENCY_WATER_LEVEL 0.005 // buffered time after stream stages while only low latency streams play
+#define LOW_LATENCY_TARGET 0.02       // end-to-end latency low latency streams aim for in seconds
 
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
@@ -218,7 +222,30 @@ float CEngineStats::GetCacheTime(CActiveAEStream *stream)
 
 float CEngineStats::GetCacheTotal(CActiveAEStream *stream)
 {
-  return MAX_CACHE_LEVEL + m_sinkCacheTotal;
+  return (stream->m_lowLatency ? LOW_LATENCY_CACHE_LEVEL : MAX_CACHE_LEVEL) + m_sinkCacheTotal;
+}
+
+float CEngineStats::GetMaxLatency(CActiveAEStream *stream)
+{
+  float waterLevel = stream->m_lowLatency ? LOW_LATENCY_WATER_LEVEL : MAX_WATER_LEVEL;
+  return GetCacheTotal(stream) + waterLevel + m_sinkLatency;
+}
+
+float CEngineStats::GetMaxWaterLevel(std::list<CActiveAEStream*> &streams, bool soundsPlaying)
+{
+  // all streams are mixed into the same output, it can only be kept short
+  // while everything that plays asks for low latency. gui sounds on their
+  // own are interactive too
+  bool lowLatency = streams.empty() && soundsPlaying;
+  for (auto stream : streams)
+  {
+    if (stream->m_paused || !stream->m_started)
+      continue;
+    if (!stream->m_lowLatency)
+      return MAX_WATER_LEVEL;
+    lowLatency = true;
+  }
+  return lowLatency ? LOW_LATENCY_WATER_LEVEL : MAX_WATER_LEVEL;
 }
 
 float CEngineStats::GetWaterLevel()
@@ -274,6 +301,8 @@ CActiveAE::CActiveAE() :
 {
   m_sinkBuffers = NULL;
   m_silenceBuffers = NULL;
+  m_sampleArenaSize = 0;
+  m_sampleArenaTime = 0;
   m_encoderBuffers = NULL;
   m_vizBuffers = NULL;
   m_vizBuffersInput = NULL;
@@ -294,6 +323,7 @@ CActiveAE::CActiveAE() :
 CActiveAE::~CActiveAE()
 {
   Dispose();
+  ClearSampleArena();
 }
 
 void CActiveAE::Dispose()
@@ -716,21 +746,6 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
           else
             msg->Reply(CActiveAEDataProtocol::ERR);
           return;
-        case CActiveAEDataProtocol::STREAMSAMPLE:
-          MsgStreamSample *msgData;
-          CSampleBuffer *samples;
-          msgData = (MsgStreamSample*)msg->data;
-          samples = msgData->stream->m_processingSamples.front();
-          msgData->stream->m_processingSamples.pop_front();
-          if (samples != msgData->buffer)
-            CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample message");
-          if (msgData->buffer->pkt->nb_samples == 0)
-            msgData->buffer->Return();
-          else
-            msgData->stream->m_processingBuffers->m_inputSamples.push_back(msgData->buffer);
-          m_extTimeout = 0;
-          m_state = AE_TOP_CONFIGURED_PLAY;
-          return;
         case CActiveAEDataProtocol::FREESTREAM:
           stream = *(CActiveAEStream**)msg->data;
           DiscardStream(stream);
@@ -881,6 +896,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         case CActiveAEControlProtocol::TIMEOUT:
           ResampleSounds();
           ClearDiscardedBuffers();
+          TrimSampleArena();
           if (m_extDrain)
           {
             if (m_extDrainTimer.IsTimePast())
@@ -994,6 +1010,11 @@ void CActiveAE::Process()
       gotMsg = true;
       port = &m_sink.m_dataPort;
     }
+    // check buffers returned by sink
+    else if (ReceiveSinkSamples())
+    {
+      continue;
+    }
     else if (!m_extDeferData)
     {
       // check data port
@@ -1029,6 +1050,12 @@ void CActiveAE::Process()
       continue;
     }
 
+    // check samples delivered by streams
+    else if (!m_extDeferData && ReceiveStreamSamples())
+    {
+      continue;
+    }
+
     // wait for message
     else if (m_outMsgEvent.WaitMSec(m_extTimeout))
     {
@@ -1293,7 +1320,11 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         if (useDSP && !(*it)->m_bypassDSP)
           (*it)->m_processingBuffers->SetExtraData((*it)->m_profile, (*it)->m_matrixEncoding, (*it)->m_audioServiceType);
-        (*it)->m_processingBuffers->Create(MAX_CACHE_LEVEL*1000, false, m_settings.stereoupmix, m_settings.normalizelevels, useDSP);
+        if (!(*it)->m_processingBuffers->Create(MAX_CACHE_LEVEL*1000, false, m_settings.stereoupmix, m_settings.normalizelevels, useDSP))
+        {
+          CLog::Log(LOGERROR, "CActiveAE::%s - failed to create stream buffers", __FUNCTION__);
+          m_extError = true;
+        }
 
         m_stats.SetDSP(useDSP);
       }
@@ -1302,6 +1333,10 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
       // amplification
       (*it)->m_limiter.SetSamplerate(outputFormat.m_sampleRate);
+
+      if ((*it)->m_lowLatency && m_stats.GetMaxLatency(*it) > LOW_LATENCY_TARGET)
+        CLog::Log(LOGWARNING, "ActiveAE::%s - low latency stream will take up to %d ms, sink buffers too large for %d ms",
+                  __FUNCTION__, (int)(m_stats.GetMaxLatency(*it) * 1000), (int)(LOW_LATENCY_TARGET * 1000));
     }
 
     // update buffered time of streams
@@ -1353,7 +1388,11 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   if (!m_sinkBuffers)
   {
     m_sinkBuffers = new CActiveAEBufferPoolResample(sinkInputFormat, m_sinkFormat, m_settings.resampleQuality);
-    m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
+    if (!m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false))
+    {
+      CLog::Log(LOGERROR, "CActiveAE::%s - failed to create sink buffers", __FUNCTION__);
+      m_extError = true;
+    }
   }
 
   // reset gui sounds
@@ -1400,6 +1439,7 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
   stream = new CActiveAEStream(&streamMsg->format, m_streamIdGen++);
   stream->m_streamPort = new CActiveAEDataProtocol("stream",
                              &stream->m_inMsgEvent, &m_outMsgEvent);
+  stream->m_engineEvent = &m_outMsgEvent;
 
   // create buffer pool
   stream->m_inputBuffers = NULL; // create in Configure when we know the sink format
@@ -1423,6 +1463,12 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
     stream->m_bypassDSP = true;
   }
 
+  if (streamMsg->options & AESTREAM_LOW_LATENCY)
+  {
+    stream->m_lowLatency = true;
+    CLog::Log(LOGDEBUG, "CActiveAE::CreateStream - low latency stream requested");
+  }
+
   stream->m_pClock = streamMsg->clock;
 
   m_streams.push_back(stream);
@@ -1474,6 +1520,9 @@ void CActiveAE::SFlushStream(CActiveAEStream *stream)
   }
   stream->m_processingBuffers->Flush();
   stream->m_streamPort->Purge();
+  // the stream waits for our reply, both ends of the queues are idle
+  stream->m_freeQueue.Reset();
+  stream->m_sampleQueue.Reset();
   stream->m_bufferedTime = 0.0;
   stream->m_paused = false;
   stream->m_syncState = CAESyncInfo::AESyncState::SYNC_START;
@@ -1826,6 +1875,60 @@ void CActiveAE::UnconfigureSink()
 }
 
 
+bool CActiveAE::ReceiveStreamSamples()
+{
+  // samples are only accepted by configured states
+  if (m_state != AE_TOP_CONFIGURED &&
+      m_state != AE_TOP_CONFIGURED_IDLE &&
+      m_state != AE_TOP_CONFIGURED_PLAY)
+    return false;
+
+  bool gotSamples = false;
+  CSampleBuffer *buffer;
+  std::list<CActiveAEStream*>::iterator it;
+  for (it = m_streams.begin(); it != m_streams.end(); ++it)
+  {
+    while ((*it)->m_sampleQueue.Pop(buffer))
+    {
+      if ((*it)->m_processingSamples.empty() || (*it)->m_processingSamples.front() != buffer)
+        CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample queue");
+      else
+        (*it)->m_processingSamples.pop_front();
+      if (buffer->pkt->nb_samples == 0)
+        buffer->Return();
+      else
+        (*it)->m_processingBuffers->m_inputSamples.push_back(buffer);
+      gotSamples = true;
+    }
+  }
+
+  if (gotSamples)
+  {
+    m_extTimeout = 0;
+    m_state = AE_TOP_CONFIGURED_PLAY;
+  }
+  return gotSamples;
+}
+
+bool CActiveAE::ReceiveSinkSamples()
+{
+  bool gotSamples = false;
+  CSampleBuffer *buffer;
+  while (m_sink.m_returnQueue.Pop(buffer))
+  {
+    buffer->Return();
+    gotSamples = true;
+  }
+
+  if (gotSamples &&
+      (m_state == AE_TOP_CONFIGURED_IDLE || m_state == AE_TOP_CONFIGURED_PLAY))
+  {
+    m_extTimeout = 0;
+    m_state = AE_TOP_CONFIGURED_PLAY;
+  }
+  return gotSamples;
+}
+
 bool CActiveAE::RunStages()
 {
   bool busy = false;
@@ -1853,14 +1956,21 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      float maxCache = (*it)->m_lowLatency ? LOW_LATENCY_CACHE_LEVEL : MAX_CACHE_LEVEL;
+      bool newBuffers = false;
+      while ((time < maxCache || (*it)->m_streamIsBuffering) &&
+             !(*it)->m_inputBuffers->m_freeSamples.empty() &&
+             (*it)->m_processingSamples.size() < (*it)->m_freeQueue.Capacity())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
-        (*it)->m_streamPort->SendInMessage(CActiveAEDataProtocol::STREAMBUFFER, &buffer, sizeof(CSampleBuffer*));
+        (*it)->m_freeQueue.Push(buffer);
         (*it)->IncFreeBuffers();
         time += buftime;
+        newBuffers = true;
       }
+      if (newBuffers)
+        (*it)->m_inMsgEvent.Set();
     }
     else
     {
@@ -1892,7 +2002,7 @@ bool CActiveAE::RunStages()
     }
   }
 
-  if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
+  if (m_stats.GetWaterLevel() < m_stats.GetMaxWaterLevel(m_streams, !m_sounds_playing.empty()) &&
      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
     // calculate sync error
@@ -1949,6 +2059,7 @@ bool CActiveAE::RunStages()
           allStreamsReady = false;
       }
 
+      const AEKernels &kernels = CAEKernels::Get();
       bool needClamp = false;
       for (it = m_streams.begin(); it != m_streams.end() && allStreamsReady; ++it)
       {
@@ -2009,38 +2120,14 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            int nb_gains = CalcStreamGains(*it, out, nb_loops, nb_floats, fadingStep);
+            for(int j=0; j<out->pkt->planes; j++)
             {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
-
-              for(int j=0; j<out->pkt->planes; j++)
-              {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
+              float *fbuffer = (float*)out->pkt->data[j];
+              if (nb_gains == 1)
+                kernels.Mul(fbuffer, m_streamGains[0], nb_floats);
+              else
+                kernels.MulGains(fbuffer, m_streamGains.data(), nb_gains);
             }
           }
           else
@@ -2076,49 +2163,18 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            int nb_gains = CalcStreamGains(*it, mix, nb_loops, nb_floats, fadingStep);
+            for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
             {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
+              float *dst = (float*)out->pkt->data[j];
+              float *src = (float*)mix->pkt->data[j];
+              if (nb_gains == 1)
+                kernels.MulAdd(dst, src, m_streamGains[0], nb_floats);
+              else
+                kernels.MulAddGains(dst, src, m_streamGains.data(), nb_gains);
 
-              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
-              {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
-              }
+              if (!needClamp && kernels.Peak(dst, nb_gains == 1 ? nb_floats : nb_gains) > 1.0f)
+                needClamp = true;
             }
             mix->Return();
           }
@@ -2132,7 +2188,7 @@ bool CActiveAE::RunStages()
         int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
         for(int i=0; i<out->pkt->planes; i++)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          kernels.Clamp((float*)out->pkt->data[i], nb_floats);
         }
       }
 
@@ -2280,6 +2336,45 @@ bool CActiveAE::HasWork()
   return false;
 }
 
+int CActiveAE::CalcStreamGains(CActiveAEStream *stream, CSampleBuffer *buffer, int nb_loops, int nb_floats, float fadingStep)
+{
+  // fading and the limiter change the volume from frame to frame, expand it
+  // to one gain per sample of a plane so that it can be applied in a single pass
+  if (nb_loops > 1)
+    m_streamGains.resize(nb_loops * nb_floats);
+  else
+    m_streamGains.resize(1);
+
+  for(int i=0; i<nb_loops; i++)
+  {
+    if (stream->m_fadingSamples > 0)
+    {
+      stream->m_volume += fadingStep;
+      stream->m_fadingSamples--;
+
+      if (stream->m_fadingSamples == 0)
+      {
+        // set variables being polled via stream interface
+        CSingleLock lock(stream->m_streamLock);
+        stream->m_streamFading = false;
+      }
+    }
+
+    // volume for stream
+    float volume = stream->m_volume * stream->m_rgain;
+    if(nb_loops == 1)
+    {
+      m_streamGains[0] = volume;
+      return 1;
+    }
+
+    volume *= stream->m_limiter.Run((float**)buffer->pkt->data, buffer->pkt->config.channels, i*nb_floats, buffer->pkt->planes > 1);
+    std::fill_n(m_streamGains.begin() + i*nb_floats, nb_floats, volume);
+  }
+
+  return nb_loops * nb_floats;
+}
+
 CSampleBuffer* CActiveAE::SyncStream(CActiveAEStream *stream)
 {
   CSampleBuffer *ret = NULL;
@@ -2502,12 +2597,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::Get().MulAdd(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2533,13 +2623,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       buffer = (float*)dstSample.data[j];
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::Get().Mul(buffer, volume, nb_floats);
     }
   }
 }
@@ -2890,6 +2974,9 @@ void CActiveAE::OnAppFocusChange(bool focus)
 // Utils
 //-----------------------------------------------------------------------------
 
+#define MAX_SAMPLE_ARENA_SIZE (8 * 1024 * 1024)
+#define SAMPLE_ARENA_TIMEOUT 10000
+
 uint8_t **CActiveAE::AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize)
 {
   uint8_t **buffer;
@@ -2897,18 +2984,78 @@ uint8_t **CActiveAE::AllocSoundSample(SampleConfig &config, int &samples, int &b
   buffer = new uint8_t*[planes];
 
   // align buffer to 16 in order to be compatible with sse in CAEConvert
-  av_samples_alloc(buffer, &linesize, config.channels,
-                                 samples, config.fmt, 16);
+  int size = av_samples_get_buffer_size(&linesize, config.channels,
+                                        samples, config.fmt, 16);
+  uint8_t *mem = NULL;
+  if (size > 0)
+  {
+    CSingleLock lock(m_sampleArenaLock);
+    std::multimap<int, uint8_t*>::iterator it = m_sampleArena.find(size);
+    if (it != m_sampleArena.end())
+    {
+      mem = it->second;
+      m_sampleArena.erase(it);
+      m_sampleArenaSize -= size;
+      m_sampleArenaTime = XbmcThreads::SystemClockMillis();
+    }
+  }
+  if (!mem && size > 0)
+    mem = (uint8_t*)av_malloc(size);
+
+  if (mem)
+  {
+    av_samples_fill_arrays(buffer, &linesize, mem, config.channels,
+                           samples, config.fmt, 16);
+    av_samples_set_silence(buffer, 0, samples, config.channels, config.fmt);
+  }
+  else
+  {
+    CLog::Log(LOGERROR, "CActiveAE::AllocSoundSample - failed to allocate %d bytes", size);
+    for (int i = 0; i < planes; i++)
+      buffer[i] = NULL;
+  }
   bytes_per_sample = av_get_bytes_per_sample(config.fmt);
   return buffer;
 }
 
-void CActiveAE::FreeSoundSample(uint8_t **data)
+void CActiveAE::FreeSoundSample(uint8_t **data, int size)
 {
+  if (data[0])
+  {
+    CSingleLock lock(m_sampleArenaLock);
+    if (m_sampleArenaSize + size <= MAX_SAMPLE_ARENA_SIZE)
+    {
+      m_sampleArena.insert(std::make_pair(size, data[0]));
+      m_sampleArenaSize += size;
+      m_sampleArenaTime = XbmcThreads::SystemClockMillis();
+      data[0] = NULL;
+    }
+  }
   av_freep(data);
   delete [] data;
 }
 
+void CActiveAE::ClearSampleArena()
+{
+  CSingleLock lock(m_sampleArenaLock);
+  for (auto &block : m_sampleArena)
+    av_free(block.second);
+  m_sampleArena.clear();
+  m_sampleArenaSize = 0;
+}
+
+void CActiveAE::TrimSampleArena()
+{
+  // give the blocks back after playback of sounds or streams with that sample size ended
+  CSingleLock lock(m_sampleArenaLock);
+  if (m_sampleArena.empty() ||
+      XbmcThreads::SystemClockMillis() - m_sampleArenaTime < SAMPLE_ARENA_TIMEOUT)
+    return;
+
+  CLog::Log(LOGDEBUG, "CActiveAE::TrimSampleArena - released %d bytes", m_sampleArenaSize);
+  ClearSampleArena();
+}
+
 bool CActiveAE::CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs)
 {
   if (lhs.m_channelLayout != rhs.m_channelLayout ||
@@ -3145,7 +3292,7 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
   }
 
   IAEResample *resampler = CAEResampleFactory::Create(AERESAMPLEFACTORY_QUICK_RESAMPLE);
-  resampler->Init(dst_config.channel_layout,
+  if (!resampler->Init(dst_config.channel_layout,
                   dst_config.channels,
                   dst_config.sample_rate,
                   dst_config.fmt,
@@ -3161,7 +3308,12 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
                   true,
                   outChannels.Count() > 0 ? &outChannels : NULL,
                   m_settings.resampleQuality,
-                  false);
+                  false))
+  {
+    CLog::Log(LOGERROR, "CActiveAE::ResampleSound - failed to init resampler");
+    delete resampler;
+    return false;
+  }
 
   dst_samples = resampler->CalcDstSampleCount(sound->GetSound(true)->nb_samples,
                                               m_internalFormat.m_sampleRate,
@@ -20,6 +20,7 @@
  */
 
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -123,14 +124,12 @@ public:
     FREESOUND,
     NEWSTREAM,
     FREESTREAM,
-    STREAMSAMPLE,
     DRAINSTREAM,
   };
   enum InSignal
   {
     ACC,
     ERR,
-    STREAMBUFFER,
     STREAMDRAINED,
   };
 };
@@ -142,12 +141,6 @@ struct MsgStreamNew
   IAEClockCallback *clock;
 };
 
-struct MsgStreamSample
-{
-  CSampleBuffer *buffer;
-  CActiveAEStream *stream;
-};
-
 struct MsgStreamParameter
 {
   CActiveAEStream *stream;
@@ -196,6 +189,8 @@ public:
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream);
   float GetCacheTime(CActiveAEStream *stream);
   float GetCacheTotal(CActiveAEStream *stream);
+  float GetMaxLatency(CActiveAEStream *stream);
+  float GetMaxWaterLevel(std::list<CActiveAEStream*> &streams, bool soundsPlaying);
   float GetWaterLevel();
   void SetSuspended(bool state);
   void SetDSP(bool state);
@@ -286,7 +281,9 @@ public:
 protected:
   void PlaySound(CActiveAESound *sound);
   uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
-  void FreeSoundSample(uint8_t **data);
+  void FreeSoundSample(uint8_t **data, int size);
+  void ClearSampleArena();
+  void TrimSampleArena();
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream) { m_stats.GetDelay(status, stream); }
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream) { m_stats.GetSyncInfo(info, stream); }
   float GetCacheTime(CActiveAEStream *stream) { return m_stats.GetCacheTime(stream); }
@@ -325,9 +322,12 @@ protected:
   void DiscardSound(CActiveAESound *sound);
   void ChangeResamplers();
 
+  bool ReceiveStreamSamples();
+  bool ReceiveSinkSamples();
   bool RunStages();
   bool HasWork();
   CSampleBuffer* SyncStream(CActiveAEStream *stream);
+  int CalcStreamGains(CActiveAEStream *stream, CSampleBuffer *buffer, int nb_loops, int nb_floats, float fadingStep);
 
   void ResampleSounds();
   bool ResampleSound(CActiveAESound *sound);
@@ -393,12 +393,20 @@ protected:
   float m_volumeScaled; // multiplier to scale samples in order to achieve the volume specified in m_volume
   bool m_muted;
   bool m_sinkHasVolume;
+  std::vector<float> m_streamGains; // per sample volume of the stream being mixed
 
   // viz
   std::vector<IAudioCallback*> m_audioCallback;
   bool m_vizInitialized;
   CCriticalSection m_vizLock;
 
+  // sample memory of released packets, reused by buffer pools of the
+  // next configuration instead of going back to the heap
+  CCriticalSection m_sampleArenaLock;
+  std::multimap<int, uint8_t*> m_sampleArena;
+  int m_sampleArenaSize;
+  unsigned int m_sampleArenaTime;
+
   // polled via the interface
   float m_aeVolume;
   bool m_aeMuted;
@@ -48,7 +48,7 @@ CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 CSoundPacket::~CSoundPacket()
 {
   if (data)
-    AE.FreeSoundSample(data);
+    AE.FreeSoundSample(data, linesize * planes);
 }
 
 CSampleBuffer::CSampleBuffer() : pkt(NULL), pool(NULL)
@@ -200,6 +200,7 @@ CActiveAEBufferPoolResample::CActiveAEBufferPoolResample(AEAudioFormat inputForm
   m_useDSP = false;
   m_bypassDSP = false;
   m_changeResampler = false;
+  m_recreateResampler = false;
   m_changeDSP = false;
   m_lastSamplePts = 0;
 }
@@ -313,7 +314,7 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
       m_resamplerInFormat = m_inputFormat;
     }
 
-    m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
+    if (!m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
                                 m_format.m_channelLayout.Count(),
                                 m_format.m_sampleRate,
                                 CAEUtil::GetAVSampleFormat(m_format.m_dataFormat),
@@ -329,7 +330,14 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
                                 m_normalize,
                                 remap ? &m_format.m_channelLayout : NULL,
                                 m_resampleQuality,
-                                m_forceResampler);
+                                m_forceResampler))
+    {
+      CLog::Log(LOGERROR, "CActiveAEBufferPoolResample::Create - failed to init resampler");
+      delete m_resampler;
+      m_resampler = NULL;
+      m_changeResampler = false;
+      return false;
+    }
   }
 
   m_changeResampler = false;
@@ -339,7 +347,9 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
 
 void CActiveAEBufferPoolResample::ChangeResampler()
 {
-  if (m_resampler)
+  // flushes and format changes initialize the resampler again, a new one
+  // is only needed after an error or if the quality selects another type
+  if (m_resampler && m_recreateResampler)
   {
     delete m_resampler;
     m_resampler = NULL;
@@ -349,7 +359,8 @@ void CActiveAEBufferPoolResample::ChangeResampler()
   if (m_useDSP && m_processor && m_processor->GetChannelLayout().Count() > 2)
     upmix = false;
 
-  m_resampler = CAEResampleFactory::Create();
+  if (!m_resampler)
+    m_resampler = CAEResampleFactory::Create();
 
   AEAudioFormat m_resamplerInFormat;
   if (m_useDSP)
@@ -361,7 +372,7 @@ void CActiveAEBufferPoolResample::ChangeResampler()
     m_resamplerInFormat = m_inputFormat;
   }
 
-  m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
+  if (!m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
                                 m_format.m_channelLayout.Count(),
                                 m_format.m_sampleRate,
                                 CAEUtil::GetAVSampleFormat(m_format.m_dataFormat),
@@ -377,9 +388,15 @@ void CActiveAEBufferPoolResample::ChangeResampler()
                                 m_normalize,
                                 m_remap ? &m_format.m_channelLayout : NULL,
                                 m_resampleQuality,
-                                m_forceResampler);
+                                m_forceResampler))
+  {
+    CLog::Log(LOGERROR, "CActiveAEBufferPoolResample::ChangeResampler - failed to init resampler");
+    delete m_resampler;
+    m_resampler = NULL;
+  }
 
   m_changeResampler = false;
+  m_recreateResampler = false;
 }
 
 void CActiveAEBufferPoolResample::ChangeAudioDSP()
@@ -454,6 +471,12 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
     {
       in = m_inputSamples.front();
       m_inputSamples.pop_front();
+      // the resampler failed to init, don't pass on samples in the wrong format
+      if (m_useResampler)
+      {
+        in->Return();
+        continue;
+      }
       if (timestamp)
       {
         in->timestamp = timestamp;
@@ -546,6 +569,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
       {
         out_samples = 0;
         m_changeResampler = true;
+        m_recreateResampler = true;
       }
 
       m_procSample->pkt->nb_samples += out_samples;
@@ -642,6 +666,8 @@ void CActiveAEBufferPoolResample::ConfigureResampler(bool normalizelevels, bool
        (m_normalize != normalize)))
   {
     m_changeResampler = true;
+    if (m_resampleQuality != quality)
+      m_recreateResampler = true;
   }
 
   if (m_useDSP != dspenabled ||
@@ -133,6 +133,7 @@ protected:
   bool m_normalize;
   bool m_useResampler;
   bool m_changeResampler;
+  bool m_recreateResampler;
   bool m_forceResampler;
   AEQuality m_resampleQuality;
 
@@ -18,11 +18,16 @@
  *
  */
 
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
 #include "settings/Settings.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <list>
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 #include "libavutil/opt.h"
@@ -31,19 +36,117 @@ extern "C" {
 
 using namespace ActiveAE;
 
+#define MAX_CACHED_CONTEXTS 8
+
+bool ResampleContextKey::operator==(const ResampleContextKey &rhs) const
+{
+  return dst_chan_layout == rhs.dst_chan_layout &&
+         dst_channels == rhs.dst_channels &&
+         dst_rate == rhs.dst_rate &&
+         dst_fmt == rhs.dst_fmt &&
+         dst_bits == rhs.dst_bits &&
+         dst_dither == rhs.dst_dither &&
+         src_chan_layout == rhs.src_chan_layout &&
+         src_channels == rhs.src_channels &&
+         src_rate == rhs.src_rate &&
+         src_fmt == rhs.src_fmt &&
+         upmix == rhs.upmix &&
+         normalize == rhs.normalize &&
+         remap == rhs.remap &&
+         (!remap || remapLayout == rhs.remapLayout) &&
+         quality == rhs.quality &&
+         boostCenter == rhs.boostCenter &&
+         forceResample == rhs.forceResample;
+}
+
+namespace
+{
+
+/**
+ * Initialized contexts of resamplers which have been destroyed. Building the
+ * filter bank is the expensive part of swr_init and swresample keeps it if
+ * an existing context is initialized again with the same parameters. Flushes,
+ * reconfigurations and stream switches mostly ask for a context which has
+ * just been released.
+ */
+class CResampleContextCache
+{
+public:
+  ~CResampleContextCache()
+  {
+    for (auto &entry : m_contexts)
+      swr_free(&entry.second);
+  }
+
+  SwrContext *Take(const ResampleContextKey &key)
+  {
+    CSingleLock lock(m_lock);
+    for (auto it = m_contexts.begin(); it != m_contexts.end(); ++it)
+    {
+      if (it->first == key)
+      {
+        SwrContext *context = it->second;
+        m_contexts.erase(it);
+        return context;
+      }
+    }
+    return NULL;
+  }
+
+  void Give(const ResampleContextKey &key, SwrContext *context)
+  {
+    CSingleLock lock(m_lock);
+    m_contexts.push_front(std::make_pair(key, context));
+    if (m_contexts.size() > MAX_CACHED_CONTEXTS)
+    {
+      swr_free(&m_contexts.back().second);
+      m_contexts.pop_back();
+    }
+  }
+
+private:
+  CCriticalSection m_lock;
+  std::list<std::pair<ResampleContextKey, SwrContext*> > m_contexts;
+};
+
+CResampleContextCache& GetContextCache()
+{
+  static CResampleContextCache cache;
+  return cache;
+}
+
+}
+
 CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_doesResample = false;
+  m_directConvert = false;
+  m_cacheContext = false;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
 {
-  swr_free(&m_pContext);
+  ReleaseContext();
+}
+
+void CActiveAEResampleFFMPEG::ReleaseContext()
+{
+  if (m_pContext && m_cacheContext)
+    GetContextCache().Give(m_contextKey, m_pContext);
+  else
+    swr_free(&m_pContext);
+  m_pContext = NULL;
+  m_cacheContext = false;
 }
 
 bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
 {
+  // the buffer pools initialize their resampler again on flushes and format changes
+  ReleaseContext();
+  m_doesResample = false;
+  m_directConvert = false;
+
   m_dst_chan_layout = dst_chan_layout;
   m_dst_channels = dst_channels;
   m_dst_rate = dst_rate;
@@ -65,9 +168,36 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
   if (m_src_chan_layout == 0)
     m_src_chan_layout = av_get_default_channel_layout(m_src_channels);
 
-  m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
-                                                        m_src_chan_layout, m_src_fmt, m_src_rate,
-                                                        0, NULL);
+  int boost_center = CSettings::GetInstance().GetInt("audiooutput.boostcenter");
+
+  m_contextKey.dst_chan_layout = m_dst_chan_layout;
+  m_contextKey.dst_channels = m_dst_channels;
+  m_contextKey.dst_rate = m_dst_rate;
+  m_contextKey.dst_fmt = m_dst_fmt;
+  m_contextKey.dst_bits = m_dst_bits;
+  m_contextKey.dst_dither = m_dst_dither_bits;
+  m_contextKey.src_chan_layout = m_src_chan_layout;
+  m_contextKey.src_channels = m_src_channels;
+  m_contextKey.src_rate = m_src_rate;
+  m_contextKey.src_fmt = m_src_fmt;
+  m_contextKey.upmix = upmix;
+  m_contextKey.normalize = normalize;
+  m_contextKey.remap = remapLayout != NULL;
+  if (remapLayout)
+    m_contextKey.remapLayout = *remapLayout;
+  m_contextKey.quality = quality;
+  m_contextKey.boostCenter = boost_center;
+  m_contextKey.forceResample = force_resample;
+
+  // a cached context is still initialized and swr_set_matrix refuses those,
+  // swr_close resets it but keeps the filter bank for the next swr_init
+  m_pContext = GetContextCache().Take(m_contextKey);
+  if (m_pContext)
+    swr_close(m_pContext);
+  else
+    m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
+                                                          m_src_chan_layout, m_src_fmt, m_src_rate,
+                                                          0, NULL);
 
   if(!m_pContext)
   {
@@ -75,6 +205,11 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     return false;
   }
 
+  // streams which are resampled for sync get ratio adjustments, set up the
+  // resampler now instead of letting swr_set_compensation initialize it
+  // while playing
+  av_opt_set_int(m_pContext, "flags", force_resample ? SWR_FLAG_RESAMPLE : 0, 0);
+
   if(quality == AE_QUALITY_HIGH)
   {
     av_opt_set_double(m_pContext, "cutoff", 1.0, 0);
@@ -105,7 +240,6 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
   {
      av_opt_set_double(m_pContext, "rematrix_maxval", 1.0, 0);
   }
-  int boost_center = CSettings::GetInstance().GetInt("audiooutput.boostcenter");
   if (boost_center)
   {
     float gain = pow(10.0f, ((float)(-3 + boost_center))/20.0f);
@@ -182,9 +316,110 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Init - init resampler failed");
     return false;
   }
+  m_cacheContext = true;
+
+  m_directConvert = !force_resample && CanConvertDirectly(upmix, remapLayout);
+
+  return true;
+}
+
+bool CActiveAEResampleFFMPEG::CanConvertDirectly(bool upmix, CAEChannelInfo *remapLayout)
+{
+  if (m_doesResample)
+    return false;
+
+  if (m_src_fmt != AV_SAMPLE_FMT_FLTP && m_src_fmt != AV_SAMPLE_FMT_FLT)
+    return false;
+
+  if (m_dst_fmt == AV_SAMPLE_FMT_S32)
+  {
+    // S24NE3 is packed by swresample output post-processing only
+    if (m_dst_bits != 32 && m_dst_dither_bits != 0 && m_dst_bits + m_dst_dither_bits != 32)
+      return false;
+  }
+  else if (m_dst_fmt != AV_SAMPLE_FMT_S16 && m_dst_fmt != AV_SAMPLE_FMT_FLT)
+    return false;
+
+  if (m_dst_channels > AE_CH_MAX)
+    return false;
+
+  // only one-to-one channel mappings, anything else needs the rematrix of swresample
+  if (remapLayout)
+  {
+    if (m_src_fmt != AV_SAMPLE_FMT_FLTP)
+      return false;
+
+    for (int out = 0; out < m_dst_channels; out++)
+      m_directMap[out] = out < (int)remapLayout->Count() ? CAEUtil::GetAVChannelIndex((*remapLayout)[out], m_src_chan_layout) : -1;
+  }
+  else
+  {
+    if (m_src_chan_layout != m_dst_chan_layout || m_src_channels != m_dst_channels ||
+        (upmix && m_src_channels == 2 && m_dst_channels > 2))
+      return false;
+
+    for (int out = 0; out < m_dst_channels; out++)
+      m_directMap[out] = out;
+  }
+
   return true;
 }
 
+int CActiveAEResampleFFMPEG::ConvertDirectly(uint8_t **dst_buffer, uint8_t **src_buffer, int samples)
+{
+  const AEKernels &kernels = CAEKernels::Get();
+  uint32_t count = samples * m_dst_channels;
+
+  if (samples == 0)
+    return 0;
+
+  // interleave planar input, converting to float output needs no second pass
+  const float *interleaved;
+  if (m_src_fmt == AV_SAMPLE_FMT_FLTP)
+  {
+    const float *planes[AE_CH_MAX];
+    for (int ch = 0; ch < m_dst_channels; ch++)
+    {
+      if (m_directMap[ch] >= 0)
+        planes[ch] = (const float*)src_buffer[m_directMap[ch]];
+      else
+      {
+        if ((int)m_directSilence.size() < samples)
+          m_directSilence.resize(samples, 0.0f);
+        planes[ch] = m_directSilence.data();
+      }
+    }
+
+    float *out;
+    if (m_dst_fmt == AV_SAMPLE_FMT_FLT)
+      out = (float*)dst_buffer[0];
+    else
+    {
+      if (m_directBuffer.size() < count)
+        m_directBuffer.resize(count);
+      out = m_directBuffer.data();
+    }
+    kernels.Interleave(planes, m_dst_channels, out, samples);
+    interleaved = out;
+  }
+  else
+    interleaved = (const float*)src_buffer[0];
+
+  if (m_dst_fmt == AV_SAMPLE_FMT_FLT)
+  {
+    if (interleaved != (const float*)dst_buffer[0])
+      memcpy(dst_buffer[0], interleaved, count * sizeof(float));
+  }
+  else if (m_dst_fmt == AV_SAMPLE_FMT_S16)
+    kernels.FloatToS16(interleaved, (int16_t*)dst_buffer[0], count);
+  else if (m_dst_bits == 32 || m_dst_bits + m_dst_dither_bits == 32)
+    kernels.FloatToS32(interleaved, (int32_t*)dst_buffer[0], count);
+  else
+    kernels.FloatToS24(interleaved, (int32_t*)dst_buffer[0], count);
+
+  return samples;
+}
+
 int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
 {
   int delta = 0;
@@ -196,6 +431,15 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     m_doesResample = true;
   }
 
+  if (m_directConvert)
+  {
+    if (!m_doesResample && src_samples <= dst_samples)
+      return ConvertDirectly(dst_buffer, src_buffer, src_samples);
+
+    // swresample keeps what does not fit, stay with it from now on
+    m_directConvert = false;
+  }
+
   if (m_doesResample)
   {
     if (swr_set_compensation(m_pContext, delta, distance) < 0)
@@ -19,6 +19,8 @@
  *
  */
 
+#include <vector>
+
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
@@ -33,6 +35,33 @@ struct SwrContext;
 namespace ActiveAE
 {
 
+/**
+ * Everything a swresample context is configured from. Contexts with equal
+ * keys are interchangeable, so they can be cached instead of being freed.
+ */
+struct ResampleContextKey
+{
+  uint64_t dst_chan_layout;
+  int dst_channels;
+  int dst_rate;
+  AVSampleFormat dst_fmt;
+  int dst_bits;
+  int dst_dither;
+  uint64_t src_chan_layout;
+  int src_channels;
+  int src_rate;
+  AVSampleFormat src_fmt;
+  bool upmix;
+  bool normalize;
+  bool remap;
+  CAEChannelInfo remapLayout;
+  AEQuality quality;
+  int boostCenter;
+  bool forceResample;
+
+  bool operator==(const ResampleContextKey &rhs) const;
+};
+
 class CActiveAEResampleFFMPEG : public IAEResample
 {
 public:
@@ -49,6 +78,10 @@ public:
   int GetDstBufferSize(int samples);
 
 protected:
+  bool CanConvertDirectly(bool upmix, CAEChannelInfo *remapLayout);
+  void ReleaseContext();
+  int ConvertDirectly(uint8_t **dst_buffer, uint8_t **src_buffer, int samples);
+
   bool m_loaded;
   bool m_doesResample;
   uint64_t m_src_chan_layout, m_dst_chan_layout;
@@ -59,6 +92,14 @@ protected:
   int m_src_dither_bits, m_dst_dither_bits;
   SwrContext *m_pContext;
   double m_rematrix[AE_CH_MAX][AE_CH_MAX];
+  ResampleContextKey m_contextKey;
+  bool m_cacheContext;
+
+  // plain sample format conversions bypass swresample
+  bool m_directConvert;
+  int m_directMap[AE_CH_MAX];
+  std::vector<float> m_directBuffer;
+  std::vector<float> m_directSilence;
 };
 
 }
@@ -43,7 +43,8 @@ using namespace ActiveAE;
 CActiveAESink::CActiveAESink(CEvent *inMsgEvent) :
   CThread("AESink"),
   m_controlPort("SinkControlPort", inMsgEvent, &m_outMsgEvent),
-  m_dataPort("SinkDataPort", inMsgEvent, &m_outMsgEvent)
+  m_dataPort("SinkDataPort", inMsgEvent, &m_outMsgEvent),
+  m_returnQueue(MAX_SINK_RETURN_BUFFERS)
 {
   m_inMsgEvent = inMsgEvent;
   m_sink = nullptr;
@@ -367,7 +368,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           samples = *((CSampleBuffer**)msg->data);
           timeout = 1000*samples->pkt->nb_samples/samples->pkt->config.sample_rate;
           Sleep(timeout);
-          msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+          ReturnSample(samples);
           m_extTimeout = 0;
           return;
         default:
@@ -413,7 +414,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           unsigned int delay;
           samples = *((CSampleBuffer**)msg->data);
           delay = OutputSamples(samples);
-          msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+          ReturnSample(samples);
           if (m_extError)
           {
             m_sink->Deinitialize();
@@ -890,11 +891,20 @@ void CActiveAESink::ReturnBuffers()
     if (msg->signal == CSinkDataProtocol::SAMPLE)
     {
       samples = *((CSampleBuffer**)msg->data);
-      msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+      ReturnSample(samples);
     }
   }
 }
 
+void CActiveAESink::ReturnSample(CSampleBuffer *samples)
+{
+  // order of returned buffers does not matter, use the port if the engine lags behind
+  if (m_returnQueue.Push(samples))
+    m_inMsgEvent->Set();
+  else
+    m_dataPort.SendInMessage(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+}
+
 unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
 {
   uint8_t **buffer = samples->pkt->data;
@@ -26,6 +26,10 @@
 #include "cores/AudioEngine/Interfaces/AESink.h"
 #include "cores/AudioEngine/AESinkFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Utils/AESPSCQueue.h"
+
+// buffers returned by the sink without a message before falling back to the data port
+#define MAX_SINK_RETURN_BUFFERS 64
 
 class CAEBitstreamPacker;
 
@@ -102,6 +106,7 @@ public:
   bool SupportsFormat(const std::string &device, AEAudioFormat &format);
   CSinkControlProtocol m_controlPort;
   CSinkDataProtocol m_dataPort;
+  CAESPSCQueue<CSampleBuffer*> m_returnQueue;
 
 protected:
   void Process();
@@ -110,6 +115,7 @@ protected:
   void GetDeviceFriendlyName(std::string &device);
   void OpenSink();
   void ReturnBuffers();
+  void ReturnSample(CSampleBuffer *samples);
   void SetSilenceTimer();
   bool NeedIECPacking();
 
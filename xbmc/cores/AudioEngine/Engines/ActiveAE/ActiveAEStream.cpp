@@ -36,11 +36,15 @@ using namespace ActiveAE;
 
 
 CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid)
+  : m_freeQueue(MAX_STREAM_BUFFERS),
+    m_sampleQueue(MAX_STREAM_BUFFERS)
 {
   m_format = *format;
   m_id = streamid;
   m_bufferedTime = 0;
   m_currentBuffer = NULL;
+  m_engineEvent = NULL;
+  m_lowLatency = false;
   m_drain = false;
   m_paused = false;
   m_rgain = 1.0;
@@ -82,22 +86,27 @@ CActiveAEStream::~CActiveAEStream()
 
 void CActiveAEStream::IncFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers++;
 }
 
 void CActiveAEStream::DecFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers--;
 }
 
 void CActiveAEStream::ResetFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers = 0;
 }
 
+void CActiveAEStream::SubmitBuffer(CSampleBuffer *buffer)
+{
+  // the engine never hands out more buffers than the queue can hold
+  if (!m_sampleQueue.Push(buffer))
+    CLog::Log(LOGERROR, "CActiveAEStream::SubmitBuffer - sample queue overrun");
+  m_engineEvent->Set();
+}
+
 void CActiveAEStream::InitRemapper()
 {
   // check if input format follows ffmpeg channel mask
@@ -229,7 +238,6 @@ double CActiveAEStream::CalcResampleRatio(double error)
 
 unsigned int CActiveAEStream::GetSpace()
 {
-  CSingleLock lock(m_streamLock);
   if (m_format.m_dataFormat == AE_FMT_RAW)
     return m_streamFreeBuffers;
   else
@@ -238,7 +246,7 @@ unsigned int CActiveAEStream::GetSpace()
 
 unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int offset, unsigned int frames, double pts)
 {
-  Message *msg;
+  CSampleBuffer *buffer;
   unsigned int copied = 0;
   int sourceFrames = frames;
   const uint8_t* const *buf = data;
@@ -307,33 +315,20 @@ unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int o
 
       if (m_currentBuffer->pkt->nb_samples == m_currentBuffer->pkt->max_nb_samples || rawPktComplete)
       {
-        MsgStreamSample msgData;
-        msgData.buffer = m_currentBuffer;
-        msgData.stream = this;
         RemapBuffer();
-        m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
+        SubmitBuffer(m_currentBuffer);
         m_currentBuffer = NULL;
       }
       continue;
     }
-    else if (m_streamPort->ReceiveInMessage(&msg))
+    else if (m_freeQueue.Pop(buffer))
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        m_currentBuffer = *((CSampleBuffer**)msg->data);
-        m_currentBuffer->timestamp = 0;
-        m_currentBuffer->pkt->nb_samples = 0;
-        m_currentBuffer->pkt->pause_burst_ms = 0;
-        msg->Release();
-        DecFreeBuffers();
-        continue;
-      }
-      else
-      {
-        CLog::Log(LOGERROR, "CActiveAEStream::AddData - unknown signal");
-        msg->Release();
-        break;
-      }
+      m_currentBuffer = buffer;
+      m_currentBuffer->timestamp = 0;
+      m_currentBuffer->pkt->nb_samples = 0;
+      m_currentBuffer->pkt->pause_burst_ms = 0;
+      DecFreeBuffers();
+      continue;
     }
     if (!m_inMsgEvent.WaitMSec(200))
       break;
@@ -404,29 +399,26 @@ void CActiveAEStream::Drain(bool wait)
 
   if (m_currentBuffer)
   {
-    MsgStreamSample msgData;
-    msgData.buffer = m_currentBuffer;
-    msgData.stream = this;
     RemapBuffer();
-    m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
+    SubmitBuffer(m_currentBuffer);
     m_currentBuffer = NULL;
   }
 
   XbmcThreads::EndTime timer(2000);
   while (!timer.IsTimePast())
   {
+    // give back buffers handed out before the engine started draining
+    CSampleBuffer *buffer;
+    if (m_freeQueue.Pop(buffer))
+    {
+      buffer->pkt->nb_samples = 0;
+      SubmitBuffer(buffer);
+      DecFreeBuffers();
+      continue;
+    }
     if (m_streamPort->ReceiveInMessage(&msg))
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        MsgStreamSample msgData;
-        msgData.stream = this;
-        msgData.buffer = *((CSampleBuffer**)msg->data);
-        msg->Reply(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
-        DecFreeBuffers();
-        continue;
-      }
-      else if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
+      if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
       {
         msg->Release();
         return;
@@ -22,8 +22,12 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Utils/AELimiter.h"
+#include "cores/AudioEngine/Utils/AESPSCQueue.h"
 #include <atomic>
 
+// upper bound of buffers handed out to a stream at any time
+#define MAX_STREAM_BUFFERS 256
+
 namespace ActiveAE
 {
 
@@ -133,6 +137,7 @@ protected:
   void IncFreeBuffers();
   void DecFreeBuffers();
   void ResetFreeBuffers();
+  void SubmitBuffer(CSampleBuffer *buffer);
   void InitRemapper();
   void RemapBuffer();
   double CalcResampleRatio(double error);
@@ -191,7 +196,7 @@ protected:
   bool m_streamDraining;
   bool m_streamDrained;
   bool m_streamFading;
-  int m_streamFreeBuffers;
+  std::atomic_int m_streamFreeBuffers;
   bool m_streamIsBuffering;
   bool m_streamIsFlushed;
   bool m_bypassDSP;
@@ -213,6 +218,12 @@ protected:
   std::deque<CSampleBuffer*> m_processingSamples;
   CActiveAEDataProtocol *m_streamPort;
   CEvent m_inMsgEvent;
+  CEvent *m_engineEvent;
+  // sample buffers are handed over without going through m_streamPort:
+  // empty buffers from engine to stream, filled buffers from stream to engine
+  CAESPSCQueue<CSampleBuffer*> m_freeQueue;
+  CAESPSCQueue<CSampleBuffer*> m_sampleQueue;
+  bool m_lowLatency;
   bool m_drain;
   bool m_paused;
   bool m_started;
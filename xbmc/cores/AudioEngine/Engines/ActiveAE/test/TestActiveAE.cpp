@@ -0,0 +1,117 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEStream.h"
+
+#include "gtest/gtest.h"
+
+#include <list>
+
+using namespace ActiveAE;
+
+namespace
+{
+class CTestStream : public CActiveAEStream
+{
+public:
+  CTestStream(AEAudioFormat *format, bool lowLatency) : CActiveAEStream(format, 0)
+  {
+    m_lowLatency = lowLatency;
+    m_started = true;
+  }
+  virtual ~CTestStream() {}
+
+  void SetPaused(bool paused) { m_paused = paused; }
+  void SetStarted(bool started) { m_started = started; }
+};
+
+class TestActiveAE : public testing::Test
+{
+protected:
+  TestActiveAE()
+  {
+    m_format.m_dataFormat = AE_FMT_FLOAT;
+    m_format.m_sampleRate = 48000;
+    m_format.m_channelLayout = AE_CH_LAYOUT_2_0;
+    m_format.m_frameSize = 8;
+    m_format.m_frames = 240;
+
+    m_stats.Reset(48000, true);
+    // a sink with 5 ms of buffers
+    m_stats.SetSinkCacheTotal(0.005f);
+    m_stats.SetSinkLatency(0.0f);
+  }
+
+  AEAudioFormat m_format;
+  CEngineStats m_stats;
+};
+}
+
+TEST_F(TestActiveAE, LowLatencyTarget)
+{
+  CTestStream lowLatency(&m_format, true);
+  CTestStream normal(&m_format, false);
+
+  // stream cache, engine output and sink buffers stay below 20 ms
+  EXPECT_LT(m_stats.GetMaxLatency(&lowLatency), 0.02f);
+  EXPECT_GT(m_stats.GetMaxLatency(&normal), 0.02f);
+  EXPECT_LT(m_stats.GetCacheTotal(&lowLatency), m_stats.GetCacheTotal(&normal));
+}
+
+TEST_F(TestActiveAE, LowLatencyWaterLevel)
+{
+  CTestStream lowLatency(&m_format, true);
+  CTestStream normal(&m_format, false);
+  std::list<CActiveAEStream*> streams;
+
+  streams.push_back(&lowLatency);
+  float low = m_stats.GetMaxWaterLevel(streams, false);
+
+  // a regular stream mixed into the same output keeps its water level
+  streams.push_back(&normal);
+  float high = m_stats.GetMaxWaterLevel(streams, false);
+  EXPECT_LT(low, high);
+  EXPECT_EQ(high, m_stats.GetMaxWaterLevel(streams, true));
+
+  // unless it doesn't play
+  normal.SetPaused(true);
+  EXPECT_EQ(low, m_stats.GetMaxWaterLevel(streams, false));
+  normal.SetPaused(false);
+  normal.SetStarted(false);
+  EXPECT_EQ(low, m_stats.GetMaxWaterLevel(streams, false));
+
+  // a paused low latency stream doesn't affect anything else
+  normal.SetStarted(true);
+  lowLatency.SetPaused(true);
+  EXPECT_EQ(high, m_stats.GetMaxWaterLevel(streams, false));
+}
+
+TEST_F(TestActiveAE, GuiSoundsWaterLevel)
+{
+  CTestStream lowLatency(&m_format, true);
+  std::list<CActiveAEStream*> streams;
+
+  // gui sounds on their own are mixed with the low water level
+  EXPECT_GT(m_stats.GetMaxWaterLevel(streams, false), m_stats.GetMaxWaterLevel(streams, true));
+
+  streams.push_back(&lowLatency);
+  EXPECT_EQ(m_stats.GetMaxWaterLevel(streams, true), m_stats.GetMaxWaterLevel(streams, false));
+}
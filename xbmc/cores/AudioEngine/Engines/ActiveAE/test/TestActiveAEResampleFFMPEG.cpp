@@ -0,0 +1,222 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+#define TEST_FRAMES 1024
+
+namespace
+{
+// the sink layout of the remap stage, the backs come before the center
+const enum AEChannel remapChannels[] = { AE_CH_FL, AE_CH_FR, AE_CH_BL, AE_CH_BR, AE_CH_FC, AE_CH_LFE, AE_CH_NULL };
+const enum AEChannel swapChannels[] = { AE_CH_FR, AE_CH_FL, AE_CH_FC, AE_CH_LFE, AE_CH_BR, AE_CH_BL, AE_CH_NULL };
+
+class CTestResampler : public CActiveAEResampleFFMPEG
+{
+public:
+  bool UsesSwresample() const { return !m_directConvert; }
+  SwrContext *GetContext() const { return m_pContext; }
+};
+}
+
+/* The buffer pools initialize their resampler again on flushes and format changes,
+ * released contexts are cached and handed out again for the same parameters. */
+class TestActiveAEResampleFFMPEG : public testing::Test
+{
+protected:
+  TestActiveAEResampleFFMPEG()
+  {
+    m_srcLayout = AE_CH_LAYOUT_5_1;
+    m_channels = m_srcLayout.Count();
+    // every source channel gets a value of its own to tell where it ended up
+    for (unsigned int ch = 0; ch < m_channels; ch++)
+    {
+      for (int i = 0; i < TEST_FRAMES; i++)
+      {
+        m_planar[ch][i] = (ch + 1) * 0.1f;
+        m_packed[i * m_channels + ch] = (ch + 1) * 0.1f;
+      }
+      m_planes[ch] = (uint8_t*)m_planar[ch];
+    }
+  }
+
+  bool Init(CActiveAEResampleFFMPEG &resampler, CAEChannelInfo &remapLayout,
+            AVSampleFormat srcFormat = AV_SAMPLE_FMT_FLTP, int srcRate = 48000)
+  {
+    return resampler.Init(CAEUtil::GetAVChannelLayout(remapLayout), remapLayout.Count(), 48000, AV_SAMPLE_FMT_FLT, 32, 0,
+                          CAEUtil::GetAVChannelLayout(m_srcLayout), m_channels, srcRate, srcFormat, 32, 0,
+                          false, false, &remapLayout, AE_QUALITY_MID, false);
+  }
+
+  // feeds one block in the given format, returns the number of output frames
+  int Resample(CActiveAEResampleFFMPEG &resampler, AVSampleFormat srcFormat)
+  {
+    uint8_t *dstPlanes[] = { (uint8_t*)m_dst };
+    uint8_t *packed[] = { (uint8_t*)m_packed };
+    return resampler.Resample(dstPlanes, 2 * TEST_FRAMES, srcFormat == AV_SAMPLE_FMT_FLTP ? m_planes : packed, TEST_FRAMES, 1.0);
+  }
+
+  // checks that every sink channel of the given frame carries the source channel with the same name
+  void ExpectRemapped(CAEChannelInfo &remapLayout, int frame, float tolerance = 0.0f)
+  {
+    uint64_t srcLayout = CAEUtil::GetAVChannelLayout(m_srcLayout);
+    for (unsigned int out = 0; out < remapLayout.Count(); out++)
+    {
+      int idx = CAEUtil::GetAVChannelIndex(remapLayout[out], srcLayout);
+      ASSERT_GE(idx, 0);
+      if (tolerance > 0.0f)
+        EXPECT_NEAR((idx + 1) * 0.1f, m_dst[frame * remapLayout.Count() + out], tolerance);
+      else
+        EXPECT_FLOAT_EQ((idx + 1) * 0.1f, m_dst[frame * remapLayout.Count() + out]);
+    }
+  }
+
+  void ExpectRemapped(CActiveAEResampleFFMPEG &resampler, CAEChannelInfo &remapLayout,
+                      AVSampleFormat srcFormat = AV_SAMPLE_FMT_FLTP)
+  {
+    ASSERT_EQ(TEST_FRAMES, Resample(resampler, srcFormat));
+    ExpectRemapped(remapLayout, 0);
+    ExpectRemapped(remapLayout, TEST_FRAMES - 1);
+  }
+
+  CAEChannelInfo m_srcLayout;
+  unsigned int m_channels;
+  float m_planar[AE_CH_MAX][TEST_FRAMES];
+  float m_packed[AE_CH_MAX * TEST_FRAMES];
+  uint8_t *m_planes[AE_CH_MAX];
+  float m_dst[AE_CH_MAX * 2 * TEST_FRAMES];
+};
+
+TEST_F(TestActiveAEResampleFFMPEG, InitTwiceRemapped)
+{
+  CAEChannelInfo remapLayout(remapChannels);
+  CTestResampler resampler;
+
+  ASSERT_TRUE(Init(resampler, remapLayout));
+  ExpectRemapped(resampler, remapLayout);
+
+  // takes back the context the first init just released to the cache
+  ASSERT_TRUE(Init(resampler, remapLayout));
+  ExpectRemapped(resampler, remapLayout);
+}
+
+TEST_F(TestActiveAEResampleFFMPEG, InitOtherRemap)
+{
+  CAEChannelInfo remapLayout(remapChannels);
+  CAEChannelInfo swapLayout(swapChannels);
+  CTestResampler resampler;
+
+  ASSERT_TRUE(Init(resampler, remapLayout));
+  ASSERT_TRUE(Init(resampler, swapLayout));
+  ExpectRemapped(resampler, swapLayout);
+
+  ASSERT_TRUE(Init(resampler, remapLayout));
+  ExpectRemapped(resampler, remapLayout);
+}
+
+TEST_F(TestActiveAEResampleFFMPEG, CachedContext)
+{
+  CAEChannelInfo remapLayout(remapChannels);
+  {
+    CTestResampler resampler;
+    ASSERT_TRUE(Init(resampler, remapLayout));
+  }
+
+  CTestResampler resampler;
+  ASSERT_TRUE(Init(resampler, remapLayout));
+  ExpectRemapped(resampler, remapLayout);
+}
+
+/* packed input is remapped by the channel matrix of swresample */
+TEST_F(TestActiveAEResampleFFMPEG, SwrInitTwiceRemapped)
+{
+  CAEChannelInfo remapLayout(remapChannels);
+  CAEChannelInfo swapLayout(swapChannels);
+  CTestResampler resampler;
+
+  ASSERT_TRUE(Init(resampler, remapLayout, AV_SAMPLE_FMT_FLT));
+  ASSERT_TRUE(resampler.UsesSwresample());
+  SwrContext *remapContext = resampler.GetContext();
+  ExpectRemapped(resampler, remapLayout, AV_SAMPLE_FMT_FLT);
+
+  // the same context comes back from the cache, reset and with its matrix set again
+  ASSERT_TRUE(Init(resampler, remapLayout, AV_SAMPLE_FMT_FLT));
+  EXPECT_EQ(remapContext, resampler.GetContext());
+  ExpectRemapped(resampler, remapLayout, AV_SAMPLE_FMT_FLT);
+
+  ASSERT_TRUE(Init(resampler, swapLayout, AV_SAMPLE_FMT_FLT));
+  ASSERT_TRUE(resampler.UsesSwresample());
+  SwrContext *swapContext = resampler.GetContext();
+  EXPECT_NE(remapContext, swapContext);
+  ExpectRemapped(resampler, swapLayout, AV_SAMPLE_FMT_FLT);
+
+  ASSERT_TRUE(Init(resampler, remapLayout, AV_SAMPLE_FMT_FLT));
+  EXPECT_EQ(remapContext, resampler.GetContext());
+  ExpectRemapped(resampler, remapLayout, AV_SAMPLE_FMT_FLT);
+
+  ASSERT_TRUE(Init(resampler, swapLayout, AV_SAMPLE_FMT_FLT));
+  EXPECT_EQ(swapContext, resampler.GetContext());
+  ExpectRemapped(resampler, swapLayout, AV_SAMPLE_FMT_FLT);
+}
+
+TEST_F(TestActiveAEResampleFFMPEG, SwrCachedContext)
+{
+  CAEChannelInfo remapLayout(remapChannels);
+  SwrContext *context;
+  {
+    CTestResampler resampler;
+    ASSERT_TRUE(Init(resampler, remapLayout, AV_SAMPLE_FMT_FLT));
+    context = resampler.GetContext();
+    ExpectRemapped(resampler, remapLayout, AV_SAMPLE_FMT_FLT);
+  }
+
+  CTestResampler resampler;
+  ASSERT_TRUE(Init(resampler, remapLayout, AV_SAMPLE_FMT_FLT));
+  EXPECT_EQ(context, resampler.GetContext());
+  ExpectRemapped(resampler, remapLayout, AV_SAMPLE_FMT_FLT);
+}
+
+/* the sample rate changes, the filter bank of a cached context is kept */
+TEST_F(TestActiveAEResampleFFMPEG, SwrResampleRemapped)
+{
+  CAEChannelInfo remapLayout(remapChannels);
+  CAEChannelInfo swapLayout(swapChannels);
+  CTestResampler resampler;
+
+  ASSERT_TRUE(Init(resampler, remapLayout, AV_SAMPLE_FMT_FLTP, 44100));
+  ASSERT_TRUE(resampler.UsesSwresample());
+  SwrContext *remapContext = resampler.GetContext();
+
+  ASSERT_TRUE(Init(resampler, swapLayout, AV_SAMPLE_FMT_FLTP, 44100));
+  ASSERT_TRUE(Init(resampler, remapLayout, AV_SAMPLE_FMT_FLTP, 44100));
+  EXPECT_EQ(remapContext, resampler.GetContext());
+
+  // the first block fills the filter, the constant levels have settled in the second one
+  ASSERT_GT(Resample(resampler, AV_SAMPLE_FMT_FLTP), 0);
+  int frames = Resample(resampler, AV_SAMPLE_FMT_FLTP);
+  ASSERT_GT(frames, TEST_FRAMES);
+  ExpectRemapped(remapLayout, 0, 0.01f);
+  ExpectRemapped(remapLayout, frames - 1, 0.01f);
+}
@@ -0,0 +1,716 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEKernels.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AE_KERNELS_X86
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define AE_TARGET_SSE2 __attribute__((target("sse2")))
+#define AE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AE_TARGET_SSE2
+#define AE_TARGET_AVX2
+#endif
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__)
+#define AE_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+  Reference implementations, also used for the tails the vector versions
+  can not process in full registers.
+*/
+
+static inline float SoftClamp(float x)
+{
+  /*
+     This is a rational function to approximate a tanh-like soft clipper.
+     It is based on the pade-approximation of the tanh function with tweaked coefficients.
+     See: http://www.musicdsp.org/showone.php?id=238
+  */
+  if (x < -3.0f)
+    return -1.0f;
+  else if (x > 3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+static inline int16_t ToS16(float x)
+{
+  x *= 32768.0f;
+  if (x >= 32767.0f)
+    return INT16_MAX;
+  if (x <= -32768.0f)
+    return INT16_MIN;
+  return (int16_t)lrintf(x);
+}
+
+static inline int32_t ToS24(float x)
+{
+  x *= 8388608.0f;
+  if (x >= 8388607.0f)
+    return 8388607;
+  if (x <= -8388608.0f)
+    return -8388608;
+  return (int32_t)lrintf(x);
+}
+
+static inline int32_t ToS32(float x)
+{
+  x *= 2147483648.0f;
+  if (x >= 2147483648.0f)
+    return INT32_MAX;
+  if (x <= -2147483648.0f)
+    return INT32_MIN;
+  return (int32_t)lrintf(x);
+}
+
+static void MulC(float *data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+static void MulGainsC(float *data, const float *gains, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= gains[i];
+}
+
+static void MulAddC(float *dst, const float *src, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] += src[i] * mul;
+}
+
+static void MulAddGainsC(float *dst, const float *src, const float *gains, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] += src[i] * gains[i];
+}
+
+static float PeakC(const float *data, uint32_t count)
+{
+  float peak = 0.0f;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    float value = fabsf(data[i]);
+    if (value > peak)
+      peak = value;
+  }
+  return peak;
+}
+
+static void ClampC(float *data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
+}
+
+static void FloatToS16C(const float *src, int16_t *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = ToS16(src[i]);
+}
+
+static void FloatToS24C(const float *src, int32_t *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = ToS24(src[i]);
+}
+
+static void FloatToS32C(const float *src, int32_t *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = ToS32(src[i]);
+}
+
+static void InterleaveC(const float* const *src, unsigned int channels, float *dst, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    memcpy(dst, src[0], frames * sizeof(float));
+    return;
+  }
+
+  for (uint32_t i = 0; i < frames; ++i)
+    for (unsigned int ch = 0; ch < channels; ++ch)
+      *dst++ = src[ch][i];
+}
+
+static void InterleaveTail(const float* const *src, unsigned int channels, float *dst, uint32_t start, uint32_t frames)
+{
+  for (uint32_t i = start; i < frames; ++i)
+    for (unsigned int ch = 0; ch < channels; ++ch)
+      dst[i * channels + ch] = src[ch][i];
+}
+
+static const AEKernels kernelsC =
+{
+  AEKernels::VARIANT_C, "C",
+  MulC, MulGainsC, MulAddC, MulAddGainsC, PeakC, ClampC,
+  FloatToS16C, FloatToS24C, FloatToS32C, InterleaveC
+};
+
+#if defined(AE_KERNELS_X86)
+
+AE_TARGET_SSE2 static void MulSSE2(float *data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulC(data + i, mul, count - i);
+}
+
+AE_TARGET_SSE2 static void MulGainsSSE2(float *data, const float *gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(gains + i)));
+  MulGainsC(data + i, gains + i, count - i);
+}
+
+AE_TARGET_SSE2 static void MulAddSSE2(float *dst, const float *src, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), m)));
+  MulAddC(dst + i, src + i, mul, count - i);
+}
+
+AE_TARGET_SSE2 static void MulAddGainsSSE2(float *dst, const float *src, const float *gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(gains + i))));
+  MulAddGainsC(dst + i, src + i, gains + i, count - i);
+}
+
+AE_TARGET_SSE2 static inline float HorizontalMaxSSE2(__m128 v)
+{
+  v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+AE_TARGET_SSE2 static float PeakSSE2(const float *data, uint32_t count)
+{
+  const __m128 abs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  __m128 peak = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    peak = _mm_max_ps(peak, _mm_and_ps(_mm_loadu_ps(data + i), abs));
+  float result = HorizontalMaxSSE2(peak);
+  float tail = PeakC(data + i, count - i);
+  return tail > result ? tail : result;
+}
+
+AE_TARGET_SSE2 static void ClampSSE2(float *data, uint32_t count)
+{
+  const __m128 c1 = _mm_set1_ps(27.0f);
+  const __m128 c2 = _mm_set1_ps(9.0f);
+  const __m128 lo = _mm_set1_ps(-3.0f);
+  const __m128 hi = _mm_set1_ps(3.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi);
+    __m128 y = _mm_mul_ps(x, x);
+    _mm_storeu_ps(data + i, _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c1, y)), _mm_add_ps(c1, _mm_mul_ps(c2, y))));
+  }
+  ClampC(data + i, count - i);
+}
+
+AE_TARGET_SSE2 static void FloatToS16SSE2(const float *src, int16_t *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(32768.0f);
+  const __m128 lo = _mm_set1_ps(-32768.0f);
+  const __m128 hi = _mm_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo), hi);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), lo), hi);
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
+
+AE_TARGET_SSE2 static void FloatToS24SSE2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(8388608.0f);
+  const __m128 lo = _mm_set1_ps(-8388608.0f);
+  const __m128 hi = _mm_set1_ps(8388607.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo), hi);
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_cvtps_epi32(v));
+  }
+  FloatToS24C(src + i, dst + i, count - i);
+}
+
+AE_TARGET_SSE2 static void FloatToS32SSE2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(2147483648.0f);
+  const __m128 lo = _mm_set1_ps(-2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 v = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo);
+    // positive overflows convert to 0x80000000, flipping them gives INT32_MAX
+    __m128i overflow = _mm_castps_si128(_mm_cmpge_ps(v, scale));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(_mm_cvtps_epi32(v), overflow));
+  }
+  FloatToS32C(src + i, dst + i, count - i);
+}
+
+AE_TARGET_SSE2 static void InterleaveSSE2(const float* const *src, unsigned int channels, float *dst, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    memcpy(dst, src[0], frames * sizeof(float));
+    return;
+  }
+
+  // blocks of four frames, channels are handled in groups of four, two and one
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float *out = dst + i * channels;
+    unsigned int ch = 0;
+    for (; ch + 4 <= channels; ch += 4)
+    {
+      __m128 r0 = _mm_loadu_ps(src[ch] + i);
+      __m128 r1 = _mm_loadu_ps(src[ch + 1] + i);
+      __m128 r2 = _mm_loadu_ps(src[ch + 2] + i);
+      __m128 r3 = _mm_loadu_ps(src[ch + 3] + i);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _mm_storeu_ps(out + ch, r0);
+      _mm_storeu_ps(out + channels + ch, r1);
+      _mm_storeu_ps(out + 2 * channels + ch, r2);
+      _mm_storeu_ps(out + 3 * channels + ch, r3);
+    }
+    if (ch + 2 <= channels)
+    {
+      __m128 a = _mm_loadu_ps(src[ch] + i);
+      __m128 b = _mm_loadu_ps(src[ch + 1] + i);
+      __m128 lo = _mm_unpacklo_ps(a, b);
+      __m128 hi = _mm_unpackhi_ps(a, b);
+      _mm_storel_pi((__m64*)(out + ch), lo);
+      _mm_storeh_pi((__m64*)(out + channels + ch), lo);
+      _mm_storel_pi((__m64*)(out + 2 * channels + ch), hi);
+      _mm_storeh_pi((__m64*)(out + 3 * channels + ch), hi);
+      ch += 2;
+    }
+    if (ch < channels)
+    {
+      const float *in = src[ch] + i;
+      out[ch] = in[0];
+      out[channels + ch] = in[1];
+      out[2 * channels + ch] = in[2];
+      out[3 * channels + ch] = in[3];
+    }
+  }
+  InterleaveTail(src, channels, dst, i, frames);
+}
+
+static const AEKernels kernelsSSE2 =
+{
+  AEKernels::VARIANT_SSE2, "SSE2",
+  MulSSE2, MulGainsSSE2, MulAddSSE2, MulAddGainsSSE2, PeakSSE2, ClampSSE2,
+  FloatToS16SSE2, FloatToS24SSE2, FloatToS32SSE2, InterleaveSSE2
+};
+
+AE_TARGET_AVX2 static void MulAVX2(float *data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  MulC(data + i, mul, count - i);
+}
+
+AE_TARGET_AVX2 static void MulGainsAVX2(float *data, const float *gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(gains + i)));
+  MulGainsC(data + i, gains + i, count - i);
+}
+
+AE_TARGET_AVX2 static void MulAddAVX2(float *dst, const float *src, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), m)));
+  MulAddC(dst + i, src + i, mul, count - i);
+}
+
+AE_TARGET_AVX2 static void MulAddGainsAVX2(float *dst, const float *src, const float *gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), _mm256_loadu_ps(gains + i))));
+  MulAddGainsC(dst + i, src + i, gains + i, count - i);
+}
+
+AE_TARGET_AVX2 static float PeakAVX2(const float *data, uint32_t count)
+{
+  const __m256 abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  __m256 peak = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    peak = _mm256_max_ps(peak, _mm256_and_ps(_mm256_loadu_ps(data + i), abs));
+  __m128 v = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+  v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  float result = _mm_cvtss_f32(v);
+  float tail = PeakC(data + i, count - i);
+  return tail > result ? tail : result;
+}
+
+AE_TARGET_AVX2 static void ClampAVX2(float *data, uint32_t count)
+{
+  const __m256 c1 = _mm256_set1_ps(27.0f);
+  const __m256 c2 = _mm256_set1_ps(9.0f);
+  const __m256 lo = _mm256_set1_ps(-3.0f);
+  const __m256 hi = _mm256_set1_ps(3.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi);
+    __m256 y = _mm256_mul_ps(x, x);
+    _mm256_storeu_ps(data + i, _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(c1, y)), _mm256_add_ps(c1, _mm256_mul_ps(c2, y))));
+  }
+  ClampC(data + i, count - i);
+}
+
+AE_TARGET_AVX2 static void FloatToS16AVX2(const float *src, int16_t *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(32768.0f);
+  const __m256 lo = _mm256_set1_ps(-32768.0f);
+  const __m256 hi = _mm256_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo), hi);
+    __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), lo), hi);
+    // packing works per 128 bit lane, restore the sample order afterwards
+    __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
+
+AE_TARGET_AVX2 static void FloatToS24AVX2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(8388608.0f);
+  const __m256 lo = _mm256_set1_ps(-8388608.0f);
+  const __m256 hi = _mm256_set1_ps(8388607.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo), hi);
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_cvtps_epi32(v));
+  }
+  FloatToS24C(src + i, dst + i, count - i);
+}
+
+AE_TARGET_AVX2 static void FloatToS32AVX2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(2147483648.0f);
+  const __m256 lo = _mm256_set1_ps(-2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo);
+    // positive overflows convert to 0x80000000, flipping them gives INT32_MAX
+    __m256i overflow = _mm256_castps_si256(_mm256_cmp_ps(v, scale, _CMP_GE_OQ));
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(_mm256_cvtps_epi32(v), overflow));
+  }
+  FloatToS32C(src + i, dst + i, count - i);
+}
+
+// interleaving is bound by the scattered stores, the SSE2 version is as fast
+static const AEKernels kernelsAVX2 =
+{
+  AEKernels::VARIANT_AVX2, "AVX2",
+  MulAVX2, MulGainsAVX2, MulAddAVX2, MulAddGainsAVX2, PeakAVX2, ClampAVX2,
+  FloatToS16AVX2, FloatToS24AVX2, FloatToS32AVX2, InterleaveSSE2
+};
+
+#endif
+
+#if defined(AE_KERNELS_NEON)
+
+static void MulNEON(float *data, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+  MulC(data + i, mul, count - i);
+}
+
+static void MulGainsNEON(float *data, const float *gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(gains + i)));
+  MulGainsC(data + i, gains + i, count - i);
+}
+
+static void MulAddNEON(float *dst, const float *src, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), mul));
+  MulAddC(dst + i, src + i, mul, count - i);
+}
+
+static void MulAddGainsNEON(float *dst, const float *src, const float *gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), vld1q_f32(gains + i)));
+  MulAddGainsC(dst + i, src + i, gains + i, count - i);
+}
+
+static float PeakNEON(const float *data, uint32_t count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    peak = vmaxq_f32(peak, vabsq_f32(vld1q_f32(data + i)));
+  float32x2_t v = vpmax_f32(vget_low_f32(peak), vget_high_f32(peak));
+  v = vpmax_f32(v, v);
+  float result = vget_lane_f32(v, 0);
+  float tail = PeakC(data + i, count - i);
+  return tail > result ? tail : result;
+}
+
+static inline float32x4_t DivideNEON(float32x4_t a, float32x4_t b)
+{
+#if defined(__aarch64__)
+  return vdivq_f32(a, b);
+#else
+  // reciprocal estimate refined by two newton-raphson steps
+  float32x4_t r = vrecpeq_f32(b);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  return vmulq_f32(a, r);
+#endif
+}
+
+static inline int32x4_t RoundNEON(float32x4_t v)
+{
+#if defined(__aarch64__)
+  return vcvtnq_s32_f32(v);
+#else
+  // no rounding conversion on ARMv7, add +-0.5 and truncate
+  const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000));
+  const float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), sign));
+  return vcvtq_s32_f32(vaddq_f32(v, half));
+#endif
+}
+
+static void ClampNEON(float *data, uint32_t count)
+{
+  const float32x4_t c1 = vdupq_n_f32(27.0f);
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t y = vmulq_f32(x, x);
+    vst1q_f32(data + i, DivideNEON(vmulq_f32(x, vaddq_f32(c1, y)), vmlaq_n_f32(c1, y, 9.0f)));
+  }
+  ClampC(data + i, count - i);
+}
+
+static void FloatToS16NEON(const float *src, int16_t *dst, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-32768.0f);
+  const float32x4_t hi = vdupq_n_f32(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), 32768.0f), lo), hi);
+    float32x4_t b = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f), lo), hi);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(RoundNEON(a)), vqmovn_s32(RoundNEON(b))));
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
+
+static void FloatToS24NEON(const float *src, int32_t *dst, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-8388608.0f);
+  const float32x4_t hi = vdupq_n_f32(8388607.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t v = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), 8388608.0f), lo), hi);
+    vst1q_s32(dst + i, RoundNEON(v));
+  }
+  FloatToS24C(src + i, dst + i, count - i);
+}
+
+static void FloatToS32NEON(const float *src, int32_t *dst, uint32_t count)
+{
+  uint32_t i = 0;
+  // the conversion saturates on its own
+  for (; i + 4 <= count; i += 4)
+    vst1q_s32(dst + i, RoundNEON(vmulq_n_f32(vld1q_f32(src + i), 2147483648.0f)));
+  FloatToS32C(src + i, dst + i, count - i);
+}
+
+static void InterleaveNEON(const float* const *src, unsigned int channels, float *dst, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    memcpy(dst, src[0], frames * sizeof(float));
+    return;
+  }
+
+  // blocks of four frames, channels are handled in groups of four, two and one
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float *out = dst + i * channels;
+    unsigned int ch = 0;
+    for (; ch + 4 <= channels; ch += 4)
+    {
+      float32x4x2_t ac = vzipq_f32(vld1q_f32(src[ch] + i), vld1q_f32(src[ch + 2] + i));
+      float32x4x2_t bd = vzipq_f32(vld1q_f32(src[ch + 1] + i), vld1q_f32(src[ch + 3] + i));
+      float32x4x2_t r01 = vzipq_f32(ac.val[0], bd.val[0]);
+      float32x4x2_t r23 = vzipq_f32(ac.val[1], bd.val[1]);
+      vst1q_f32(out + ch, r01.val[0]);
+      vst1q_f32(out + channels + ch, r01.val[1]);
+      vst1q_f32(out + 2 * channels + ch, r23.val[0]);
+      vst1q_f32(out + 3 * channels + ch, r23.val[1]);
+    }
+    if (ch + 2 <= channels)
+    {
+      float32x4x2_t ab = vzipq_f32(vld1q_f32(src[ch] + i), vld1q_f32(src[ch + 1] + i));
+      vst1_f32(out + ch, vget_low_f32(ab.val[0]));
+      vst1_f32(out + channels + ch, vget_high_f32(ab.val[0]));
+      vst1_f32(out + 2 * channels + ch, vget_low_f32(ab.val[1]));
+      vst1_f32(out + 3 * channels + ch, vget_high_f32(ab.val[1]));
+      ch += 2;
+    }
+    if (ch < channels)
+    {
+      const float *in = src[ch] + i;
+      out[ch] = in[0];
+      out[channels + ch] = in[1];
+      out[2 * channels + ch] = in[2];
+      out[3 * channels + ch] = in[3];
+    }
+  }
+  InterleaveTail(src, channels, dst, i, frames);
+}
+
+static const AEKernels kernelsNEON =
+{
+  AEKernels::VARIANT_NEON, "NEON",
+  MulNEON, MulGainsNEON, MulAddNEON, MulAddGainsNEON, PeakNEON, ClampNEON,
+  FloatToS16NEON, FloatToS24NEON, FloatToS32NEON, InterleaveNEON
+};
+
+#endif
+
+const AEKernels* CAEKernels::Get(AEKernels::Variant variant)
+{
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+
+  switch (variant)
+  {
+  case AEKernels::VARIANT_C:
+    return &kernelsC;
+#if defined(AE_KERNELS_X86)
+  case AEKernels::VARIANT_SSE2:
+    if (features & CPU_FEATURE_SSE2)
+      return &kernelsSSE2;
+    break;
+  case AEKernels::VARIANT_AVX2:
+    if (features & CPU_FEATURE_AVX2)
+      return &kernelsAVX2;
+    break;
+#endif
+#if defined(AE_KERNELS_NEON)
+  case AEKernels::VARIANT_NEON:
+#if defined(__aarch64__)
+    return &kernelsNEON;
+#else
+    if (features & CPU_FEATURE_NEON)
+      return &kernelsNEON;
+    break;
+#endif
+#endif
+  default:
+    break;
+  }
+
+  return nullptr;
+}
+
+static const AEKernels* SelectKernels()
+{
+  static const AEKernels::Variant preferred[] =
+  {
+    AEKernels::VARIANT_AVX2,
+    AEKernels::VARIANT_SSE2,
+    AEKernels::VARIANT_NEON
+  };
+
+  const AEKernels *kernels = &kernelsC;
+  for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]); ++i)
+  {
+    const AEKernels *candidate = CAEKernels::Get(preferred[i]);
+    if (candidate != nullptr)
+    {
+      kernels = candidate;
+      break;
+    }
+  }
+
+  CLog::Log(LOGNOTICE, "CAEKernels: using %s kernels", kernels->name);
+  return kernels;
+}
+
+const AEKernels& CAEKernels::Get()
+{
+  static const AEKernels *kernels = SelectKernels();
+  return *kernels;
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*!
+ \brief Sample processing kernels used by ActiveAE
+
+ Every kernel exists in a plain C version and, depending on the platform,
+ in SSE2, AVX2 and NEON versions. CAEKernels::Get() picks the fastest
+ variant the running CPU supports once and returns the same table for the
+ lifetime of the process. None of the kernels require aligned buffers.
+ */
+struct AEKernels
+{
+  enum Variant
+  {
+    VARIANT_C = 0,
+    VARIANT_SSE2,
+    VARIANT_AVX2,
+    VARIANT_NEON,
+    VARIANT_MAX
+  };
+
+  Variant variant;
+  const char *name;
+
+  //! data[i] *= mul
+  void (*Mul)(float *data, float mul, uint32_t count);
+  //! data[i] *= gains[i]
+  void (*MulGains)(float *data, const float *gains, uint32_t count);
+  //! dst[i] += src[i] * mul
+  void (*MulAdd)(float *dst, const float *src, float mul, uint32_t count);
+  //! dst[i] += src[i] * gains[i]
+  void (*MulAddGains)(float *dst, const float *src, const float *gains, uint32_t count);
+  //! returns the largest absolute sample value
+  float (*Peak)(const float *data, uint32_t count);
+  //! soft clips samples into the range -1.0 .. 1.0
+  void (*Clamp)(float *data, uint32_t count);
+  //! converts to signed 16 bit, rounding to nearest and saturating
+  void (*FloatToS16)(const float *src, int16_t *dst, uint32_t count);
+  //! converts to signed 24 bit carried in the lower bits of 32 bit words (AE_FMT_S24NE4)
+  void (*FloatToS24)(const float *src, int32_t *dst, uint32_t count);
+  //! converts to signed 32 bit
+  void (*FloatToS32)(const float *src, int32_t *dst, uint32_t count);
+  //! interleaves frames of planar channels, src[ch][i] -> dst[i * channels + ch]
+  void (*Interleave)(const float* const *src, unsigned int channels, float *dst, uint32_t frames);
+};
+
+class CAEKernels
+{
+public:
+  /*!
+   \brief Get the best kernels for the running CPU
+   */
+  static const AEKernels& Get();
+
+  /*!
+   \brief Get a specific kernel variant
+   \return the kernels or nullptr if the variant was not built or is not supported by the CPU
+   */
+  static const AEKernels* Get(AEKernels::Variant variant);
+};
@@ -0,0 +1,104 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <vector>
+
+/**
+ * Bounded single producer / single consumer queue used to hand sample
+ * buffers between the audio threads without taking locks or allocating.
+ * Exactly one thread may call Push() and exactly one thread may call Pop().
+ * Reset() may only be called while neither side is active, e.g. while the
+ * producer waits for a synchronous message to be answered by the consumer.
+ */
+template<typename T>
+class CAESPSCQueue
+{
+public:
+  explicit CAESPSCQueue(unsigned int capacity)
+  {
+    unsigned int size = 2;
+    while (size < capacity)
+      size <<= 1;
+    m_slots.resize(size);
+    m_mask = size - 1;
+    m_head = 0;
+    m_tail = 0;
+  }
+
+  /**
+   * Append an item, called by the producer only
+   * @return false if the queue is full
+   */
+  bool Push(const T &item)
+  {
+    unsigned int tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+      return false;
+    m_slots[tail & m_mask] = item;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Remove the oldest item, called by the consumer only
+   * @return false if the queue is empty
+   */
+  bool Pop(T &item)
+  {
+    unsigned int head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+      return false;
+    item = m_slots[head & m_mask];
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool IsEmpty() const
+  {
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+  }
+
+  unsigned int Size() const
+  {
+    return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+  }
+
+  unsigned int Capacity() const { return m_mask + 1; }
+
+  void Reset()
+  {
+    m_head.store(m_tail.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+protected:
+  static const unsigned int CACHE_LINE_SIZE = 64;
+
+  std::vector<T> m_slots;
+  unsigned int m_mask;
+  // keep the indices on separate cache lines, each one is written by one side only.
+  // padded rather than aligned, over-aligned members would make every owner of
+  // a queue an over-aligned type which operator new doesn't honour before C++17
+  std::atomic<unsigned int> m_head;
+  char m_headPad[CACHE_LINE_SIZE - sizeof(std::atomic<unsigned int>)];
+  std::atomic<unsigned int> m_tail;
+  char m_tailPad[CACHE_LINE_SIZE - sizeof(std::atomic<unsigned int>)];
+};
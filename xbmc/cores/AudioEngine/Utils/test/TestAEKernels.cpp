@@ -0,0 +1,199 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// odd sizes and offsets so the vector loops, their tails and unaligned buffers are all covered
+static const uint32_t sizes[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 1023 };
+
+static std::vector<float> CreateSamples(size_t count, float range)
+{
+  std::vector<float> samples(count);
+  for (size_t i = 0; i < count; ++i)
+    samples[i] = range * (2.0f * (float)rand() / (float)RAND_MAX - 1.0f);
+  return samples;
+}
+
+static std::vector<const AEKernels*> GetVariants()
+{
+  std::vector<const AEKernels*> variants;
+  for (int i = AEKernels::VARIANT_C + 1; i < AEKernels::VARIANT_MAX; ++i)
+  {
+    const AEKernels *kernels = CAEKernels::Get((AEKernels::Variant)i);
+    if (kernels != nullptr)
+      variants.push_back(kernels);
+  }
+  return variants;
+}
+
+TEST(TestAEKernels, Get)
+{
+  const AEKernels *c = CAEKernels::Get(AEKernels::VARIANT_C);
+  ASSERT_NE(nullptr, c);
+  EXPECT_EQ(AEKernels::VARIANT_C, c->variant);
+
+  const AEKernels &best = CAEKernels::Get();
+  EXPECT_EQ(&best, CAEKernels::Get(best.variant));
+  EXPECT_EQ(&best, &CAEKernels::Get());
+}
+
+TEST(TestAEKernels, Conversions)
+{
+  const AEKernels *c = CAEKernels::Get(AEKernels::VARIANT_C);
+  std::vector<const AEKernels*> variants = GetVariants();
+  variants.push_back(c);
+
+  const float src[] = { 0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 2.0f, -2.0f, 0.25f, 1.0f / 32768.0f };
+  const int16_t s16[] = { 0, 16384, -16384, INT16_MAX, INT16_MIN, INT16_MAX, INT16_MIN, 8192, 1 };
+  const int32_t s24[] = { 0, 4194304, -4194304, 8388607, -8388608, 8388607, -8388608, 2097152, 256 };
+  const int32_t s32[] = { 0, 1073741824, -1073741824, INT32_MAX, INT32_MIN, INT32_MAX, INT32_MIN, 536870912, 65536 };
+  const uint32_t count = sizeof(src) / sizeof(src[0]);
+
+  // repeat the pattern so every variant converts it with full vector registers as well
+  std::vector<float> in;
+  for (int i = 0; i < 4; ++i)
+    in.insert(in.end(), src, src + count);
+
+  for (const AEKernels *kernels : variants)
+  {
+    SCOPED_TRACE(kernels->name);
+    std::vector<int16_t> out16(in.size());
+    std::vector<int32_t> out32(in.size());
+
+    kernels->FloatToS16(in.data(), out16.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      EXPECT_EQ(s16[i % count], out16[i]) << "sample " << in[i];
+
+    kernels->FloatToS24(in.data(), out32.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      EXPECT_EQ(s24[i % count], out32[i]) << "sample " << in[i];
+
+    kernels->FloatToS32(in.data(), out32.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      EXPECT_EQ(s32[i % count], out32[i]) << "sample " << in[i];
+  }
+}
+
+TEST(TestAEKernels, MatchReference)
+{
+  const AEKernels *c = CAEKernels::Get(AEKernels::VARIANT_C);
+
+  for (const AEKernels *kernels : GetVariants())
+  {
+    SCOPED_TRACE(kernels->name);
+    for (uint32_t size : sizes)
+    {
+      SCOPED_TRACE(size);
+      // start one sample into the buffers to misalign them
+      std::vector<float> data = CreateSamples(size + 1, 4.0f);
+      std::vector<float> src = CreateSamples(size + 1, 1.0f);
+      std::vector<float> gains = CreateSamples(size + 1, 1.0f);
+      std::vector<float> expected, actual;
+
+      expected = actual = data;
+      c->Mul(expected.data() + 1, 0.7f, size);
+      kernels->Mul(actual.data() + 1, 0.7f, size);
+      EXPECT_EQ(expected, actual);
+
+      expected = actual = data;
+      c->MulGains(expected.data() + 1, gains.data() + 1, size);
+      kernels->MulGains(actual.data() + 1, gains.data() + 1, size);
+      EXPECT_EQ(expected, actual);
+
+      expected = actual = data;
+      c->MulAdd(expected.data() + 1, src.data() + 1, 0.3f, size);
+      kernels->MulAdd(actual.data() + 1, src.data() + 1, 0.3f, size);
+      for (size_t i = 0; i < expected.size(); ++i)
+        EXPECT_NEAR(expected[i], actual[i], 1e-6f);
+
+      expected = actual = data;
+      c->MulAddGains(expected.data() + 1, src.data() + 1, gains.data() + 1, size);
+      kernels->MulAddGains(actual.data() + 1, src.data() + 1, gains.data() + 1, size);
+      for (size_t i = 0; i < expected.size(); ++i)
+        EXPECT_NEAR(expected[i], actual[i], 1e-6f);
+
+      EXPECT_EQ(c->Peak(data.data() + 1, size), kernels->Peak(data.data() + 1, size));
+
+      expected = actual = data;
+      c->Clamp(expected.data() + 1, size);
+      kernels->Clamp(actual.data() + 1, size);
+      for (size_t i = 0; i < expected.size(); ++i)
+      {
+        EXPECT_NEAR(expected[i], actual[i], 1e-6f);
+        EXPECT_LE(std::fabs(actual[i]), i == 0 ? 4.0f : 1.0f);
+      }
+
+      // rounding may differ by one step where the hardware rounds ties away from zero
+      std::vector<int16_t> expected16(size + 1), actual16(size + 1);
+      c->FloatToS16(src.data() + 1, expected16.data() + 1, size);
+      kernels->FloatToS16(src.data() + 1, actual16.data() + 1, size);
+      for (size_t i = 0; i < expected16.size(); ++i)
+        EXPECT_NEAR(expected16[i], actual16[i], 1);
+
+      std::vector<int32_t> expected32(size + 1), actual32(size + 1);
+      c->FloatToS24(src.data() + 1, expected32.data() + 1, size);
+      kernels->FloatToS24(src.data() + 1, actual32.data() + 1, size);
+      for (size_t i = 0; i < expected32.size(); ++i)
+        EXPECT_NEAR(expected32[i], actual32[i], 1);
+
+      c->FloatToS32(src.data() + 1, expected32.data() + 1, size);
+      kernels->FloatToS32(src.data() + 1, actual32.data() + 1, size);
+      for (size_t i = 0; i < expected32.size(); ++i)
+        EXPECT_NEAR((double)expected32[i], (double)actual32[i], 128.0);
+    }
+  }
+}
+
+TEST(TestAEKernels, Interleave)
+{
+  std::vector<const AEKernels*> variants = GetVariants();
+  variants.push_back(CAEKernels::Get(AEKernels::VARIANT_C));
+
+  for (const AEKernels *kernels : variants)
+  {
+    SCOPED_TRACE(kernels->name);
+    for (unsigned int channels = 1; channels <= 8; ++channels)
+    {
+      SCOPED_TRACE(channels);
+      for (uint32_t frames : sizes)
+      {
+        std::vector<std::vector<float> > planes;
+        std::vector<const float*> src;
+        for (unsigned int ch = 0; ch < channels; ++ch)
+          planes.push_back(CreateSamples(frames + 1, 1.0f));
+        for (unsigned int ch = 0; ch < channels; ++ch)
+          src.push_back(planes[ch].data() + 1);
+
+        std::vector<float> dst(frames * channels + 1, 5.0f);
+        kernels->Interleave(src.data(), channels, dst.data(), frames);
+        for (uint32_t i = 0; i < frames; ++i)
+          for (unsigned int ch = 0; ch < channels; ++ch)
+            ASSERT_EQ(src[ch][i], dst[i * channels + ch]);
+        EXPECT_EQ(5.0f, dst.back());
+      }
+    }
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AESPSCQueue.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestAESPSCQueue, Capacity)
+{
+  CAESPSCQueue<int> queue(5);
+  EXPECT_EQ(8U, queue.Capacity());
+  EXPECT_TRUE(queue.IsEmpty());
+
+  for (int i = 0; i < 8; i++)
+    EXPECT_TRUE(queue.Push(i));
+  EXPECT_FALSE(queue.Push(8));
+  EXPECT_EQ(8U, queue.Size());
+
+  int value;
+  for (int i = 0; i < 8; i++)
+  {
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(queue.Pop(value));
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TestAESPSCQueue, WrapAround)
+{
+  CAESPSCQueue<int> queue(4);
+  int value;
+  for (int i = 0; i < 1000; i++)
+  {
+    EXPECT_TRUE(queue.Push(i));
+    EXPECT_TRUE(queue.Push(-i));
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(i, value);
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(-i, value);
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TestAESPSCQueue, Reset)
+{
+  CAESPSCQueue<int> queue(4);
+  queue.Push(1);
+  queue.Push(2);
+  queue.Reset();
+  EXPECT_TRUE(queue.IsEmpty());
+
+  int value;
+  EXPECT_FALSE(queue.Pop(value));
+  EXPECT_TRUE(queue.Push(3));
+  EXPECT_TRUE(queue.Pop(value));
+  EXPECT_EQ(3, value);
+}
+
+namespace
+{
+const unsigned int producerItems = 100000;
+
+class CQueueProducer : public IRunnable
+{
+public:
+  explicit CQueueProducer(CAESPSCQueue<unsigned int> &queue) : m_queue(queue) {}
+  virtual void Run()
+  {
+    for (unsigned int i = 0; i < producerItems; i++)
+    {
+      while (!m_queue.Push(i))
+        XbmcThreads::ThreadSleep(0);
+    }
+  }
+private:
+  CAESPSCQueue<unsigned int> &m_queue;
+};
+}
+
+TEST(TestAESPSCQueue, ProducerConsumer)
+{
+  CAESPSCQueue<unsigned int> queue(64);
+  CQueueProducer producer(queue);
+  CThread thread(&producer, "SPSCProducer");
+  thread.Create();
+
+  // items have to arrive complete and in order
+  unsigned int expected = 0;
+  unsigned int value;
+  while (expected < producerItems)
+  {
+    if (queue.Pop(value))
+    {
+      ASSERT_EQ(expected, value);
+      expected++;
+    }
+    else
+      XbmcThreads::ThreadSleep(0);
+  }
+  thread.StopThread(true);
+  EXPECT_TRUE(queue.IsEmpty());
+}
@@ -23,6 +23,7 @@
 #include "AMLCodec.h"
 #include "DynamicDll.h"
 
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxPacket.h"
 #include "cores/VideoPlayer/DVDClock.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderFlags.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
@@ -1772,7 +1773,7 @@ void CAMLCodec::Reset()
   SetSpeed(m_speed);
 }
 
-int CAMLCodec::Decode(uint8_t *pData, size_t iSize, double dts, double pts)
+int CAMLCodec::Decode(uint8_t *pData, size_t iSize, double dts, double pts, const DemuxPacket *pSegments)
 {
   if (!m_opened)
     return VC_BUFFER;
@@ -1820,24 +1821,20 @@ int CAMLCodec::Decode(uint8_t *pData, size_t iSize, double dts, double pts)
     // and is controlled by am_pkt.newflag.
     set_header_info(am_private);
 
-    // loop until we write all into codec, am_pkt.isvalid
-    // will get set to zero once everything is consumed.
-    // PLAYER_SUCCESS means all is ok, not all bytes were written.
-    int loop = 0;
-    while (am_private->am_pkt.isvalid && loop < 100)
-    {
-      // abort on any errors.
-      if (write_av_packet(am_private, &am_private->am_pkt) != PLAYER_SUCCESS)
-        break;
+    bool written = WritePacket();
 
-      if (am_private->am_pkt.isvalid)
-        CLog::Log(LOGDEBUG, "CAMLCodec::Decode: write_av_packet looping");
-      loop++;
-    }
-    if (loop == 100)
+    // further segments of the same access unit follow the first write
+    // directly, pts and header were checked in with the first one.
+    for (const DemuxPacket *segment = pSegments; written && segment; segment = segment->pNext)
     {
-      // Decoder got stuck; Reset
-      Reset();
+      if (segment->iSize <= 0)
+        continue;
+
+      am_private->am_pkt.data = segment->pData;
+      am_private->am_pkt.data_size = segment->iSize;
+      am_private->am_pkt.newflag = 0;
+      am_private->am_pkt.isvalid = 1;
+      written = WritePacket();
     }
 
     // if we seek, then GetTimeSize is wrong as
@@ -1880,6 +1877,31 @@ int CAMLCodec::Decode(uint8_t *pData, size_t iSize, double dts, double pts)
   return rtn;
 }
 
+bool CAMLCodec::WritePacket()
+{
+  // loop until we write all into codec, am_pkt.isvalid
+  // will get set to zero once everything is consumed.
+  // PLAYER_SUCCESS means all is ok, not all bytes were written.
+  int loop = 0;
+  while (am_private->am_pkt.isvalid && loop < 100)
+  {
+    // abort on any errors.
+    if (write_av_packet(am_private, &am_private->am_pkt) != PLAYER_SUCCESS)
+      break;
+
+    if (am_private->am_pkt.isvalid)
+      CLog::Log(LOGDEBUG, "CAMLCodec::Decode: write_av_packet looping");
+    loop++;
+  }
+  if (loop == 100)
+  {
+    // Decoder got stuck; Reset
+    Reset();
+    return false;
+  }
+  return !am_private->am_pkt.isvalid;
+}
+
 int CAMLCodec::DequeueBuffer(int64_t &pts)
 {
   v4l2_buffer vbuf = { 0 };
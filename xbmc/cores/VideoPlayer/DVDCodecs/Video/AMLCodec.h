@@ -44,7 +44,7 @@ public:
   void          CloseDecoder();
   void          Reset();
 
-  int           Decode(uint8_t *pData, size_t size, double dts, double pts);
+  int           Decode(uint8_t *pData, size_t size, double dts, double pts, const DemuxPacket *pSegments = NULL);
 
   bool          GetPicture(DVDVideoPicture* pDvdVideoPicture);
   void          SetSpeed(int speed);
@@ -70,6 +70,7 @@ private:
   std::string   GetVfmMap(const std::string &name);
   void          SetVfmMap(const std::string &name, const std::string &map);
   int           DequeueBuffer(int64_t &pts);
+  bool          WritePacket();
 
   DllLibAmCodec   *m_dll;
   bool             m_opened;
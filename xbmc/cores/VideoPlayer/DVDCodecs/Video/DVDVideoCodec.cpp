@@ -19,10 +19,20 @@
  */
 
 #include "DVDVideoCodec.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
 #include "settings/Settings.h"
 #include "settings/lib/Setting.h"
 #include "windowing/WindowingFactory.h"
 
+int CDVDVideoCodec::DecodePacket(DemuxPacket* pPacket)
+{
+  if (!pPacket->pNext)
+    return Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+
+  int size = CDVDDemuxUtils::GatherDemuxPacket(pPacket, m_segmentBuffer);
+  return Decode(m_segmentBuffer.data(), size, pPacket->dts, pPacket->pts);
+}
+
 bool CDVDVideoCodec::IsSettingVisible(const std::string &condition, const std::string &value, const CSetting *setting, void *data)
 {
   if (setting == NULL || value.empty())
@@ -48,6 +48,7 @@ class COpenMax;
 class COpenMaxVideo;
 struct OpenMaxVideoBufferHolder;
 class CDVDMediaCodecInfo;
+struct DemuxPacket;
 class CDVDVideoCodecIMXBuffer;
 class CMMALBuffer;
 class CDVDAmlogicInfo;
@@ -185,6 +186,14 @@ public:
    */
   virtual int Decode(uint8_t* pData, int iSize, double dts, double pts) = 0;
 
+  /**
+   * Decode a demux packet that may carry several payload segments
+   * (DemuxPacket::pNext). Decoders which can feed the segments one by one
+   * override this, by default they are gathered into one buffer that is
+   * reused across calls and passed to Decode.
+   */
+  virtual int DecodePacket(DemuxPacket* pPacket);
+
   /**
    * Reset the decoder.
    * Should be the same as calling Dispose and Open after each other
@@ -313,4 +322,7 @@ public:
 
 protected:
   CProcessInfo &m_processInfo;
+
+private:
+  std::vector<uint8_t> m_segmentBuffer;
 };
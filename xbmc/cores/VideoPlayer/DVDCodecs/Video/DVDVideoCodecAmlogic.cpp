@@ -24,6 +24,7 @@
 #include "DVDClock.h"
 #include "DVDStreamInfo.h"
 #include "AMLCodec.h"
+#include "DVDDemuxers/DVDDemuxPacket.h"
 #include "utils/AMLUtils.h"
 #include "utils/BitstreamConverter.h"
 #include "utils/log.h"
@@ -257,6 +258,22 @@ void CDVDVideoCodecAmlogic::Dispose(void)
 }
 
 int CDVDVideoCodecAmlogic::Decode(uint8_t *pData, int iSize, double dts, double pts)
+{
+  return DecodeSegments(pData, iSize, dts, pts, NULL);
+}
+
+int CDVDVideoCodecAmlogic::DecodePacket(DemuxPacket* pPacket)
+{
+  // the bitstream converter needs the whole access unit in one buffer
+  if (m_bitstream)
+    return CDVDVideoCodec::DecodePacket(pPacket);
+
+  // otherwise further segments (SSIF MVC extension) are written to the
+  // hw decoder right after the first one, without merging them first
+  return DecodeSegments(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts, pPacket->pNext);
+}
+
+int CDVDVideoCodecAmlogic::DecodeSegments(uint8_t *pData, int iSize, double dts, double pts, const DemuxPacket *pSegments)
 {
   // Handle Input, add demuxer packet to input queue, we must accept it or
   // it will be discarded as VideoPlayerVideo has no concept of "try again".
@@ -287,7 +304,7 @@ int CDVDVideoCodecAmlogic::Decode(uint8_t *pData, int iSize, double dts, double
   if (m_hints.ptsinvalid)
     pts = DVD_NOPTS_VALUE;
 
-  return m_Codec->Decode(pData, iSize, dts, pts);
+  return m_Codec->Decode(pData, iSize, dts, pts, pSegments);
 }
 
 void CDVDVideoCodecAmlogic::Reset(void)
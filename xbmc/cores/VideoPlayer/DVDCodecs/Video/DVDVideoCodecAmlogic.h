@@ -66,6 +66,7 @@ public:
   // Required overrides
   virtual bool Open(CDVDStreamInfo &hints, CDVDCodecOptions &options);
   virtual int  Decode(uint8_t *pData, int iSize, double dts, double pts);
+  virtual int  DecodePacket(DemuxPacket* pPacket);
   virtual void Reset(void);
   virtual bool GetPicture(DVDVideoPicture *pDvdVideoPicture);
   virtual bool ClearPicture(DVDVideoPicture* pDvdVideoPicture);
@@ -76,6 +77,7 @@ public:
   virtual const char* GetName(void) { return (const char*)m_pFormatName; }
 
 protected:
+  int             DecodeSegments(uint8_t *pData, int iSize, double dts, double pts, const DemuxPacket *pSegments);
   void            Dispose(void);
   void            FrameQueuePop(void);
   void            FrameQueuePush(double dts, double pts);
@@ -41,4 +41,9 @@ typedef struct DemuxPacket
   AVPacket *pkt; // to allow packet to be freed
 
   int dispTime;
+
+  // further payload segments of the same access unit (e.g. the MVC
+  // extension of an SSIF frame), each described by its own pData/iSize.
+  // Segments are owned and freed by the head packet.
+  struct DemuxPacket *pNext;
 } DemuxPacket;
@@ -0,0 +1,184 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxPacketPool.h"
+#include "threads/SingleLock.h"
+#include <cstring>
+
+#ifdef TARGET_POSIX
+#include "linux/XMemUtils.h"
+#endif
+
+// size classes are powers of two from 1 KiB up to 4 MiB
+#define POOL_MIN_CLASS_SHIFT 10
+#define POOL_NUM_CLASSES 13
+// upper bound for memory parked in the pool
+#define POOL_MAX_RETAINED_BYTES (16 * 1024 * 1024)
+#define POOL_MAX_PACKETS 1024
+
+namespace
+{
+// lives in front of every payload buffer, keeps pData 16 byte aligned
+struct DataHeader
+{
+  int32_t sizeClass;
+  int32_t capacity;
+  uint8_t reserved[8];
+};
+static_assert(sizeof(DataHeader) == 16, "payload header must keep the 16 byte alignment");
+}
+
+CDVDDemuxPacketPool& CDVDDemuxPacketPool::GetInstance()
+{
+  static CDVDDemuxPacketPool instance;
+  return instance;
+}
+
+CDVDDemuxPacketPool::CDVDDemuxPacketPool()
+{
+  m_classes = new SizeClass[POOL_NUM_CLASSES];
+  m_retainedBytes = 0;
+  m_hits = 0;
+  m_misses = 0;
+}
+
+CDVDDemuxPacketPool::~CDVDDemuxPacketPool()
+{
+  Trim();
+  delete[] m_classes;
+}
+
+int CDVDDemuxPacketPool::GetSizeClass(int size)
+{
+  int sizeClass = 0;
+  while (sizeClass < POOL_NUM_CLASSES && (1 << (POOL_MIN_CLASS_SHIFT + sizeClass)) < size)
+    sizeClass++;
+
+  return sizeClass < POOL_NUM_CLASSES ? sizeClass : -1;
+}
+
+DemuxPacket* CDVDDemuxPacketPool::AllocatePacket()
+{
+  DemuxPacket* packet = NULL;
+  {
+    CSingleLock lock(m_packetSection);
+    if (!m_packets.empty())
+    {
+      packet = m_packets.back();
+      m_packets.pop_back();
+    }
+  }
+
+  if (!packet)
+    packet = new DemuxPacket;
+
+  memset(packet, 0, sizeof(DemuxPacket));
+  return packet;
+}
+
+void CDVDDemuxPacketPool::ReleasePacket(DemuxPacket* packet)
+{
+  {
+    CSingleLock lock(m_packetSection);
+    if (m_packets.size() < POOL_MAX_PACKETS)
+    {
+      m_packets.push_back(packet);
+      return;
+    }
+  }
+  delete packet;
+}
+
+uint8_t* CDVDDemuxPacketPool::AllocateData(int size)
+{
+  int sizeClass = GetSizeClass(size);
+  uint8_t* base = NULL;
+
+  if (sizeClass >= 0)
+  {
+    SizeClass& entry = m_classes[sizeClass];
+    CSingleLock lock(entry.section);
+    if (!entry.buffers.empty())
+    {
+      base = entry.buffers.back();
+      entry.buffers.pop_back();
+      m_retainedBytes -= reinterpret_cast<DataHeader*>(base)->capacity;
+    }
+  }
+
+  if (base)
+    m_hits++;
+  else
+  {
+    m_misses++;
+
+    int capacity = sizeClass >= 0 ? 1 << (POOL_MIN_CLASS_SHIFT + sizeClass) : size;
+    base = (uint8_t*)_aligned_malloc(sizeof(DataHeader) + capacity, 16);
+    if (!base)
+      return NULL;
+
+    DataHeader* header = reinterpret_cast<DataHeader*>(base);
+    header->sizeClass = sizeClass;
+    header->capacity = capacity;
+  }
+
+  return base + sizeof(DataHeader);
+}
+
+void CDVDDemuxPacketPool::ReleaseData(uint8_t* data)
+{
+  if (!data)
+    return;
+
+  uint8_t* base = data - sizeof(DataHeader);
+  DataHeader* header = reinterpret_cast<DataHeader*>(base);
+
+  if (header->sizeClass >= 0 &&
+      m_retainedBytes + header->capacity <= POOL_MAX_RETAINED_BYTES)
+  {
+    SizeClass& entry = m_classes[header->sizeClass];
+    CSingleLock lock(entry.section);
+    entry.buffers.push_back(base);
+    m_retainedBytes += header->capacity;
+    return;
+  }
+
+  _aligned_free(base);
+}
+
+void CDVDDemuxPacketPool::Trim()
+{
+  for (int i = 0; i < POOL_NUM_CLASSES; i++)
+  {
+    SizeClass& entry = m_classes[i];
+    CSingleLock lock(entry.section);
+    for (auto base : entry.buffers)
+    {
+      m_retainedBytes -= reinterpret_cast<DataHeader*>(base)->capacity;
+      _aligned_free(base);
+    }
+    entry.buffers.clear();
+  }
+
+  CSingleLock lock(m_packetSection);
+  for (auto packet : m_packets)
+    delete packet;
+  m_packets.clear();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxPacket.h"
+#include "threads/CriticalSection.h"
+#include <atomic>
+#include <vector>
+
+/**
+ * Recycles DemuxPacket structs and their padded payload buffers.
+ *
+ * Payloads are kept in power of two size classes. Every buffer handed out
+ * carries a small header in front of pData that records its size class, so
+ * it can be given back from whichever thread finally frees the packet
+ * (usually a codec, long after the demuxer that produced it went away).
+ * The number of retained bytes is capped, anything above that goes back
+ * to the heap.
+ */
+class CDVDDemuxPacketPool
+{
+public:
+  static CDVDDemuxPacketPool& GetInstance();
+
+  DemuxPacket* AllocatePacket();
+  void ReleasePacket(DemuxPacket* packet);
+
+  /**
+   * returns a 16 byte aligned buffer holding at least size bytes, the
+   * caller takes care of the input padding
+   */
+  uint8_t* AllocateData(int size);
+  void ReleaseData(uint8_t* data);
+
+  /**
+   * give all retained buffers back to the heap
+   */
+  void Trim();
+
+  uint64_t GetHits() const { return m_hits; }
+  uint64_t GetMisses() const { return m_misses; }
+
+private:
+  CDVDDemuxPacketPool();
+  ~CDVDDemuxPacketPool();
+  CDVDDemuxPacketPool(const CDVDDemuxPacketPool&) = delete;
+  CDVDDemuxPacketPool& operator=(const CDVDDemuxPacketPool&) = delete;
+
+  static int GetSizeClass(int size);
+
+  struct SizeClass
+  {
+    CCriticalSection section;
+    std::vector<uint8_t*> buffers;
+  };
+
+  SizeClass* m_classes;
+  std::atomic<int64_t> m_retainedBytes;
+
+  CCriticalSection m_packetSection;
+  std::vector<DemuxPacket*> m_packets;
+
+  std::atomic<uint64_t> m_hits;
+  std::atomic<uint64_t> m_misses;
+};
@@ -61,21 +61,15 @@ void CDVDDemuxStreamSSIF::Flush()
 
 DemuxPacket* CDVDDemuxStreamSSIF::MergePacket(DemuxPacket* &srcPkt, DemuxPacket* &appendPkt)
 {
-  DemuxPacket* newpkt = NULL;
-  newpkt = CDVDDemuxUtils::AllocateDemuxPacket(srcPkt->iSize + appendPkt->iSize);
-  newpkt->iSize = srcPkt->iSize + appendPkt->iSize;
-
-  newpkt->pts = srcPkt->pts;
-  newpkt->dts = srcPkt->dts;
-  newpkt->duration = srcPkt->duration;
-  newpkt->iGroupId = srcPkt->iGroupId;
-  newpkt->iStreamId = srcPkt->iStreamId;
-  memcpy(newpkt->pData, srcPkt->pData, srcPkt->iSize);
-  memcpy(newpkt->pData + srcPkt->iSize, appendPkt->pData, appendPkt->iSize);
-
-  CDVDDemuxUtils::FreeDemuxPacket(srcPkt);
+  // no copy, the appended packet becomes a payload segment of the source
+  // packet. timestamps, group and stream id are the ones of srcPkt.
+  DemuxPacket* newpkt = srcPkt;
+  DemuxPacket* tail = newpkt;
+  while (tail->pNext)
+    tail = tail->pNext;
+  tail->pNext = appendPkt;
+
   srcPkt = NULL;
-  CDVDDemuxUtils::FreeDemuxPacket(appendPkt);
   appendPkt = NULL;
 
   return newpkt;
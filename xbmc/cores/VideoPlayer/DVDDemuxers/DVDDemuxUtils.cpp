@@ -22,46 +22,44 @@
   #include "config.h"
 #endif
 #include "DVDDemuxUtils.h"
+#include "DVDDemuxPacketPool.h"
 #include "DVDClock.h"
 #include "utils/log.h"
 #include "system.h"
 
-#ifdef TARGET_POSIX
-#include "linux/XMemUtils.h"
-#endif
-
 extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
-  if (pPacket)
+  while (pPacket)
   {
+    DemuxPacket* pNext = pPacket->pNext;
     try {
       if (pPacket->pkt)
       {
         av_free_packet(pPacket->pkt);
         delete pPacket->pkt;
       }
-      else if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      else if (pPacket->pData)
+        CDVDDemuxPacketPool::GetInstance().ReleaseData(pPacket->pData);
+      CDVDDemuxPacketPool::GetInstance().ReleasePacket(pPacket);
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
     }
+    pPacket = pNext;
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
+  DemuxPacket* pPacket = CDVDDemuxPacketPool::GetInstance().AllocatePacket();
   if (!pPacket) return NULL;
 
   try
   {
-    memset(pPacket, 0, sizeof(DemuxPacket));
-
     if (iDataSize > 0)
     {
       // need to allocate a few bytes more.
@@ -73,7 +71,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
         * Note, if the first 23 bits of the additional bytes are not 0 then damaged
         * MPEG bitstreams could cause overread and segfault
         */
-      pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      pPacket->pData = CDVDDemuxPacketPool::GetInstance().AllocateData(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE);
       if (!pPacket->pData)
       {
         FreeDemuxPacket(pPacket);
@@ -98,3 +96,29 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
   }
   return pPacket;
 }
+
+int CDVDDemuxUtils::GetDemuxPacketSize(const DemuxPacket* pPacket)
+{
+  int size = 0;
+  for (; pPacket; pPacket = pPacket->pNext)
+    size += pPacket->iSize;
+  return size;
+}
+
+int CDVDDemuxUtils::GatherDemuxPacket(const DemuxPacket* pPacket, std::vector<uint8_t> &buffer)
+{
+  int size = GetDemuxPacketSize(pPacket);
+  if (buffer.size() < (size_t)(size + FF_INPUT_BUFFER_PADDING_SIZE))
+    buffer.resize(size + FF_INPUT_BUFFER_PADDING_SIZE);
+
+  uint8_t* dst = buffer.data();
+  for (; pPacket; pPacket = pPacket->pNext)
+  {
+    if (pPacket->iSize > 0)
+      memcpy(dst, pPacket->pData, pPacket->iSize);
+    dst += pPacket->iSize;
+  }
+  memset(dst, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+
+  return size;
+}
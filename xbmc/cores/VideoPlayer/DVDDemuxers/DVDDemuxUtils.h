@@ -21,11 +21,24 @@
  */
 
 #include "DVDDemuxPacket.h"
+#include <vector>
 
 class CDVDDemuxUtils
 {
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+
+  /**
+   * total payload size of a packet including all of its segments
+   */
+  static int GetDemuxPacketSize(const DemuxPacket* pPacket);
+
+  /**
+   * copies all segments of a packet into one contiguous, padded buffer
+   * for consumers that can't handle segmented packets. buffer is reused
+   * between calls, returns the payload size.
+   */
+  static int GatherDemuxPacket(const DemuxPacket* pPacket, std::vector<uint8_t> &buffer);
 };
 
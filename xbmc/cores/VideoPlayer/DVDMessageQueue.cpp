@@ -20,21 +20,29 @@
 
 #include "DVDMessageQueue.h"
 #include "DVDDemuxers/DVDDemuxPacket.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
 #include "utils/log.h"
 #include "threads/SingleLock.h"
 #include "DVDClock.h"
 #include "math.h"
 
+#define MSGQ_RING_INITIAL_SIZE 1024
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
   m_bAbortRequest = false;
   m_bInitialized = false;
+  m_bConsumerWaiting = false;
 
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
   m_TimeSize = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize = 0;
+
+  m_ring.resize(MSGQ_RING_INITIAL_SIZE, NULL);
+  m_head = 0;
+  m_tail = 0;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
@@ -55,10 +63,23 @@ void CDVDMessageQueue::Init()
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
-
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  CSingleLock consumerLock(m_consumerSection);
+
+  // compact the ring in place, keeping the order of the remaining messages
+  const size_t mask = m_ring.size() - 1;
+  const size_t head = m_head;
+  const size_t tail = m_tail;
+  size_t write = head;
+  for (size_t read = head; read != tail; read++)
+  {
+    CDVDMsg* msg = m_ring[read & mask];
+    m_ring[read & mask] = NULL;
+    if (type == CDVDMsg::NONE || msg->IsType(type))
+      msg->Release();
+    else
+      m_ring[write++ & mask] = msg;
+  }
+  m_tail = write;
 
   m_prioMessages.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
@@ -74,8 +95,6 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 
 void CDVDMessageQueue::Abort()
 {
-  CSingleLock lock(m_section);
-
   m_bAbortRequest = true;
 
   // inform waiter for abort action
@@ -85,6 +104,7 @@ void CDVDMessageQueue::Abort()
 void CDVDMessageQueue::End()
 {
   CSingleLock lock(m_section);
+  CSingleLock consumerLock(m_consumerSection);
 
   Flush(CDVDMsg::NONE);
 
@@ -95,14 +115,6 @@ void CDVDMessageQueue::End()
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
 {
-  CSingleLock lock(m_section);
-
-  if (!m_bInitialized)
-  {
-    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
-    pMsg->Release();
-    return MSGQ_NOT_INITIALIZED;
-  }
   if (!pMsg)
   {
     CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
@@ -111,6 +123,16 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
 
   if (priority > 0)
   {
+    // priority messages are rare, they only need to synchronize with the consumer
+    CSingleLock consumerLock(m_consumerSection);
+
+    if (!m_bInitialized)
+    {
+      CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
+      pMsg->Release();
+      return MSGQ_NOT_INITIALIZED;
+    }
+
     int prio = priority;
     if (!front)
       prio++;
@@ -120,43 +142,52 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
                              return prio <= item.priority;
                            });
     m_prioMessages.emplace(it, pMsg, priority);
+    pMsg->Release();
   }
   else
   {
+    CSingleLock lock(m_section);
+
+    if (!m_bInitialized)
+    {
+      CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
+      pMsg->Release();
+      return MSGQ_NOT_INITIALIZED;
+    }
+
+    if (m_tail - m_head == m_ring.size())
+      GrowRing();
+
+    // account before publishing, the consumer may take the message right away
+    PushPacketStats(pMsg);
+
+    // the reference passed in by the caller is handed over to the ring
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+    {
+      // common path: append for the consumer, no lock shared with Get
+      const size_t tail = m_tail.load(std::memory_order_relaxed);
+      m_ring[tail & (m_ring.size() - 1)] = pMsg;
+      m_tail = tail + 1;
+    }
     else
-      m_messages.emplace_back(pMsg, priority);
-  }
-
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
-  {
-    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
-    if (packet)
     {
-      m_iDataSize += packet->iSize;
-      if (packet->dts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->dts;
-      else if (packet->pts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->pts;
-
-      if (m_TimeBack == DVD_NOPTS_VALUE)
-        m_TimeBack = m_TimeFront;
+      // message should be the next one returned, insert at the consumer's end
+      CSingleLock consumerLock(m_consumerSection);
+      const size_t head = m_head - 1;
+      m_ring[head & (m_ring.size() - 1)] = pMsg;
+      m_head = head;
     }
   }
 
-  pMsg->Release();
-
   // inform waiter for new packet
-  m_hEvent.Set();
+  if (m_bConsumerWaiting)
+    m_hEvent.Set();
 
   return MSGQ_OK;
 }
 
 MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
 {
-  CSingleLock lock(m_section);
-
   *pMsg = NULL;
 
   int ret = 0;
@@ -169,29 +200,8 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
-
-    if (!msgs.empty() && msgs.back().priority >= priority)
+    if (PopMessage(pMsg, priority))
     {
-      DVDMessageListItem& item(msgs.back());
-      priority = item.priority;
-
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
-      {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-        if (packet)
-        {
-          m_iDataSize -= packet->iSize;
-          if (packet->dts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->dts;
-          else if (packet->pts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->pts;
-        }
-      }
-
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
-
       ret = MSGQ_OK;
       break;
     }
@@ -200,17 +210,29 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
       ret = MSGQ_TIMEOUT;
       break;
     }
-    else
-    {
-      m_hEvent.Reset();
-      lock.Leave();
 
-      // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
+    // announce that we are about to sleep, then check once more so that
+    // a message put in between is not missed
+    m_bConsumerWaiting = true;
+    m_hEvent.Reset();
 
-      lock.Enter();
+    if (m_bAbortRequest)
+    {
+      m_bConsumerWaiting = false;
+      break;
+    }
+    if (PopMessage(pMsg, priority))
+    {
+      m_bConsumerWaiting = false;
+      ret = MSGQ_OK;
+      break;
     }
+
+    // wait for a new message
+    bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+    m_bConsumerWaiting = false;
+    if (!signaled)
+      return MSGQ_TIMEOUT;
   }
 
   if (m_bAbortRequest)
@@ -219,17 +241,107 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
   return (MsgQueueReturnCode)ret;
 }
 
+bool CDVDMessageQueue::PopMessage(CDVDMsg** pMsg, int &priority)
+{
+  CSingleLock consumerLock(m_consumerSection);
+
+  if (priority > 0 || !m_prioMessages.empty())
+  {
+    if (m_prioMessages.empty() || m_prioMessages.back().priority < priority)
+      return false;
+
+    DVDMessageListItem& item(m_prioMessages.back());
+    priority = item.priority;
+    *pMsg = item.message->Acquire();
+    m_prioMessages.pop_back();
+    return true;
+  }
+
+  const size_t head = m_head.load(std::memory_order_relaxed);
+  if (head == m_tail)
+    return false;
+
+  CDVDMsg*& slot = m_ring[head & (m_ring.size() - 1)];
+  CDVDMsg* msg = slot;
+  slot = NULL;
+  m_head = head + 1;
+
+  PopPacketStats(msg);
+
+  priority = 0;
+  *pMsg = msg;
+  return true;
+}
+
+void CDVDMessageQueue::PushPacketStats(CDVDMsg* pMsg)
+{
+  if (!pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return;
+
+  DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+  if (!packet)
+    return;
+
+  m_iDataSize += CDVDDemuxUtils::GetDemuxPacketSize(packet);
+  if (packet->dts != DVD_NOPTS_VALUE)
+    m_TimeFront = packet->dts;
+  else if (packet->pts != DVD_NOPTS_VALUE)
+    m_TimeFront = packet->pts;
+
+  double nopts = DVD_NOPTS_VALUE;
+  m_TimeBack.compare_exchange_strong(nopts, m_TimeFront.load());
+}
+
+void CDVDMessageQueue::PopPacketStats(CDVDMsg* pMsg)
+{
+  if (!pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return;
+
+  DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+  if (!packet)
+    return;
+
+  m_iDataSize -= CDVDDemuxUtils::GetDemuxPacketSize(packet);
+  if (packet->dts != DVD_NOPTS_VALUE)
+    m_TimeBack = packet->dts;
+  else if (packet->pts != DVD_NOPTS_VALUE)
+    m_TimeBack = packet->pts;
+}
+
+void CDVDMessageQueue::GrowRing()
+{
+  // called with m_section held, the ring is full
+  CSingleLock consumerLock(m_consumerSection);
+
+  const size_t mask = m_ring.size() - 1;
+  const size_t head = m_head;
+  const size_t tail = m_tail;
+
+  std::vector<CDVDMsg*> ring(m_ring.size() * 2, NULL);
+  size_t count = 0;
+  for (size_t i = head; i != tail; i++)
+    ring[count++] = m_ring[i & mask];
+
+  m_ring.swap(ring);
+  m_head = 0;
+  m_tail = count;
+
+  CLog::Log(LOGDEBUG, "CDVDMessageQueue(%s)::GrowRing - %u slots", m_owner.c_str(), (unsigned)m_ring.size());
+}
+
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
+  CSingleLock consumerLock(m_consumerSection);
 
   if (!m_bInitialized)
     return 0;
 
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  const size_t mask = m_ring.size() - 1;
+  for (size_t i = m_head; i != m_tail; i++)
   {
-    if(item.message->IsType(type))
+    if(m_ring[i & mask]->IsType(type))
       count++;
   }
   for (const auto &item : m_prioMessages)
@@ -252,20 +364,23 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
-  CSingleLock lock(m_section);
+  // lock free, the demuxer polls this for every packet
+  const int dataSize = m_iDataSize;
+  const double timeFront = m_TimeFront;
+  const double timeBack = m_TimeBack;
 
-  if (m_iDataSize > m_iMaxDataSize)
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize == 0)
     return 0;
 
-  if (IsDataBased())
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+  if (timeBack == DVD_NOPTS_VALUE || timeFront == DVD_NOPTS_VALUE || timeFront <= timeBack)
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
 
-  int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
+  int level = std::min(100.0, ceil(100.0 * m_TimeSize * (timeFront - timeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
@@ -276,17 +391,21 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  CSingleLock lock(m_section);
+  const double timeFront = m_TimeFront;
+  const double timeBack = m_TimeBack;
 
-  if (IsDataBased())
+  if (timeBack == DVD_NOPTS_VALUE || timeFront == DVD_NOPTS_VALUE || timeFront <= timeBack)
     return 0;
   else
-    return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
+    return (int)((timeFront - timeBack) / DVD_TIME_BASE);
 }
 
 bool CDVDMessageQueue::IsDataBased() const
 {
-  return (m_TimeBack == DVD_NOPTS_VALUE  ||
-          m_TimeFront == DVD_NOPTS_VALUE ||
-          m_TimeFront <= m_TimeBack);
+  const double timeFront = m_TimeFront;
+  const double timeBack = m_TimeBack;
+
+  return (timeBack == DVD_NOPTS_VALUE  ||
+          timeFront == DVD_NOPTS_VALUE ||
+          timeFront <= timeBack);
 }
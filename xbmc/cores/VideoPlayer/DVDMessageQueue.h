@@ -24,6 +24,7 @@
 #include <atomic>
 #include <string>
 #include <list>
+#include <vector>
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
@@ -109,21 +110,42 @@ public:
 
 private:
 
+  bool PopMessage(CDVDMsg** pMsg, int &priority);
+  void PushPacketStats(CDVDMsg* pMsg);
+  void PopPacketStats(CDVDMsg* pMsg);
+  void GrowRing();
+
   CEvent m_hEvent;
+
+  /**
+   * Put and Get do not share a lock: producers serialize on m_section and
+   * the consumer on m_consumerSection. Operations touching both ends of
+   * the queue (Flush, End, out of order inserts, growing the ring) take
+   * m_section first, then m_consumerSection.
+   */
   mutable CCriticalSection m_section;
+  mutable CCriticalSection m_consumerSection;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
+  std::atomic<bool> m_bInitialized;
+  std::atomic<bool> m_bConsumerWaiting;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
+  // normal lane, preallocated ring of acquired messages. m_head and m_tail
+  // are free running counters, the slot is the counter masked by the
+  // (power of two) ring size. Producers append at m_tail, the consumer
+  // takes from m_head.
+  std::vector<CDVDMsg*> m_ring;
+  std::atomic<size_t> m_head;
+  std::atomic<size_t> m_tail;
+
+  // priority lane, guarded by m_consumerSection
   std::list<DVDMessageListItem> m_prioMessages;
 };
-
@@ -344,3 +344,20 @@ void CProcessInfo::UpdateRenderInfo(CRenderInfo &info)
       m_deintMethods.push_back(deint);
   }
 }
+
+// demuxer info
+void CProcessInfo::SetDemuxPacketPoolStats(uint64_t hits, uint64_t misses)
+{
+  CSingleLock lock(m_demuxSection);
+
+  m_demuxPoolHits = hits;
+  m_demuxPoolMisses = misses;
+}
+
+void CProcessInfo::GetDemuxPacketPoolStats(uint64_t &hits, uint64_t &misses)
+{
+  CSingleLock lock(m_demuxSection);
+
+  hits = m_demuxPoolHits;
+  misses = m_demuxPoolMisses;
+}
@@ -70,6 +70,10 @@ public:
   bool IsRenderClockSync();
   void UpdateRenderInfo(CRenderInfo &info);
 
+  // demuxer info
+  void SetDemuxPacketPoolStats(uint64_t hits, uint64_t misses);
+  void GetDemuxPacketPoolStats(uint64_t &hits, uint64_t &misses);
+
 protected:
   CProcessInfo();
 
@@ -97,4 +101,9 @@ protected:
   CCriticalSection m_renderSection;
   bool m_isClockSync;
   CRenderInfo m_renderInfo;
+
+  // demuxer info
+  CCriticalSection m_demuxSection;
+  uint64_t m_demuxPoolHits = 0;
+  uint64_t m_demuxPoolMisses = 0;
 };
@@ -29,6 +29,7 @@
 
 #include "DVDDemuxers/DVDDemux.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDDemuxPacketPool.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
@@ -135,8 +136,8 @@ static void dump_packet(DemuxPacket *packet, bool video, bool audio)
       packet->iSize = p.iSize;
       packet->dts = p.dts;
       packet->pts = p.pts;
-      _aligned_free(packet->pData);
-      packet->pData = (uint8_t*)_aligned_malloc(packet->iSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      CDVDDemuxPacketPool::GetInstance().ReleaseData(packet->pData);
+      packet->pData = CDVDDemuxPacketPool::GetInstance().AllocateData(packet->iSize + FF_INPUT_BUFFER_PADDING_SIZE);
       fread(packet->pData, packet->iSize, 1, fp);
     }
 #else
@@ -2538,6 +2539,12 @@ void CVideoPlayer::OnExit()
 
     m_messenger.End();
 
+    // hand pooled demux packets back to the heap
+    CDVDDemuxPacketPool& packetPool = CDVDDemuxPacketPool::GetInstance();
+    CLog::Log(LOGDEBUG, "CVideoPlayer::OnExit() - demux packet pool hits: %" PRIu64 " misses: %" PRIu64,
+              packetPool.GetHits(), packetPool.GetMisses());
+    packetPool.Trim();
+
     if (m_omxplayer_mode)
     {
       m_OmxPlayerState.av_clock.OMXStop();
@@ -4940,6 +4947,9 @@ void CVideoPlayer::UpdatePlayState(double timeout)
     state.canseek = m_pInputStream->CanSeek();
   }
 
+  CDVDDemuxPacketPool& packetPool = CDVDDemuxPacketPool::GetInstance();
+  m_processInfo->SetDemuxPacketPoolStats(packetPool.GetHits(), packetPool.GetMisses());
+
   if (m_Edl.HasCut())
   {
     state.time        = (double) m_Edl.RemoveCutTime(llrint(state.time));
@@ -32,6 +32,7 @@
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
 #include "DVDDemuxers/DVDDemux.h"
 #include "DVDDemuxers/DVDDemuxPacket.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
 #include "guilib/GraphicContext.h"
 #include <sstream>
 #include <iomanip>
@@ -469,7 +470,7 @@ void CVideoPlayerVideo::Process()
       // decoder still needs to provide an empty image structure, with correct flags
       m_pVideoCodec->SetDropState(bRequestDrop);
 
-      int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      int iDecoderState = m_pVideoCodec->DecodePacket(pPacket);
 
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
@@ -480,7 +481,7 @@ void CVideoPlayerVideo::Process()
           m_packets.pop_front();
       }
 
-      m_videoStats.AddSampleBytes(pPacket->iSize);
+      m_videoStats.AddSampleBytes(CDVDDemuxUtils::GetDemuxPacketSize(pPacket));
 
       // reset the request, the following while loop may break before
       // setting the flag to a new value
@@ -22,6 +22,7 @@
 #include "RenderManager.h"
 #include "RenderFlags.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITexture.h"
 #include "utils/MathUtils.h"
 #include "threads/SingleLock.h"
 #include "utils/CPUInfo.h"
@@ -868,6 +869,9 @@ RESOLUTION CRenderManager::GetResolution()
 
 void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 {
+  // the GUI drawn so far goes below the video
+  CGUITexture::FlushBatch();
+
   CSingleExit exitLock(g_graphicsContext);
 
   {
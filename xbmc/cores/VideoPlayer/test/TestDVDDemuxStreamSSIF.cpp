@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDClock.h"
+#include "DVDDemuxers/DVDDemuxStreamSSIF.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+#define SSIF_H264_STREAM 0
+#define SSIF_MVC_STREAM  1
+
+namespace
+{
+struct TraceEntry
+{
+  int baseSize;
+  int extSize;
+};
+
+// packet sizes of a 40 Mbit/s 3D title, one GOP of I/P/B frames with an
+// MVC extension of roughly 60% of the base view
+std::vector<TraceEntry> CreateTrace(int frames)
+{
+  static const int gop[] = { 420000, 40000, 38000, 150000, 41000, 39000, 140000, 42000, 37000 };
+  std::vector<TraceEntry> trace;
+  for (int i = 0; i < frames; i++)
+  {
+    int base = gop[i % (sizeof(gop) / sizeof(gop[0]))] + (i * 7919) % 4096;
+    trace.push_back({ base, base * 6 / 10 });
+  }
+  return trace;
+}
+
+DemuxPacket* CreatePacket(int streamId, int size, double dts, uint8_t fill)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->iStreamId = streamId;
+  packet->dts = dts;
+  packet->pts = dts;
+  memset(packet->pData, fill, size);
+  return packet;
+}
+}
+
+TEST(TestDVDDemuxStreamSSIF, MergeKeepsSegments)
+{
+  CDVDDemuxStreamSSIF ssif;
+  ssif.SetH264StreamId(SSIF_H264_STREAM);
+  ssif.SetMVCStreamId(SSIF_MVC_STREAM);
+
+  DemuxPacket* base = CreatePacket(SSIF_H264_STREAM, 1000, DVD_MSEC_TO_TIME(40), 0xAA);
+  DemuxPacket* fragment = CreatePacket(SSIF_H264_STREAM, 200, DVD_NOPTS_VALUE, 0xBB);
+  DemuxPacket* ext = CreatePacket(SSIF_MVC_STREAM, 600, DVD_MSEC_TO_TIME(40), 0xCC);
+  DemuxPacket* next = CreatePacket(SSIF_H264_STREAM, 10, DVD_MSEC_TO_TIME(80), 0xDD);
+
+  // nothing can be merged until the extension arrives
+  DemuxPacket* out = ssif.AddPacket(base);
+  EXPECT_EQ(0, out->iSize);
+  CDVDDemuxUtils::FreeDemuxPacket(out);
+  out = ssif.AddPacket(fragment);
+  CDVDDemuxUtils::FreeDemuxPacket(out);
+  out = ssif.AddPacket(next);
+  CDVDDemuxUtils::FreeDemuxPacket(out);
+
+  out = ssif.AddPacket(ext);
+  ASSERT_TRUE(out != NULL);
+  EXPECT_EQ(SSIF_H264_STREAM, out->iStreamId);
+  EXPECT_EQ(DVD_MSEC_TO_TIME(40), out->dts);
+  EXPECT_EQ(1000, out->iSize);
+  EXPECT_EQ(1800, CDVDDemuxUtils::GetDemuxPacketSize(out));
+
+  std::vector<uint8_t> gathered;
+  ASSERT_EQ(1800, CDVDDemuxUtils::GatherDemuxPacket(out, gathered));
+  EXPECT_EQ(0xAA, gathered[0]);
+  EXPECT_EQ(0xAA, gathered[999]);
+  EXPECT_EQ(0xBB, gathered[1000]);
+  EXPECT_EQ(0xCC, gathered[1200]);
+  EXPECT_EQ(0xCC, gathered[1799]);
+
+  CDVDDemuxUtils::FreeDemuxPacket(out);
+}
+
+TEST(TestDVDDemuxStreamSSIF, ReplayTrace)
+{
+  std::vector<TraceEntry> trace = CreateTrace(1800);
+  CDVDDemuxStreamSSIF ssif;
+  ssif.SetH264StreamId(SSIF_H264_STREAM);
+  ssif.SetMVCStreamId(SSIF_MVC_STREAM);
+
+  int64_t bytes = 0;
+  int64_t segmentBytes = 0;
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    double dts = DVD_MSEC_TO_TIME(40 * i);
+    DemuxPacket* base = CreatePacket(SSIF_H264_STREAM, trace[i].baseSize, dts, 1);
+    DemuxPacket* ext = CreatePacket(SSIF_MVC_STREAM, trace[i].extSize, dts, 2);
+    bytes += trace[i].baseSize + trace[i].extSize;
+
+    CDVDDemuxUtils::FreeDemuxPacket(ssif.AddPacket(base));
+    DemuxPacket* merged = ssif.AddPacket(ext);
+
+    ASSERT_TRUE(merged->pNext != NULL);
+    segmentBytes += CDVDDemuxUtils::GetDemuxPacketSize(merged);
+    CDVDDemuxUtils::FreeDemuxPacket(merged);
+  }
+
+  EXPECT_EQ(bytes, segmentBytes);
+}
@@ -429,13 +429,14 @@ void OMXPlayerVideo::Process()
 
       m_omxVideo.SetDropState(bRequestDrop);
 
+      int iPacketSize = CDVDDemuxUtils::GetDemuxPacketSize(pPacket);
       while (!m_bStop)
       {
         // discard if flushing as clocks may be stopped and we'll never submit it
         if (m_flush)
            break;
 
-        if((int)m_omxVideo.GetFreeSpace() < pPacket->iSize)
+        if((int)m_omxVideo.GetFreeSpace() < iPacketSize)
         {
           Sleep(10);
           continue;
@@ -458,7 +459,15 @@ void OMXPlayerVideo::Process()
         if (pts != DVD_NOPTS_VALUE)
           pts += iVideoDelay;
 
-        m_omxVideo.Decode(pPacket->pData, pPacket->iSize, dts, m_hints.ptsinvalid ? DVD_NOPTS_VALUE : pts, settings_changed);
+        uint8_t *pData = pPacket->pData;
+        if (pPacket->pNext)
+        {
+          // the decoder wants base and MVC view in one buffer
+          CDVDDemuxUtils::GatherDemuxPacket(pPacket, m_segmentBuffer);
+          pData = m_segmentBuffer.data();
+        }
+
+        m_omxVideo.Decode(pData, iPacketSize, dts, m_hints.ptsinvalid ? DVD_NOPTS_VALUE : pts, settings_changed);
 
         if (pts == DVD_NOPTS_VALUE)
           pts = dts;
@@ -484,7 +493,7 @@ void OMXPlayerVideo::Process()
 
       bRequestDrop = false;
 
-      m_videoStats.AddSampleBytes(pPacket->iSize);
+      m_videoStats.AddSampleBytes(iPacketSize);
     }
     pMsg->Release();
 
@@ -21,6 +21,7 @@
  */
 
 #include <deque>
+#include <vector>
 #include <sys/types.h>
 
 #include "OMXClock.h"
@@ -75,6 +76,7 @@ protected:
 
   BitstreamStats m_videoStats;
   CRenderManager& m_renderManager;
+  std::vector<uint8_t> m_segmentBuffer;  // gathered payload of segmented packets
 
   void ProcessOverlays(double pts);
   double NextOverlay(double pts);
@@ -28,6 +28,8 @@
 #include "utils/log.h"
 #include <math.h>
 
+#define MAX_DECODE_AHEAD_SIZE (32 * 1024 * 1024) /* pcm buffer limit when decoding ahead */
+
 CAudioDecoder::CAudioDecoder()
 {
   m_codec = NULL;
@@ -64,7 +66,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds)
 {
   Destroy();
 
@@ -100,8 +102,12 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_format.m_sampleRate);
+  /* allocate the pcmBuffer, 2 seconds of audio unless decoding ahead,
+   * which is limited in size for multichannel and high sample rates */
+  unsigned int bufferSize = 2 * blockSize * m_codec->m_format.m_sampleRate;
+  if (bufferSeconds > 2)
+    bufferSize = std::max(bufferSize, (unsigned int)std::min<uint64_t>((uint64_t)bufferSeconds * blockSize * m_codec->m_format.m_sampleRate, MAX_DECODE_AHEAD_SIZE));
+  m_pcmBuffer.Create(bufferSize);
 
   if (file.HasMusicInfoTag())
   {
@@ -190,6 +196,18 @@ unsigned int CAudioDecoder::GetDataSize()
   }
 }
 
+unsigned int CAudioDecoder::GetBufferedTime()
+{
+  if (!m_codec || m_codec->m_format.m_dataFormat == AE_FMT_RAW)
+    return 0;
+
+  unsigned int frameSize = (m_codec->m_bitsPerSample >> 3) * m_codec->m_format.m_channelLayout.Count();
+  if (!frameSize || !m_codec->m_format.m_sampleRate)
+    return 0;
+
+  return (unsigned int)((uint64_t)m_pcmBuffer.getMaxReadSize() / frameSize * 1000 / m_codec->m_format.m_sampleRate);
+}
+
 void *CAudioDecoder::GetData(unsigned int samples)
 {
   unsigned int size  = samples * (m_codec->m_bitsPerSample >> 3);
@@ -55,7 +55,7 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds = 2);
   void Destroy();
 
   int ReadSamples(int numsamples);
@@ -72,6 +72,7 @@ public:
   unsigned int GetChannels() { return GetFormat().m_channelLayout.Count(); }
   // Data management
   unsigned int GetDataSize();
+  unsigned int GetBufferedTime(); // decoded pcm data waiting in the buffer, in ms
   void *GetData(unsigned int samples);
   uint8_t* GetRawData(int &size);
   ICodec *GetCodec() const { return m_codec; }
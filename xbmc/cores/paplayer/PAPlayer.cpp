@@ -25,6 +25,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "music/tags/MusicInfoTag.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/JobManager.h"
 
@@ -66,6 +67,8 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_isFinished         (false),
   m_defaultCrossfadeMS (0),
   m_upcomingCrossfadeMS(0),
+  m_decodeAheadMS      (0),
+  m_stallStart         (0),
   m_currentStream      (NULL ),
   m_audioCallback      (NULL ),
   m_FileItem           (new CFileItem()),
@@ -241,6 +244,8 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
 bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
 {
   m_defaultCrossfadeMS = CSettings::GetInstance().GetInt(CSettings::SETTING_MUSICPLAYER_CROSSFADE) * 1000;
+  m_decodeAheadMS = g_advancedSettings.m_audioDecodeAhead * 1000;
+  m_stallStart = 0;
 
   if (m_streams.size() > 1 || !m_defaultCrossfadeMS || m_isPaused)
   {
@@ -343,7 +348,9 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
   }
 
   StreamInfo *si = new StreamInfo();
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
+  si->m_queueTime = XbmcThreads::SystemClockMillis();
+  /* only queued items decode ahead, the first one has to start right away */
+  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75, job ? m_decodeAheadMS / 1000 : 0))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -378,6 +385,25 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
     /* yield our time so that the main PAP thread doesnt stall */
     CThread::Sleep(1);
   }
+  si->m_readyTime = XbmcThreads::SystemClockMillis();
+
+  /* decode ahead of the transition so that a slow source can't stall it,
+   * we are running as a job here and don't hold up the PAP thread */
+  if (job && m_decodeAheadMS && si->m_decoder.GetFormat().m_dataFormat != AE_FMT_RAW)
+  {
+    while (!m_bStop && si->m_decoder.GetBufferedTime() < m_decodeAheadMS && !IsNextStreamDue())
+    {
+      int status = si->m_decoder.GetStatus();
+      if (status == STATUS_ENDING  ||
+          status == STATUS_ENDED   ||
+          status == STATUS_NO_FILE ||
+          si->m_decoder.ReadSamples(PACKET_SIZE) != RET_SUCCESS)
+        break;
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - First samples after %u ms, %u ms decoded ahead",
+            si->m_readyTime - si->m_queueTime, si->m_decoder.GetBufferedTime());
 
   // set m_upcomingCrossfadeMS depending on type of file and user settings
   UpdateCrossfadeTime(file);
@@ -407,7 +433,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
   if(!file.IsCDDA())
   {
     if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-      si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+      si->m_prepareNextAtFrame = GetPrepareNextAtFrame(si, streamTotalTime);
   }
 
   if (m_currentStream && ((m_currentStream->m_audioFormat.m_dataFormat == AE_FMT_RAW) || (si->m_audioFormat.m_dataFormat == AE_FMT_RAW)))
@@ -449,6 +475,30 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
   return true;
 }
 
+int PAPlayer::GetPrepareNextAtFrame(StreamInfo *si, int64_t streamTotalTime)
+{
+  /* streams shorter than the decode ahead time prepare the next one right after starting */
+  int64_t prepareAt = streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_decodeAheadMS - m_defaultCrossfadeMS;
+  return std::max(1, (int)(prepareAt * si->m_audioFormat.m_sampleRate / 1000.0f));
+}
+
+bool PAPlayer::IsNextStreamDue()
+{
+  /* a stream which has been queued late must not hold back the transition,
+   * stop decoding ahead once the current stream is gone or about to end */
+  CSingleLock lock(m_streamsLock);
+  StreamInfo *si = m_currentStream;
+  if (!si || !si->m_started || !si->m_audioFormat.m_sampleRate)
+    return true;
+
+  int64_t streamTotalTime = si->m_decoder.TotalTime() - si->m_startOffset;
+  if (si->m_endOffset)
+    streamTotalTime = si->m_endOffset - si->m_startOffset;
+  int64_t streamTime = (int64_t)si->m_framesSent * 1000 / si->m_audioFormat.m_sampleRate;
+
+  return streamTotalTime - streamTime <= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS;
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   // if no crossfading or cue sheet, wait for eof
@@ -662,6 +712,8 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
             si->m_prepareTriggered = true;
           }
           m_currentStream = NULL;
+          if (!m_isFinished)
+            m_stallStart = XbmcThreads::SystemClockMillis();
         }
         else
         {
@@ -726,6 +778,15 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       si->m_stream->Resume();
     si->m_stream->FadeVolume(0.0f, 1.0f, m_upcomingCrossfadeMS);
     m_callback.OnPlayBackStarted();
+
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    CLog::Log(LOGDEBUG, "PAPlayer::ProcessStream - Stream started, first samples after %u ms, ready %u ms before start",
+              si->m_readyTime - si->m_queueTime, now - si->m_readyTime);
+    if (m_stallStart)
+    {
+      CLog::Log(LOGWARNING, "PAPlayer::ProcessStream - Next stream was not ready, playback stalled for %u ms", now - m_stallStart);
+      m_stallStart = 0;
+    }
   }
 
   /* if we have not started yet and the stream has been primed */
@@ -789,7 +850,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       // calculate time when to prepare next stream
       si->m_prepareNextAtFrame = 0;
       if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-        si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+        si->m_prepareNextAtFrame = GetPrepareNextAtFrame(si, streamTotalTime);
 
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
@@ -121,6 +121,9 @@ private:
 
     bool m_isSlaved;                     /* true if the stream has been slaved to another */
     bool m_waitOnDrain;                  /* wait for stream being drained in AE */
+
+    unsigned int m_queueTime;            /* when queuing of the stream started, in ms */
+    unsigned int m_readyTime;            /* when the first samples had been decoded, in ms */
   } StreamInfo;
 
   typedef std::list<StreamInfo*> StreamList;
@@ -132,6 +135,8 @@ private:
   bool                m_isFinished;          /* if there are no more songs in the queue */
   unsigned int        m_defaultCrossfadeMS;  /* how long the default crossfade is in ms */
   unsigned int        m_upcomingCrossfadeMS; /* how long the upcoming crossfade is in ms */
+  unsigned int        m_decodeAheadMS;       /* how much of the next song is decoded before it is due */
+  unsigned int        m_stallStart;          /* when the last stream ran out with no next one ready, 0 if none */
   CEvent              m_startEvent;          /* event for playback start */
   StreamInfo*         m_currentStream;       /* the current playing stream */
   IAudioCallback*     m_audioCallback;       /* the viz audio callback */
@@ -158,6 +163,8 @@ private:
   int64_t GetTotalTime64();
   void UpdateCrossfadeTime(const CFileItem& file);
   void UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime);
+  int GetPrepareNextAtFrame(StreamInfo *si, int64_t streamTotalTime);
+  bool IsNextStreamDue();
   void UpdateGUIData(StreamInfo *si);
   int64_t GetTimeInternal();
   void SetTimeInternal(int64_t time);
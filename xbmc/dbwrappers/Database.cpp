@@ -26,10 +26,13 @@
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
+#include "threads/SystemClock.h"
 #include "sqlitedataset.h"
 #include "DatabaseManager.h"
 #include "DbUrl.h"
 
+#include <algorithm>
+
 #ifdef HAS_MYSQL
 #include "mysqldataset.h"
 #endif
@@ -42,6 +45,12 @@ using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
 
+// commit a batch at the next opportunity once it has been open this long
+#define BATCH_MAX_DURATION_MS 2000
+
+// rows per multi-row INSERT, below SQLite's compound select limit of 500
+#define INSERT_ROWS_PER_QUERY 250
+
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
   if (strField.empty())
@@ -107,6 +116,9 @@ CDatabase::CDatabase(void)
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_batch = false;
+  m_batchDepth = 0;
+  m_batchStart = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -164,6 +176,26 @@ std::string CDatabase::GetSingleValue(const std::string &query, std::unique_ptr<
   return ret;
 }
 
+std::string CDatabase::GetSingleValue(const std::string &query, const sql_params &params, std::unique_ptr<Dataset> &ds)
+{
+  std::string ret;
+  try
+  {
+    if (!m_pDB.get() || !ds.get())
+      return ret;
+
+    if (ds->query(query, params) && ds->num_rows() > 0)
+      ret = ds->fv(0).get_asString();
+
+    ds->close();
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - failed on query '%s'", __FUNCTION__, query.c_str());
+  }
+  return ret;
+}
+
 std::string CDatabase::GetSingleValue(const std::string &strTable, const std::string &strColumn, const std::string &strWhereClause /* = std::string() */, const std::string &strOrderBy /* = std::string() */)
 {
   std::string query = PrepareSQL("SELECT %s FROM %s", strColumn.c_str(), strTable.c_str());
@@ -236,6 +268,54 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecuteQuery(const std::string &strQuery, const sql_params &params)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    if (m_multipleExecute)
+    {
+      m_multipleQueries.push_back(m_pDB->bind_params(strQuery, params));
+      return true;
+    }
+
+    m_pDS->exec(strQuery, params);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return false;
+}
+
+bool CDatabase::InsertRows(const std::string &table, const std::string &columns, const std::vector<std::string> &rows, bool ignoreDuplicates /* = false */)
+{
+  std::string prefix = "INSERT ";
+  if (ignoreDuplicates)
+    prefix += m_sqlite ? "OR IGNORE " : "IGNORE ";
+  prefix += "INTO " + table + " (" + columns + ") VALUES ";
+
+  for (size_t first = 0; first < rows.size(); first += INSERT_ROWS_PER_QUERY)
+  {
+    std::string sql = prefix;
+    size_t last = std::min(rows.size(), first + INSERT_ROWS_PER_QUERY);
+    for (size_t i = first; i < last; i++)
+    {
+      if (i > first)
+        sql += ",";
+      sql += "(" + rows[i] + ")";
+    }
+    if (!ExecuteQuery(sql))
+      return false;
+  }
+  return true;
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -590,6 +670,10 @@ void CDatabase::Close()
   m_openCount = 0;
   m_multipleExecute = false;
 
+  // don't lose a batch the caller forgot to commit
+  if (m_batch)
+    CommitBatch();
+
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
   m_pDB->disconnect();
@@ -643,6 +727,12 @@ void CDatabase::BeginTransaction()
 {
   try
   {
+    if (m_batch)
+    {
+      if (NULL != m_pDB.get())
+        m_pDB->start_savepoint(StringUtils::Format("batch_%u", ++m_batchDepth));
+      return;
+    }
     if (NULL != m_pDB.get())
       m_pDB->start_transaction();
   }
@@ -656,6 +746,26 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
+    if (m_batch)
+    {
+      if (m_batchDepth == 0)
+      {
+        CLog::Log(LOGWARNING, "database:committransaction without begintransaction in batch");
+        return true;
+      }
+      if (NULL != m_pDB.get())
+        m_pDB->release_savepoint(StringUtils::Format("batch_%u", m_batchDepth));
+      m_batchDepth--;
+
+      // periodically commit long batches so the database isn't held locked
+      if (m_batchDepth == 0 && XbmcThreads::SystemClockMillis() - m_batchStart > BATCH_MAX_DURATION_MS && NULL != m_pDB.get())
+      {
+        m_pDB->commit_transaction();
+        m_pDB->start_transaction();
+        m_batchStart = XbmcThreads::SystemClockMillis();
+      }
+      return true;
+    }
     if (NULL != m_pDB.get())
       m_pDB->commit_transaction();
   }
@@ -671,6 +781,22 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
+    if (m_batch)
+    {
+      if (m_batchDepth == 0)
+      {
+        CLog::Log(LOGWARNING, "database:rollbacktransaction without begintransaction in batch");
+        return;
+      }
+      std::string savepoint = StringUtils::Format("batch_%u", m_batchDepth--);
+      OnBatchInvalidated();
+      if (NULL != m_pDB.get())
+      {
+        m_pDB->rollback_savepoint(savepoint);
+        m_pDB->release_savepoint(savepoint);
+      }
+      return;
+    }
     if (NULL != m_pDB.get())
       m_pDB->rollback_transaction();
   }
@@ -682,8 +808,46 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
-  return m_pDB->in_transaction();
+  if (NULL == m_pDB.get()) return false;
+  return m_batch || m_pDB->in_transaction();
+}
+
+bool CDatabase::BeginBatch()
+{
+  if (m_batch || NULL == m_pDB.get())
+    return false;
+
+  BeginTransaction();
+  OnBatchInvalidated();
+  m_batch = true;
+  m_batchDepth = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  return true;
+}
+
+bool CDatabase::CommitBatch()
+{
+  if (!m_batch)
+    return false;
+
+  if (m_batchDepth > 0)
+    CLog::Log(LOGWARNING, "database:commitbatch with %u transactions still open", m_batchDepth);
+
+  m_batch = false;
+  m_batchDepth = 0;
+  OnBatchInvalidated();
+  return CommitTransaction();
+}
+
+void CDatabase::RollbackBatch()
+{
+  if (!m_batch)
+    return;
+
+  m_batch = false;
+  m_batchDepth = 0;
+  OnBatchInvalidated();
+  RollbackTransaction();
 }
 
 bool CDatabase::CreateDatabase()
@@ -29,6 +29,8 @@ namespace dbiplus {
 #include <string>
 #include <vector>
 
+#include "qry_dat.h"
+
 class DatabaseSettings; // forward
 class CDbUrl;
 struct SortDescription;
@@ -71,6 +73,34 @@ public:
   void RollbackTransaction();
   bool InTransaction();
 
+  /*!
+   * @brief Start a batch: one transaction covering many items. While a batch
+   *        is open, BeginTransaction()/CommitTransaction()/RollbackTransaction()
+   *        map to savepoints, so a failing item only discards its own changes
+   *        while everything else is written by a single commit. A batch that
+   *        has been open for a while is committed and restarted the next time
+   *        no nested transaction is open, so other connections aren't locked
+   *        out for the whole scan.
+   * @return true if a batch was started, false if one is already open.
+   * @sa CommitBatch, RollbackBatch
+   */
+  bool BeginBatch();
+
+  /*!
+   * @brief Commit the batch started by BeginBatch().
+   * @return true if the batch was committed, false otherwise.
+   * @sa BeginBatch
+   */
+  bool CommitBatch();
+
+  /*!
+   * @brief Discard everything written since the batch was last committed.
+   * @sa BeginBatch
+   */
+  void RollbackBatch();
+
+  bool InBatch() const { return m_batch; }
+
   std::string PrepareSQL(std::string strStmt, ...) const;
 
   /*!
@@ -92,6 +122,14 @@ public:
    */
   std::string GetSingleValue(const std::string &query, std::unique_ptr<dbiplus::Dataset> &ds);
 
+  /*! \brief Get a single value from a parameterized query on a dataset.
+   \param query the query in question, using '?' placeholders for the values.
+   \param params the values for the placeholders, in order.
+   \param ds the dataset to use for the query.
+   \return the value from the query, empty on failure.
+   */
+  std::string GetSingleValue(const std::string &query, const dbiplus::sql_params &params, std::unique_ptr<dbiplus::Dataset> &ds);
+
   /*!
    * @brief Delete values from a table.
    * @param strTable The table to delete the values from.
@@ -110,6 +148,16 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a parameterized query that does not return any result.
+   *        The compiled statement is kept by the connection for reuse.
+   * @param strQuery The query to execute, using '?' placeholders for the values.
+   * @param params The values for the placeholders, in order.
+   * @return True if the query was executed successfully, false otherwise.
+   * @sa ExecuteQuery
+   */
+  bool ExecuteQuery(const std::string &strQuery, const dbiplus::sql_params &params);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -157,6 +205,16 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Insert several rows at once using multi-row INSERT statements.
+   * @param table The table to insert into.
+   * @param columns Comma separated list of the columns given in each row.
+   * @param rows The PrepareSQL'ed values of each row, without parentheses.
+   * @param ignoreDuplicates Skip rows violating a unique index rather than failing.
+   * @return True if all rows were inserted successfully, false otherwise.
+   */
+  bool InsertRows(const std::string &table, const std::string &columns, const std::vector<std::string> &rows, bool ignoreDuplicates = false);
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -204,6 +262,11 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Called when a batch ends or part of it is rolled back, so that
+   lookups cached for the duration of the batch can be dropped.
+   */
+  virtual void OnBatchInvalidated() {};
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -220,4 +283,8 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_batch;
+  unsigned int m_batchDepth;   ///< number of nested transactions (savepoints) open inside the batch
+  unsigned int m_batchStart;
 };
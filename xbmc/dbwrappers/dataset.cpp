@@ -82,6 +82,59 @@ std::string Database::prepare(const char *format, ...)
   return result;
 }
 
+std::string Database::bind_params(const std::string &sql, const sql_params &params)
+{
+  std::string result;
+  result.reserve(sql.size() + params.size() * 8);
+
+  size_t param = 0;
+  char quote = 0;
+  for (std::string::const_iterator c = sql.begin(); c != sql.end(); ++c)
+  {
+    if (quote)
+    {
+      if (*c == quote)
+        quote = 0;
+    }
+    else if (*c == '\'' || *c == '"')
+      quote = *c;
+    else if (*c == '?')
+    {
+      if (param >= params.size())
+        throw DbErrors("Missing value for parameter %u of '%s'", (unsigned int)param + 1, sql.c_str());
+
+      const field_value &value = params[param++];
+      char number[32];
+      if (value.get_isNull())
+        result += "NULL";
+      else switch (value.get_fType())
+      {
+        case ft_Boolean:
+        case ft_Short:
+        case ft_UShort:
+        case ft_Int:
+        case ft_UInt:
+        case ft_Int64:
+          snprintf(number, sizeof(number), "%lld", (long long)value.get_asInt64());
+          result += number;
+          break;
+        case ft_Float:
+        case ft_Double:
+        case ft_LongDouble:
+          snprintf(number, sizeof(number), "%.17g", value.get_asDouble());
+          result += number;
+          break;
+        default:
+          result += prepare("'%s'", value.get_asString().c_str());
+          break;
+      }
+      continue;
+    }
+    result += *c;
+  }
+  return result;
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset():
@@ -202,6 +255,18 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+int Dataset::exec(const std::string &sql, const sql_params &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+  return exec(db->bind_params(sql, params));
+}
+
+
+bool Dataset::query(const std::string &sql, const sql_params &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+  return query(db->bind_params(sql, params));
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
@@ -147,6 +147,12 @@ public:
   virtual void commit_transaction() {};
   virtual void rollback_transaction() {};
 
+/* virtual methods for savepoints inside an open transaction */
+
+  virtual void start_savepoint(const std::string &name) {};
+  virtual void release_savepoint(const std::string &name) {};
+  virtual void rollback_savepoint(const std::string &name) {};
+
 /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
@@ -163,6 +169,14 @@ public:
    */
   virtual std::string vprepare(const char *format, va_list args) = 0;
 
+  /*! \brief Replace the '?' placeholders of a parameterized statement with the escaped values of params.
+   Used by connections that can't keep compiled statements around.
+   \param sql - statement using '?' placeholders outside of quoted strings.
+   \param params - the values for the placeholders, in order.
+   \return the statement with the values substituted.
+   */
+  virtual std::string bind_params(const std::string &sql, const sql_params &params);
+
   virtual bool in_transaction() {return false;};
 
 };
@@ -308,6 +322,10 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exept Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as exec and query, with the '?' placeholders in sql bound to params in order.
+   Connections that support it keep the compiled statement for reuse. */
+  virtual int  exec (const std::string &sql, const sql_params &params);
+  virtual bool query(const std::string &sql, const sql_params &params);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -43,6 +43,12 @@
 #define MYSQL_OK          0
 #define ER_BAD_DB_ERROR   1049
 
+// number of compiled statements kept per connection
+#define STATEMENT_CACHE_SIZE 64
+
+// my_bool was replaced by bool in the MySQL 8 client library
+typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type mysql_flag;
+
 namespace dbiplus {
 
 //************* MysqlDatabase implementation ***************
@@ -256,6 +262,7 @@ int MysqlDatabase::connect(bool create_new) {
 }
 
 void MysqlDatabase::disconnect(void) {
+  clear_statements();
   if (conn != NULL)
   {
     mysql_close(conn);
@@ -459,6 +466,60 @@ int MysqlDatabase::query_with_reconnect(const char* query) {
   return result;
 }
 
+// methods for compiled statements
+// ---------------------------------------------
+MYSQL_STMT *MysqlDatabase::acquire_statement(const std::string &sql) {
+  std::map<std::string, StatementCache::iterator>::iterator i = statement_index.find(sql);
+  if (i != statement_index.end())
+  {
+    // hand it out exclusively until it is released
+    MYSQL_STMT *stmt = i->second->second;
+    statements.erase(i->second);
+    statement_index.erase(i);
+    return stmt;
+  }
+
+  MYSQL_STMT *stmt = mysql_stmt_init(conn);
+  if (stmt == NULL)
+    return NULL;
+
+  if (mysql_stmt_prepare(stmt, sql.c_str(), sql.size()) != MYSQL_OK)
+  {
+    // not every statement can be prepared, the caller falls back to a plain query
+    CLog::Log(LOGDEBUG, "MYSQL: unable to prepare '%s': %s", sql.c_str(), mysql_stmt_error(stmt));
+    mysql_stmt_close(stmt);
+    return NULL;
+  }
+  return stmt;
+}
+
+void MysqlDatabase::release_statement(const std::string &sql, MYSQL_STMT *stmt, bool reusable) {
+  mysql_stmt_free_result(stmt);
+
+  // the same statement may have been compiled twice if it was in use already
+  if (!reusable || !active || statement_index.find(sql) != statement_index.end())
+  {
+    mysql_stmt_close(stmt);
+    return;
+  }
+
+  statements.push_front(std::make_pair(sql, stmt));
+  statement_index[sql] = statements.begin();
+  if (statements.size() > STATEMENT_CACHE_SIZE)
+  {
+    statement_index.erase(statements.back().first);
+    mysql_stmt_close(statements.back().second);
+    statements.pop_back();
+  }
+}
+
+void MysqlDatabase::clear_statements() {
+  for (StatementCache::iterator i = statements.begin(); i != statements.end(); ++i)
+    mysql_stmt_close(i->second);
+  statements.clear();
+  statement_index.clear();
+}
+
 long MysqlDatabase::nextid(const char* sname) {
   CLog::Log(LOGDEBUG,"MysqlDatabase::nextid for %s",sname);
   if (!active) return DB_UNEXPECTED_RESULT;
@@ -531,6 +592,30 @@ void MysqlDatabase::rollback_transaction() {
   }
 }
 
+void MysqlDatabase::start_savepoint(const std::string &name) {
+  if (active)
+  {
+    std::string sql = "SAVEPOINT " + name;
+    mysql_real_query(conn, sql.c_str(), sql.size());
+  }
+}
+
+void MysqlDatabase::release_savepoint(const std::string &name) {
+  if (active)
+  {
+    std::string sql = "RELEASE SAVEPOINT " + name;
+    mysql_real_query(conn, sql.c_str(), sql.size());
+  }
+}
+
+void MysqlDatabase::rollback_savepoint(const std::string &name) {
+  if (active)
+  {
+    std::string sql = "ROLLBACK TO SAVEPOINT " + name;
+    mysql_real_query(conn, sql.c_str(), sql.size());
+  }
+}
+
 bool MysqlDatabase::exists(void) {
   bool ret = false;
 
@@ -1499,6 +1584,57 @@ static size_t ci_find(const std::string& where, const std::string& what)
     return loc - where.begin();
 }
 
+static void convert_field(field_value &v, const MYSQL_FIELD &field, const char *value)
+{
+  switch (field.type)
+  {
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+      if (value != NULL)
+      {
+        v.set_asInt(atoi(value));
+      }
+      else
+      {
+        v.set_asInt(0);
+      }
+      break;
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+      if (value != NULL)
+      {
+        v.set_asDouble(atof(value));
+      }
+      else
+      {
+        v.set_asDouble(0);
+      }
+      break;
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_VARCHAR:
+      if (value != NULL) v.set_asString(value);
+      break;
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+      if (value != NULL) v.set_asString(value);
+      break;
+    case MYSQL_TYPE_NULL:
+    default:
+      CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", field.type);
+      v.set_asString("");
+      v.set_isNull();
+      break;
+  }
+}
+
 int MysqlDataset::exec(const std::string &sql) {
   if (!handle()) throw DbErrors("No Database Connection");
   std::string qry = sql;
@@ -1590,54 +1726,7 @@ bool MysqlDataset::query(const std::string &query) {
     res->resize(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value &v = res->at(i);
-      switch (fields[i].type)
-      {
-        case MYSQL_TYPE_LONGLONG:
-        case MYSQL_TYPE_DECIMAL:
-        case MYSQL_TYPE_NEWDECIMAL:
-        case MYSQL_TYPE_TINY:
-        case MYSQL_TYPE_SHORT:
-        case MYSQL_TYPE_INT24:
-        case MYSQL_TYPE_LONG:
-          if (row[i] != NULL)
-          {
-            v.set_asInt(atoi(row[i]));
-          }
-          else
-          {
-            v.set_asInt(0);
-          }
-          break;
-        case MYSQL_TYPE_FLOAT:
-        case MYSQL_TYPE_DOUBLE:
-          if (row[i] != NULL)
-          {
-            v.set_asDouble(atof(row[i]));
-          }
-          else
-          {
-            v.set_asDouble(0);
-          }
-          break;
-        case MYSQL_TYPE_STRING:
-        case MYSQL_TYPE_VAR_STRING:
-        case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
-          break;
-        case MYSQL_TYPE_TINY_BLOB:
-        case MYSQL_TYPE_MEDIUM_BLOB:
-        case MYSQL_TYPE_LONG_BLOB:
-        case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
-          break;
-        case MYSQL_TYPE_NULL:
-        default:
-          CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
-          v.set_isNull();
-          break;
-      }
+      convert_field(res->at(i), fields[i], row[i]);
     }
     result.records.push_back(res);
   }
@@ -1648,6 +1737,194 @@ bool MysqlDataset::query(const std::string &query) {
   return true;
 }
 
+bool MysqlDataset::query(const std::string &query, const sql_params &params) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  std::string qry = query;
+  if (qry.find("select") == std::string::npos && qry.find("SELECT") == std::string::npos)
+    throw DbErrors("MUST be select SQL!");
+
+  size_t loc;
+
+  // mysql doesn't understand CAST(foo as integer) => change to CAST(foo as signed integer)
+  while ((loc = ci_find(qry, "as integer)")) != std::string::npos)
+    qry = qry.insert(loc + 3, "signed ");
+
+  MysqlDatabase *mysql = static_cast<MysqlDatabase*>(db);
+  MYSQL_STMT *stmt = mysql->acquire_statement(qry);
+  if (stmt == NULL)
+    return this->query(db->bind_params(query, params));
+
+  close();
+
+  MYSQL_RES *meta = NULL;
+  try
+  {
+    execute(stmt, params, qry);
+
+    // have the column lengths computed so the buffers below fit most values
+    mysql_flag update_max_length = 1;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &update_max_length);
+    meta = mysql_stmt_result_metadata(stmt);
+    if (meta == NULL || mysql_stmt_store_result(stmt) != MYSQL_OK)
+      throw DbErrors("Missing result set!");
+
+    // column headers
+    const unsigned int numColumns = mysql_num_fields(meta);
+    MYSQL_FIELD *fields = mysql_fetch_fields(meta);
+    result.record_header.resize(numColumns);
+    for (unsigned int i = 0; i < numColumns; i++)
+      result.record_header[i].name = fields[i].name;
+
+    // every column is fetched as text and converted like the text protocol does
+    std::vector<MYSQL_BIND> columns(numColumns);
+    std::vector<std::vector<char> > buffers(numColumns);
+    std::vector<unsigned long> lengths(numColumns);
+    std::unique_ptr<mysql_flag[]> nulls(new mysql_flag[numColumns]);
+    for (unsigned int i = 0; i < numColumns; i++)
+    {
+      buffers[i].resize(std::max(fields[i].max_length, 64UL) + 1);
+      memset(&columns[i], 0, sizeof(MYSQL_BIND));
+      columns[i].buffer_type = MYSQL_TYPE_STRING;
+      columns[i].buffer = &buffers[i][0];
+      columns[i].buffer_length = buffers[i].size();
+      columns[i].length = &lengths[i];
+      columns[i].is_null = &nulls[i];
+    }
+    if (numColumns && mysql_stmt_bind_result(stmt, &columns[0]) != MYSQL_OK)
+      throw DbErrors(mysql_stmt_error(stmt));
+
+    // returned rows
+    int res;
+    while ((res = mysql_stmt_fetch(stmt)) == MYSQL_OK || res == MYSQL_DATA_TRUNCATED)
+    { // have a row of data
+      sql_record *rec = new sql_record;
+      rec->resize(numColumns);
+      for (unsigned int i = 0; i < numColumns; i++)
+      {
+        if (nulls[i])
+          convert_field(rec->at(i), fields[i], NULL);
+        else if (lengths[i] < buffers[i].size())
+        {
+          buffers[i][lengths[i]] = 0;
+          convert_field(rec->at(i), fields[i], &buffers[i][0]);
+        }
+        else
+        {
+          // value didn't fit, fetch it again in full
+          std::vector<char> value(lengths[i] + 1);
+          MYSQL_BIND column = columns[i];
+          column.buffer = &value[0];
+          column.buffer_length = value.size();
+          mysql_stmt_fetch_column(stmt, &column, i, 0);
+          value[lengths[i]] = 0;
+          convert_field(rec->at(i), fields[i], &value[0]);
+        }
+      }
+      result.records.push_back(rec);
+    }
+    if (res != MYSQL_NO_DATA)
+      throw DbErrors(mysql_stmt_error(stmt));
+  }
+  catch (...)
+  {
+    if (meta)
+      mysql_free_result(meta);
+    mysql->release_statement(qry, stmt, false);
+    throw;
+  }
+
+  mysql_free_result(meta);
+  mysql->release_statement(qry, stmt, true);
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+int MysqlDataset::exec(const std::string &sql, const sql_params &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  MysqlDatabase *mysql = static_cast<MysqlDatabase*>(db);
+  MYSQL_STMT *stmt = mysql->acquire_statement(sql);
+  if (stmt == NULL)
+    return exec(db->bind_params(sql, params));
+
+  try
+  {
+    execute(stmt, params, sql);
+  }
+  catch (...)
+  {
+    mysql->release_statement(sql, stmt, false);
+    throw;
+  }
+  mysql->release_statement(sql, stmt, true);
+  return MYSQL_OK;
+}
+
+void MysqlDataset::execute(MYSQL_STMT *stmt, const sql_params &params, const std::string &sql) {
+  if (mysql_stmt_param_count(stmt) != params.size())
+    throw DbErrors("Expected %lu parameters but got %u for '%s'", mysql_stmt_param_count(stmt), (unsigned int)params.size(), sql.c_str());
+
+  // the values have to stay in place until the statement is executed
+  std::vector<MYSQL_BIND> binds(params.size());
+  std::vector<long long> ints(params.size());
+  std::vector<double> doubles(params.size());
+  std::vector<std::string> strings(params.size());
+  std::vector<unsigned long> lengths(params.size());
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &value = params[i];
+    MYSQL_BIND &bind = binds[i];
+    memset(&bind, 0, sizeof(MYSQL_BIND));
+    if (value.get_isNull())
+    {
+      bind.buffer_type = MYSQL_TYPE_NULL;
+      continue;
+    }
+    switch (value.get_fType())
+    {
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        ints[i] = value.get_asInt64();
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &ints[i];
+        break;
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        doubles[i] = value.get_asDouble();
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &doubles[i];
+        break;
+      default:
+        strings[i] = value.get_asString();
+        lengths[i] = strings[i].size();
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = const_cast<char*>(strings[i].c_str());
+        bind.buffer_length = lengths[i];
+        bind.length = &lengths[i];
+        break;
+    }
+  }
+
+  if ((!binds.empty() && mysql_stmt_bind_param(stmt, &binds[0]) != MYSQL_OK) ||
+      mysql_stmt_execute(stmt) != MYSQL_OK)
+  {
+    int err = mysql_stmt_errno(stmt);
+    // the cached statements died with the connection, which is reopened by the next plain query
+    if (err == CR_SERVER_GONE_ERROR || err == CR_SERVER_LOST)
+      static_cast<MysqlDatabase*>(db)->clear_statements();
+    db->setErr(err, sql.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+}
+
 void MysqlDataset::open(const std::string &sql) {
    set_select_sql(sql);
    open();
@@ -22,6 +22,7 @@
 
 #include <stdio.h>
 #include "dataset.h"
+#include <list>
 #include "mysql/mysql.h"
 
 namespace dbiplus {
@@ -37,6 +38,10 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* compiled statements kept for reuse, most recently used first */
+  typedef std::list<std::pair<std::string, MYSQL_STMT*> > StatementCache;
+  StatementCache statements;
+  std::map<std::string, StatementCache::iterator> statement_index;
 
 public:
 /* default constructor */
@@ -79,6 +84,10 @@ public:
   virtual void commit_transaction();
   virtual void rollback_transaction();
 
+  virtual void start_savepoint(const std::string &name);
+  virtual void release_savepoint(const std::string &name);
+  virtual void rollback_savepoint(const std::string &name);
+
 /* virtual methods for formatting */
   virtual std::string vprepare(const char *format, va_list args);
 
@@ -86,6 +95,14 @@ public:
   int query_with_reconnect(const char* query);
   void configure_connection();
 
+/* func. returns a compiled statement for sql, taken from the cache when possible.
+   Returns NULL if the server can't prepare it. */
+  MYSQL_STMT *acquire_statement(const std::string &sql);
+/* func. puts stmt back in the cache, or closes it if it is not reusable */
+  void release_statement(const std::string &sql, MYSQL_STMT *stmt, bool reusable);
+/* func. closes all cached statements */
+  void clear_statements();
+
 private:
 
   typedef struct StrAccum StrAccum;
@@ -128,6 +145,9 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* Binds params to the placeholders of stmt and executes it */
+  void execute(MYSQL_STMT *stmt, const sql_params &params, const std::string &sql);
+
 public:
 /* constructor */
   MysqlDataset();
@@ -146,9 +166,11 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   virtual int  exec ();
   virtual int  exec (const std::string &sql);
+  virtual int  exec (const std::string &sql, const sql_params &params);
   virtual const void* getExecRes();
 /* as open, but with our query exept Sql */
   virtual bool query(const std::string &query);
+  virtual bool query(const std::string &query, const sql_params &params);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
@@ -81,6 +81,9 @@ int callback(void* res_ptr,int ncol, char** reslt,char** cols)
   return 0;  
 }
 
+// number of compiled statements kept per connection
+#define STATEMENT_CACHE_SIZE 64
+
 static int busy_callback(void*, int busyCount)
 {
   Sleep(100);
@@ -261,6 +264,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clear_statements();
   sqlite3_close(conn);
   active = false;
 }
@@ -415,6 +419,76 @@ void SqliteDatabase::rollback_transaction() {
   }  
 }
 
+void SqliteDatabase::start_savepoint(const std::string &name) {
+  if (active) {
+    std::string sql = "SAVEPOINT " + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
+void SqliteDatabase::release_savepoint(const std::string &name) {
+  if (active) {
+    std::string sql = "RELEASE SAVEPOINT " + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
+void SqliteDatabase::rollback_savepoint(const std::string &name) {
+  if (active) {
+    std::string sql = "ROLLBACK TO SAVEPOINT " + name;
+    sqlite3_exec(conn,sql.c_str(),NULL,NULL,NULL);
+  }
+}
+
+
+// methods for compiled statements
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::acquire_statement(const std::string &sql) {
+  std::map<std::string, StatementCache::iterator>::iterator i = statement_index.find(sql);
+  if (i != statement_index.end())
+  {
+    // hand it out exclusively until it is released
+    sqlite3_stmt *stmt = i->second->second;
+    statements.erase(i->second);
+    statement_index.erase(i);
+    return stmt;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+  return stmt;
+}
+
+int SqliteDatabase::release_statement(const std::string &sql, sqlite3_stmt *stmt) {
+  int res = sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  // the same statement may have been compiled twice if it was in use already
+  if (!active || statement_index.find(sql) != statement_index.end())
+  {
+    sqlite3_finalize(stmt);
+    return res;
+  }
+
+  statements.push_front(std::make_pair(sql, stmt));
+  statement_index[sql] = statements.begin();
+  if (statements.size() > STATEMENT_CACHE_SIZE)
+  {
+    statement_index.erase(statements.back().first);
+    sqlite3_finalize(statements.back().second);
+    statements.pop_back();
+  }
+  return res;
+}
+
+void SqliteDatabase::clear_statements() {
+  for (StatementCache::iterator i = statements.begin(); i != statements.end(); ++i)
+    sqlite3_finalize(i->second);
+  statements.clear();
+  statement_index.clear();
+}
+
 
 // methods for formatting
 // ---------------------------------------------
@@ -654,6 +728,115 @@ bool SqliteDataset::query(const std::string &query) {
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
     throw DbErrors(db->getErrorMsg());
 
+  fetch_rows(stmt);
+  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+  {
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+  else
+  {
+    throw DbErrors(db->getErrorMsg());
+  }  
+}
+
+bool SqliteDataset::query(const std::string &query, const sql_params &params) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  if (query.find("select") == std::string::npos && query.find("SELECT") == std::string::npos)
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  SqliteDatabase *sqlite = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlite->acquire_statement(query);
+  try
+  {
+    bind_params(stmt, params, query);
+    fetch_rows(stmt);
+  }
+  catch (...)
+  {
+    sqlite->release_statement(query, stmt);
+    throw;
+  }
+
+  if (db->setErr(sqlite->release_statement(query, stmt), query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+int SqliteDataset::exec(const std::string &sql, const sql_params &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  SqliteDatabase *sqlite = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlite->acquire_statement(sql);
+  int res;
+  try
+  {
+    bind_params(stmt, params, sql);
+    while ((res = sqlite3_step(stmt)) == SQLITE_ROW)
+      ;
+  }
+  catch (...)
+  {
+    sqlite->release_statement(sql, stmt);
+    throw;
+  }
+
+  int reset = sqlite->release_statement(sql, stmt);
+  if (res != SQLITE_DONE)
+  {
+    db->setErr(reset, sql.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+  return SQLITE_OK;
+}
+
+void SqliteDataset::bind_params(sqlite3_stmt *stmt, const sql_params &params, const std::string &sql) {
+  if (sqlite3_bind_parameter_count(stmt) != (int)params.size())
+    throw DbErrors("Expected %d parameters but got %u for '%s'", sqlite3_bind_parameter_count(stmt), (unsigned int)params.size(), sql.c_str());
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &value = params[i];
+    int res;
+    if (value.get_isNull())
+      res = sqlite3_bind_null(stmt, i + 1);
+    else switch (value.get_fType())
+    {
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        res = sqlite3_bind_int64(stmt, i + 1, value.get_asInt64());
+        break;
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        res = sqlite3_bind_double(stmt, i + 1, value.get_asDouble());
+        break;
+      default:
+        {
+          std::string text = value.get_asString();
+          res = sqlite3_bind_text(stmt, i + 1, text.c_str(), text.size(), SQLITE_TRANSIENT);
+        }
+        break;
+    }
+    if (db->setErr(res, sql.c_str()) != SQLITE_OK)
+      throw DbErrors(db->getErrorMsg());
+  }
+}
+
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -691,17 +874,6 @@ bool SqliteDataset::query(const std::string &query) {
     }
     result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
-  {
-    active = true;
-    ds_state = dsSelect;
-    this->first();
-    return true;
-  }
-  else
-  {
-    throw DbErrors(db->getErrorMsg());
-  }  
 }
 
 void SqliteDataset::open(const std::string &sql) {
@@ -30,6 +30,7 @@
 
 #include <stdio.h>
 #include "dataset.h"
+#include <list>
 #include <sqlite3.h>
 
 namespace dbiplus {
@@ -45,6 +46,11 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* compiled statements kept for reuse, most recently used first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementCache;
+  StatementCache statements;
+  std::map<std::string, StatementCache::iterator> statement_index;
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -91,11 +97,21 @@ public:
   virtual void commit_transaction();
   virtual void rollback_transaction();
 
+  virtual void start_savepoint(const std::string &name);
+  virtual void release_savepoint(const std::string &name);
+  virtual void rollback_savepoint(const std::string &name);
+
 /* virtual methods for formatting */
   virtual std::string vprepare(const char *format, va_list args);
 
   bool in_transaction() {return _in_transaction;}; 	
 
+/* func. returns a compiled statement for sql, taken from the cache when possible */
+  sqlite3_stmt *acquire_statement(const std::string &sql);
+/* func. resets stmt and puts it back in the cache, returns the result of the reset */
+  int release_statement(const std::string &sql, sqlite3_stmt *stmt);
+/* func. finalizes all cached statements */
+  void clear_statements();
 };
 
 
@@ -127,6 +143,11 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* Reads the column headers and all rows of stmt into the result set */
+  void fetch_rows(sqlite3_stmt *stmt);
+/* Binds params to the placeholders of stmt */
+  void bind_params(sqlite3_stmt *stmt, const sql_params &params, const std::string &sql);
+
 public:
 /* constructor */
   SqliteDataset();
@@ -145,9 +166,11 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   virtual int  exec ();
   virtual int  exec (const std::string &sql);
+  virtual int  exec (const std::string &sql, const sql_params &params);
   virtual const void* getExecRes();
 /* as open, but with our query exept Sql */
   virtual bool query(const std::string &query);
+  virtual bool query(const std::string &query, const sql_params &params);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
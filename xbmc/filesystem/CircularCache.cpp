@@ -268,3 +268,25 @@ CCacheStrategy *CCircularCache::CreateNew()
   return new CCircularCache(m_size - m_size_back, m_size_back);
 }
 
+size_t CCircularCache::SetForwardSize(size_t front)
+{
+  CSingleLock lock(m_sync);
+
+  // keep at least a quarter of the buffer as forward cache and an
+  // eighth as back buffer for small backward seeks
+  front = std::max(front, m_size / 4);
+  front = std::min(front, m_size - m_size / 8);
+  m_size_back = m_size - front;
+
+  // the back buffer may have shrunk, the writer can use the space now
+  m_space.Set();
+
+  return front;
+}
+
+size_t CCircularCache::GetForwardSize()
+{
+  CSingleLock lock(m_sync);
+  return m_size - m_size_back;
+}
+
@@ -49,6 +49,15 @@ public:
     virtual bool IsCachedPosition(int64_t iFilePosition);
 
     virtual CCacheStrategy *CreateNew();
+
+    /*!
+     \brief Move the split between forward and back buffer
+     \param front wanted forward size, clamped so that both the forward and
+            the back buffer keep a sane minimum
+     \return the forward size in effect
+     */
+    size_t SetForwardSize(size_t front);
+    size_t GetForwardSize();
 protected:
     int64_t           m_beg;       /**< index in file (not buffer) of beginning of valid data */
     int64_t           m_end;       /**< index in file (not buffer) of end of valid data */
@@ -19,7 +19,10 @@
  */
 
 #include "DirectoryCache.h"
+#include "DirectoryDiskCache.h"
+#include "File.h"
 #include "FileItem.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -68,28 +71,78 @@ CDirectoryCache::~CDirectoryCache(void)
 
 bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
   {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+    CSingleLock lock (m_cs);
+
+    ciCache i = m_cache.find(storedPath);
+    if (i != m_cache.end())
     {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
+      CDir* dir = i->second;
+      if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
+         (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+      {
+        items.Copy(*dir->m_Items);
+        dir->SetLastAccess(m_accessCounter);
 #ifdef _DEBUG
-      m_cacheHits+=items.Size();
+        m_cacheHits+=items.Size();
 #endif
-      return true;
+        return true;
+      }
+      return false;
     }
   }
-  return false;
+
+  // listings on disk are only handed out where a cached listing is accepted
+  // anyway. the fingerprint of the directory catches entries which have been
+  // added, removed or renamed since, but not files changed in place.
+  if (!retrieveAll || !CanPersist(storedPath))
+    return false;
+
+  {
+    CSingleLock lock (m_diskCs);
+    if (!GetDiskCache() || !GetDiskCache()->Contains(storedPath))
+      return false;
+  }
+
+  // one stat of the directory instead of listing it again, done unlocked
+  // as it goes over the network
+  int64_t mtime, size;
+  if (!GetFingerprint(storedPath, mtime, size))
+    return false;
+
+  CDir* dir = new CDir(DIR_CACHE_ONCE);
+  {
+    CSingleLock lock (m_diskCs);
+    if (!GetDiskCache()->Get(storedPath, mtime, size, *dir->m_Items))
+    {
+      delete dir;
+      return false;
+    }
+  }
+
+  items.Copy(*dir->m_Items);
+#ifdef _DEBUG
+  m_cacheHits+=items.Size();
+#endif
+
+  CSingleLock lock (m_cs);
+
+  // somebody else may have listed the directory meanwhile
+  if (m_cache.find(storedPath) != m_cache.end())
+  {
+    delete dir;
+    return true;
+  }
+
+  CheckIfFull();
+
+  dir->SetLastAccess(m_accessCounter);
+  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  return true;
 }
 
 void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -108,18 +161,38 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  CDir* dir = new CDir(cacheType);
+  dir->m_Items->Copy(items);
+
+  // listings of network shares are kept on disk, with a fingerprint of the
+  // directory to validate them against later. neither the stat nor the
+  // archive hold up the memory cache.
+  if (CanPersist(storedPath))
+  {
+    int64_t mtime = 0, size = 0;
+    const bool persist = g_advancedSettings.m_cacheDirectorySize > 0 &&
+                         GetFingerprint(storedPath, mtime, size);
+
+    CSingleLock lock (m_diskCs);
+    if (persist && GetDiskCache())
+      GetDiskCache()->Put(storedPath, mtime, size, *dir->m_Items);
+    else if (m_diskCache)
+      m_diskCache->Remove(storedPath);
+  }
+
+  CSingleLock lock (m_cs);
+
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Delete(i);
 
   CheckIfFull();
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
   dir->SetLastAccess(m_accessCounter);
   m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
 }
@@ -134,49 +207,77 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  {
+    CSingleLock lock (m_cs);
+
+    iCache i = m_cache.find(storedPath);
+    if (i != m_cache.end())
+      Delete(i);
+  }
+
+  if (CanPersist(storedPath))
+  {
+    CSingleLock lock (m_diskCs);
+    if (m_diskCache)
+      m_diskCache->Remove(storedPath);
+  }
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock (m_cs);
+
+    iCache i = m_cache.begin();
+    while (i != m_cache.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(i++);
+      else
+        i++;
+    }
+  }
+
+  if (CanPersist(storedPath))
+  {
+    CSingleLock lock (m_diskCs);
+    if (m_diskCache)
+      m_diskCache->RemoveSubPaths(storedPath);
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
   {
-    CDir *dir = i->second;
-    CFileItemPtr item(new CFileItem(strFile, false));
-    dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    CSingleLock lock (m_cs);
+
+    ciCache i = m_cache.find(strPath);
+    if (i != m_cache.end())
+    {
+      CDir *dir = i->second;
+      CFileItemPtr item(new CFileItem(strFile, false));
+      dir->m_Items->Add(item);
+      dir->SetLastAccess(m_accessCounter);
+    }
+  }
+
+  // the stored listing misses the file now
+  if (CanPersist(strPath))
+  {
+    CSingleLock lock (m_diskCs);
+    if (m_diskCache)
+      m_diskCache->Remove(strPath);
   }
 }
 
@@ -218,6 +319,38 @@ void CDirectoryCache::Clear()
     Delete(i++);
 }
 
+void CDirectoryCache::Flush()
+{
+  CSingleLock lock (m_diskCs);
+
+  if (m_diskCache)
+    m_diskCache->Flush();
+}
+
+bool CDirectoryCache::CanPersist(const std::string& path)
+{
+  return URIUtils::IsSmb(path) || URIUtils::IsNfs(path);
+}
+
+bool CDirectoryCache::GetFingerprint(const std::string& path, int64_t& mtime, int64_t& size)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(path, &buffer) != 0 || buffer.st_mtime == 0)
+    return false;
+
+  mtime = buffer.st_mtime;
+  size = buffer.st_size;
+  return true;
+}
+
+CDirectoryDiskCache* CDirectoryCache::GetDiskCache()
+{
+  if (!m_diskCache && g_advancedSettings.m_cacheDirectorySize > 0)
+    m_diskCache.reset(new CDirectoryDiskCache("special://temp/directory_cache/", g_advancedSettings.m_cacheDirectorySize));
+
+  return m_diskCache.get();
+}
+
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 {
   std::set<std::string>::iterator it;
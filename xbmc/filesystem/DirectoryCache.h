@@ -24,12 +24,15 @@
 #include "threads/CriticalSection.h"
 
 #include <map>
+#include <memory>
 #include <set>
 
 class CFileItem;
 
 namespace XFILE
 {
+  class CDirectoryDiskCache;
+
   class CDirectoryCache
   {
     class CDir
@@ -55,6 +58,10 @@ namespace XFILE
     void ClearFile(const std::string& strFile);
     void ClearSubPaths(const std::string& strPath);
     void Clear();
+    /*!
+     \brief Write out the state of the on-disk cache, Clear() leaves it intact
+     */
+    void Flush();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
 #ifdef _DEBUG
@@ -65,6 +72,10 @@ namespace XFILE
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
 
+    static bool CanPersist(const std::string& path);
+    static bool GetFingerprint(const std::string& path, int64_t& mtime, int64_t& size);
+    CDirectoryDiskCache* GetDiskCache();
+
     std::map<std::string, CDir*> m_cache;
     typedef std::map<std::string, CDir*>::iterator iCache;
     typedef std::map<std::string, CDir*>::const_iterator ciCache;
@@ -74,6 +85,9 @@ namespace XFILE
 
     unsigned int m_accessCounter;
 
+    CCriticalSection m_diskCs; ///< serializes m_diskCache, never held together with m_cs
+    std::unique_ptr<CDirectoryDiskCache> m_diskCache;
+
 #ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
@@ -0,0 +1,294 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DirectoryDiskCache.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "threads/SystemClock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "URL.h"
+
+#define INDEX_FILE              "index.dat"
+#define INDEX_VERSION           1
+#define INDEX_SAVE_INTERVAL_MS  30000
+
+using namespace XFILE;
+
+CDirectoryDiskCache::CDirectoryDiskCache(const std::string& cachePath, uint64_t maxBytes)
+  : m_cachePath(cachePath)
+  , m_maxBytes(maxBytes)
+  , m_bytes(0)
+  , m_accessCounter(0)
+  , m_lastSave(0)
+  , m_loaded(false)
+  , m_dirty(false)
+{
+}
+
+CDirectoryDiskCache::~CDirectoryDiskCache()
+{
+}
+
+bool CDirectoryDiskCache::Get(const std::string& path, int64_t mtime, int64_t size, CFileItemList& items)
+{
+  Load();
+
+  EntryMap::iterator it = m_entries.find(path);
+  if (it == m_entries.end())
+    return false;
+
+  if (it->second.mtime != mtime || it->second.size != size)
+  {
+    CLog::Log(LOGDEBUG, "%s - %s changed, dropping cached listing", __FUNCTION__, CURL::GetRedacted(path).c_str());
+    Erase(it);
+    return false;
+  }
+
+  bool loaded = false;
+  CFile file;
+  if (file.Open(GetEntryFile(path)))
+  {
+    try
+    {
+      CArchive ar(&file, CArchive::load);
+      std::string storedPath;
+      ar >> storedPath;
+      if (storedPath == path)
+      {
+        ar >> items;
+        loaded = true;
+      }
+      ar.Close();
+    }
+    catch (std::out_of_range&)
+    {
+      CLog::Log(LOGERROR, "%s - corrupt archive for %s", __FUNCTION__, CURL::GetRedacted(path).c_str());
+      items.Clear();
+    }
+    file.Close();
+  }
+
+  if (!loaded)
+  {
+    Erase(it);
+    return false;
+  }
+
+  it->second.lastAccess = m_accessCounter++;
+  m_dirty = true;
+  return true;
+}
+
+void CDirectoryDiskCache::Put(const std::string& path, int64_t mtime, int64_t size, CFileItemList& items)
+{
+  Load();
+
+  CFile file;
+  if (!file.OpenForWrite(GetEntryFile(path), true))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to write %s", __FUNCTION__, GetEntryFile(path).c_str());
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << path;
+  ar << items;
+  ar.Close();
+  const uint64_t bytes = file.GetLength();
+  file.Close();
+
+  // several paths may share an archive name, drop the one overwritten
+  for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->first != path && GetEntryFile(it->first) == GetEntryFile(path))
+    {
+      m_bytes -= it->second.bytes;
+      m_entries.erase(it);
+      break;
+    }
+  }
+
+  Entry& entry = m_entries[path];
+  if (entry.bytes > 0)
+    m_bytes -= entry.bytes;
+  entry.mtime = mtime;
+  entry.size = size;
+  entry.bytes = bytes;
+  entry.lastAccess = m_accessCounter++;
+  m_bytes += bytes;
+  m_dirty = true;
+
+  Evict();
+
+  if (XbmcThreads::SystemClockMillis() - m_lastSave >= INDEX_SAVE_INTERVAL_MS)
+    Flush();
+}
+
+bool CDirectoryDiskCache::Contains(const std::string& path)
+{
+  Load();
+  return m_entries.find(path) != m_entries.end();
+}
+
+void CDirectoryDiskCache::Remove(const std::string& path)
+{
+  Load();
+
+  EntryMap::iterator it = m_entries.find(path);
+  if (it != m_entries.end())
+    Erase(it);
+}
+
+void CDirectoryDiskCache::RemoveSubPaths(const std::string& path)
+{
+  Load();
+
+  EntryMap::iterator it = m_entries.begin();
+  while (it != m_entries.end())
+  {
+    if (URIUtils::PathHasParent(it->first, path))
+      Erase(it++);
+    else
+      ++it;
+  }
+}
+
+void CDirectoryDiskCache::Flush()
+{
+  m_lastSave = XbmcThreads::SystemClockMillis();
+  if (!m_dirty)
+    return;
+
+  CFile file;
+  if (!file.OpenForWrite(URIUtils::AddFileToFolder(m_cachePath, INDEX_FILE), true))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to write index to %s", __FUNCTION__, m_cachePath.c_str());
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)INDEX_VERSION;
+  ar << (int)m_entries.size();
+  for (EntryMap::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    ar << it->first;
+    ar << it->second.mtime;
+    ar << it->second.size;
+    ar << it->second.bytes;
+    ar << it->second.lastAccess;
+  }
+  ar.Close();
+  file.Close();
+
+  m_dirty = false;
+}
+
+void CDirectoryDiskCache::Load()
+{
+  if (m_loaded)
+    return;
+  m_loaded = true;
+
+  bool valid = false;
+  CFile file;
+  if (file.Open(URIUtils::AddFileToFolder(m_cachePath, INDEX_FILE)))
+  {
+    try
+    {
+      CArchive ar(&file, CArchive::load);
+      int version;
+      ar >> version;
+      if (version == INDEX_VERSION)
+      {
+        int count;
+        ar >> count;
+        for (int i = 0; i < count; i++)
+        {
+          std::string path;
+          Entry entry;
+          ar >> path;
+          ar >> entry.mtime;
+          ar >> entry.size;
+          ar >> entry.bytes;
+          ar >> entry.lastAccess;
+          m_entries[path] = entry;
+          m_bytes += entry.bytes;
+          m_accessCounter = std::max(m_accessCounter, entry.lastAccess + 1);
+        }
+        valid = true;
+      }
+      ar.Close();
+    }
+    catch (std::out_of_range&)
+    {
+      CLog::Log(LOGERROR, "%s - corrupt index in %s", __FUNCTION__, m_cachePath.c_str());
+      m_entries.clear();
+      m_bytes = 0;
+    }
+    file.Close();
+  }
+
+  if (!valid)
+  {
+    // archives without an index are unreachable, start over
+    CDirectory::RemoveRecursive(m_cachePath);
+    CDirectory::Create(m_cachePath);
+    return;
+  }
+
+  CLog::Log(LOGDEBUG, "%s - %u listings with %" PRIu64" bytes cached", __FUNCTION__, (unsigned int)m_entries.size(), m_bytes);
+  Evict();
+}
+
+void CDirectoryDiskCache::Erase(EntryMap::iterator it)
+{
+  CFile::Delete(GetEntryFile(it->first));
+  m_bytes -= it->second.bytes;
+  m_entries.erase(it);
+  m_dirty = true;
+}
+
+void CDirectoryDiskCache::Evict()
+{
+  while (m_bytes > m_maxBytes && !m_entries.empty())
+  {
+    EntryMap::iterator oldest = m_entries.begin();
+    for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (it->second.lastAccess < oldest->second.lastAccess)
+        oldest = it;
+    }
+    Erase(oldest);
+  }
+}
+
+std::string CDirectoryDiskCache::GetEntryFile(const std::string& path) const
+{
+  return URIUtils::AddFileToFolder(m_cachePath, StringUtils::Format("%08x.fi", Crc32::Compute(path)));
+}
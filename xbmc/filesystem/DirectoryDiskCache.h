@@ -0,0 +1,84 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+class CFileItemList;
+
+namespace XFILE
+{
+  /*!
+   \brief Directory listings kept on disk across restarts
+
+   Every listing is stored in its own archive below the cache folder, with an
+   index holding the fingerprint (modification time and size) of the listed
+   directory and the size of the archive. A listing is only handed out while
+   the fingerprint of the directory still matches. When the archives exceed
+   the byte budget the least recently used ones are dropped.
+
+   Not thread safe, CDirectoryCache serializes access.
+   */
+  class CDirectoryDiskCache
+  {
+  public:
+    CDirectoryDiskCache(const std::string& cachePath, uint64_t maxBytes);
+    ~CDirectoryDiskCache();
+
+    bool Get(const std::string& path, int64_t mtime, int64_t size, CFileItemList& items);
+    void Put(const std::string& path, int64_t mtime, int64_t size, CFileItemList& items);
+    bool Contains(const std::string& path);
+    void Remove(const std::string& path);
+    void RemoveSubPaths(const std::string& path);
+
+    /*!
+     \brief Write the index if it changed since it was last written
+     */
+    void Flush();
+
+    uint64_t GetSize() const { return m_bytes; }
+
+  private:
+    struct Entry
+    {
+      int64_t mtime;
+      int64_t size;
+      uint64_t bytes;
+      unsigned int lastAccess;
+    };
+    typedef std::map<std::string, Entry> EntryMap;
+
+    void Load();
+    void Erase(EntryMap::iterator it);
+    void Evict();
+    std::string GetEntryFile(const std::string& path) const;
+
+    std::string m_cachePath;
+    uint64_t m_maxBytes;
+    uint64_t m_bytes;
+    EntryMap m_entries;
+    unsigned int m_accessCounter;
+    unsigned int m_lastSave;
+    bool m_loaded;
+    bool m_dirty;
+  };
+}
@@ -25,9 +25,11 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "ParallelRangeReader.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/URIUtils.h"
 
 #if !defined(TARGET_WINDOWS)
 #include "linux/ConvUtils.h" //GetLastError()
@@ -45,6 +47,18 @@ using namespace XFILE;
 
 #define READ_CACHE_CHUNK_SIZE (64*1024)
 
+// size of the index region prefetched from the end of mkv/mp4 files
+#define TAIL_PREFETCH_SIZE (4*1024*1024)
+
+// seconds of stream kept ahead, plus this many seconds per second of
+// measured source latency
+#define ADAPTIVE_BASE_SECONDS    20
+#define ADAPTIVE_LATENCY_SCALE   50
+#define ADAPTIVE_INTERVAL_MS     1000
+
+// size of the byte ranges requested by each connection in parallel mode
+#define PARALLEL_SEGMENT_SIZE (2*1024*1024)
+
 class CWriteRate
 {
 public:
@@ -106,6 +120,14 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_forwardCacheSize(0)
   , m_fileSize(0)
   , m_flags(flags)
+  , m_parallelFailed(false)
+  , m_adaptiveCache(NULL)
+  , m_sourceLatency(0)
+  , m_tailPos(0)
+  , m_tailSize(0)
+  , m_tailPending(false)
+  , m_readingTail(false)
+  , m_tailReady(false)
 {
 }
 
@@ -116,6 +138,14 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache /* = true */)
   , m_writeRate(0)
   , m_writeRateActual(0)
   , m_forwardCacheSize(0)
+  , m_parallelFailed(false)
+  , m_adaptiveCache(NULL)
+  , m_sourceLatency(0)
+  , m_tailPos(0)
+  , m_tailSize(0)
+  , m_tailPending(false)
+  , m_readingTail(false)
+  , m_tailReady(false)
 {
   m_pCache = pCache;
   m_bDeleteCache = bDeleteCache;
@@ -177,6 +207,19 @@ bool CFileCache::Open(const CURL& url)
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
   m_fileSize = m_source.GetLength();
 
+  // a single tcp stream may be slower than the media on high latency links,
+  // spread the transfer over several range requests instead
+  m_parallelFailed = false;
+  if (g_advancedSettings.m_cacheConnections > 1 && m_seekPossible > 0 &&
+      m_fileSize > PARALLEL_SEGMENT_SIZE * 2 &&
+      (url.IsProtocol("http") || url.IsProtocol("https") ||
+       url.IsProtocol("dav") || url.IsProtocol("davs")))
+  {
+    m_parallelSource.reset(new CParallelRangeReader(g_advancedSettings.m_cacheConnections, PARALLEL_SEGMENT_SIZE));
+    if (!m_parallelSource->Open(m_sourcePath, m_fileSize))
+      m_parallelSource.reset();
+  }
+
   if (!m_pCache)
   {
     if (g_advancedSettings.m_cacheMemSize == 0)
@@ -226,6 +269,27 @@ bool CFileCache::Open(const CURL& url)
     return false;
   }
   
+  m_adaptiveCache = NULL;
+  m_sourceLatency = 0;
+  m_tail.reset();
+  m_tailReady = false;
+  m_tailPending = false;
+  m_readingTail = false;
+
+  if (g_advancedSettings.m_cacheAdaptive && m_forwardCacheSize > 0)
+  {
+    m_adaptiveCache = dynamic_cast<CCircularCache*>(m_pCache);
+
+    // mkv cues and mp4 moov atoms usually sit at the end of the file. fetch
+    // them once so probing the index doesn't throw away the read-ahead.
+    if (m_adaptiveCache && (m_flags & READ_AUDIO_VIDEO) && m_seekPossible > 0 &&
+        URIUtils::HasExtension(url, ".mkv|.mk3d|.webm|.mp4|.m4v|.mov"))
+    {
+      m_tailSize = std::min((size_t)TAIL_PREFETCH_SIZE, (size_t)m_forwardCacheSize / 4);
+      m_tailPending = m_fileSize > (int64_t)m_tailSize * 4;
+    }
+  }
+
   m_readPos = 0;
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
@@ -257,6 +321,7 @@ void CFileCache::Process()
   CWriteRate limiter;
   CWriteRate average;
   bool cacheReachEOF = false;
+  unsigned int adaptStamp = XbmcThreads::SystemClockMillis();
 
   while (!m_bStop)
   {
@@ -272,7 +337,9 @@ void CFileCache::Process()
       bool sourceSeekFailed = false;
       if (!cacheReachEOF)
       {
-        m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
+        const unsigned int seekStart = XbmcThreads::SystemClockMillis();
+        m_nSeekResult = SeekSource(cacheMaxPos);
+        UpdateLatency(XbmcThreads::SystemClockMillis() - seekStart);
         if (m_nSeekResult != cacheMaxPos)
         {
           CLog::Log(LOGERROR,"CFileCache::Process - Error %d seeking. Seek returned %" PRId64, (int)GetLastError(), m_nSeekResult);
@@ -326,7 +393,7 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+      iRead = ReadSource(buffer.get(), maxWrite);
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -411,6 +478,127 @@ void CFileCache::Process()
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
+
+    // the head of the file is in the cache now, demuxers will look
+    // for the index next
+    if (m_tailPending && iTotalWrite > 0 && !m_bStop)
+    {
+      if (!PrefetchTail())
+      {
+        CLog::Log(LOGERROR, "CFileCache::Process - failed to restore source position after index prefetch");
+        m_bStop = true;
+        break;
+      }
+      average.Reset(m_writePos, false);
+      limiter.Reset(m_writePos);
+    }
+
+    if (m_adaptiveCache && XbmcThreads::SystemClockMillis() - adaptStamp >= ADAPTIVE_INTERVAL_MS)
+    {
+      AdaptForwardSize();
+      adaptStamp = XbmcThreads::SystemClockMillis();
+    }
+  }
+}
+
+bool CFileCache::PrefetchTail()
+{
+  m_tailPending = false;
+
+  const int64_t tailPos = m_fileSize - m_tailSize;
+  if (tailPos <= m_writePos)
+    return true; // sequential caching got there already
+
+  std::unique_ptr<char[]> tail(new char[m_tailSize]);
+  size_t total = 0;
+
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  if (SeekSource(tailPos) == tailPos)
+  {
+    while (total < m_tailSize && !m_bStop)
+    {
+      ssize_t iRead = ReadSource(tail.get() + total, m_tailSize - total);
+      if (iRead <= 0)
+        break;
+      if (total == 0)
+        UpdateLatency(XbmcThreads::SystemClockMillis() - start);
+      total += iRead;
+    }
+  }
+
+  if (total == m_tailSize)
+  {
+    m_tail = std::move(tail);
+    m_tailPos = tailPos;
+    m_tailReady = true;
+    CLog::Log(LOGDEBUG, "CFileCache::Process - prefetched %u bytes at %" PRId64" in %u ms",
+              (unsigned int)m_tailSize, tailPos, XbmcThreads::SystemClockMillis() - start);
+  }
+
+  return SeekSource(m_writePos) == m_writePos;
+}
+
+ssize_t CFileCache::ReadSource(void* lpBuf, size_t uiBufSize)
+{
+  if (m_parallelSource && !m_parallelFailed)
+  {
+    ssize_t iRead = m_parallelSource->Read(lpBuf, uiBufSize);
+    if (iRead >= 0 || m_bStop)
+      return iRead;
+
+    if (!FallbackToSource())
+      return -1;
+  }
+
+  return m_source.Read(lpBuf, uiBufSize);
+}
+
+int64_t CFileCache::SeekSource(int64_t iFilePosition)
+{
+  if (m_parallelSource && !m_parallelFailed)
+  {
+    if (!m_parallelSource->HasFailed())
+      return m_parallelSource->Seek(iFilePosition);
+
+    FallbackToSource();
+  }
+
+  return m_source.Seek(iFilePosition, SEEK_SET);
+}
+
+bool CFileCache::FallbackToSource()
+{
+  // the range connections gave up, continue where they stopped on the
+  // single connection which is still open. the reader object stays around
+  // since StopThread may abort it from another thread.
+  const int64_t pos = m_parallelSource->GetPosition();
+  CLog::Log(LOGWARNING, "CFileCache::Process - range requests failed, continuing at %" PRId64" on a single connection", pos);
+
+  m_parallelFailed = true;
+  m_parallelSource->Close();
+
+  return m_source.Seek(pos, SEEK_SET) == pos;
+}
+
+void CFileCache::UpdateLatency(unsigned int ms)
+{
+  const unsigned int latency = m_sourceLatency;
+  m_sourceLatency = latency == 0 ? ms : (latency * 7 + ms) / 8;
+}
+
+void CFileCache::AdaptForwardSize()
+{
+  // keep enough stream time ahead to ride out stalls of the source, a slow
+  // source gets a deeper window. the remainder stays as back buffer.
+  const uint64_t window = ADAPTIVE_BASE_SECONDS * 1000 + (uint64_t)m_sourceLatency * ADAPTIVE_LATENCY_SCALE;
+  const uint64_t wanted = (uint64_t)m_writeRate * window / 1000;
+
+  const int64_t forward = m_adaptiveCache->SetForwardSize((size_t)std::min(wanted, (uint64_t)SIZE_MAX));
+  if (forward != m_forwardCacheSize)
+  {
+    CLog::Log(LOGDEBUG, "CFileCache::Process - forward cache %" PRId64" bytes (rate %u, latency %u ms)",
+              forward, m_writeRate, (unsigned int)m_sourceLatency);
+    m_forwardCacheSize = forward;
   }
 }
 
@@ -449,6 +637,26 @@ ssize_t CFileCache::Read(void* lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
+  if (IsInTail(m_readPos))
+  {
+    const size_t offset = (size_t)(m_readPos - m_tailPos);
+    const size_t size = std::min(uiBufSize, m_tailSize - offset);
+    memcpy(lpBuf, m_tail.get() + offset, size);
+    m_readPos += size;
+    m_readingTail = true;
+    return size;
+  }
+
+  if (m_readingTail)
+  {
+    // ran off the end of the index copy, continue from the cache
+    m_readingTail = false;
+    if (m_readPos >= m_fileSize)
+      return 0;
+    if (SeekCache(m_readPos) != m_readPos)
+      return -1;
+  }
+
 retry:
   // attempt to read
   iRc = m_pCache->ReadFromCache((char *)lpBuf, (size_t)uiBufSize);
@@ -502,6 +710,25 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   if (iTarget == m_readPos)
     return m_readPos;
 
+  if (IsInTail(iTarget))
+  {
+    // leave the cache where it is, reading continues from there afterwards
+    m_readPos = iTarget;
+    m_readingTail = true;
+    return iTarget;
+  }
+  m_readingTail = false;
+
+  return SeekCache(iTarget);
+}
+
+bool CFileCache::IsInTail(int64_t pos) const
+{
+  return m_tailReady && pos >= m_tailPos && pos < m_tailPos + (int64_t)m_tailSize;
+}
+
+int64_t CFileCache::SeekCache(int64_t iTarget)
+{
   if ((m_nSeekResult = m_pCache->Seek(iTarget)) != iTarget)
   {
     if (m_seekPossible == 0)
@@ -511,6 +738,9 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     m_seekPos = std::min(iTarget, std::max((int64_t)0, m_fileSize - m_chunkSize));
 
     m_seekEvent.Set();
+    // the cache thread may be waiting on a slow range request
+    if (m_parallelSource)
+      m_parallelSource->Interrupt();
     if (!m_seekEnded.Wait())
     {
       CLog::Log(LOGWARNING,"%s - seek to %" PRId64" failed.", __FUNCTION__, m_seekPos);
@@ -545,6 +775,7 @@ void CFileCache::Close()
   if (m_pCache)
     m_pCache->Close();
 
+  m_parallelSource.reset();
   m_source.Close();
 }
 
@@ -563,6 +794,9 @@ void CFileCache::StopThread(bool bWait /*= true*/)
   m_bStop = true;
   //Process could be waiting for seekEvent
   m_seekEvent.Set();
+  //or for data from the parallel connections
+  if (m_parallelSource)
+    m_parallelSource->Abort();
   CThread::StopThread(bWait);
 }
 
@@ -589,7 +823,8 @@ int CFileCache::IoControl(EIoControl request, void* param)
   {
     SCacheStatus* status = (SCacheStatus*)param;
     status->forward = m_pCache->WaitForData(0, 0);
-    status->level   = (m_forwardCacheSize == 0) ? 0.0 : (float) status->forward / m_forwardCacheSize;
+    const int64_t forwardCacheSize = m_forwardCacheSize;
+    status->level   = (forwardCacheSize == 0) ? 0.0 : (float) status->forward / forwardCacheSize;
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
     return 0;
@@ -25,9 +25,12 @@
 #include "File.h"
 #include "threads/Thread.h"
 #include <atomic>
+#include <memory>
 
 namespace XFILE
 {
+  class CCircularCache;
+  class CParallelRangeReader;
 
   class CFileCache : public IFile, public CThread
   {
@@ -63,10 +66,21 @@ namespace XFILE
     virtual std::string GetContentCharset(void);
 
   private:
+    int64_t SeekCache(int64_t iTarget);
+    ssize_t ReadSource(void* lpBuf, size_t uiBufSize);
+    int64_t SeekSource(int64_t iFilePosition);
+    bool FallbackToSource();
+    bool IsInTail(int64_t pos) const;
+    bool PrefetchTail();
+    void UpdateLatency(unsigned int ms);
+    void AdaptForwardSize();
+
     CCacheStrategy *m_pCache;
     bool      m_bDeleteCache;
     int        m_seekPossible;
     CFile      m_source;
+    std::unique_ptr<CParallelRangeReader> m_parallelSource;
+    bool       m_parallelFailed; // range requests gave up, m_source took over
     std::string    m_sourcePath;
     CEvent      m_seekEvent;
     CEvent      m_seekEnded;
@@ -77,10 +91,22 @@ namespace XFILE
     unsigned     m_chunkSize;
     unsigned     m_writeRate;
     unsigned     m_writeRateActual;
-    int64_t      m_forwardCacheSize;
+    std::atomic<int64_t> m_forwardCacheSize; // resized on the cache thread, read by IoControl
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
     CCriticalSection m_sync;
+
+    // adaptive read-ahead, only set when we own a plain circular cache
+    CCircularCache *m_adaptiveCache;
+    std::atomic<unsigned int> m_sourceLatency;
+
+    // copy of the end of the file, holding the container index
+    std::unique_ptr<char[]> m_tail;
+    int64_t      m_tailPos;
+    size_t       m_tailSize;
+    bool         m_tailPending;
+    bool         m_readingTail;
+    std::atomic<bool> m_tailReady;
   };
 
 }
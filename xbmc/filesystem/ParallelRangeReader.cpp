@@ -0,0 +1,363 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ParallelRangeReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "File.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+using namespace XFILE;
+
+#define RANGE_READ_SIZE       (64*1024)
+#define RANGE_RETRIES         3
+#define RANGE_WAIT_MS         100
+
+class CParallelRangeReader::CWorker : public CThread
+{
+public:
+  CWorker(CParallelRangeReader& owner)
+    : CThread("RangeReader")
+    , m_owner(owner)
+    , m_position(-1)
+  {
+  }
+
+protected:
+  virtual void Process()
+  {
+    if (!m_file.Open(m_owner.m_url, READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED))
+    {
+      CLog::Log(LOGERROR, "CParallelRangeReader - failed to open connection to <%s>", CURL::GetRedacted(m_owner.m_url).c_str());
+      m_owner.WorkerFailed();
+      return;
+    }
+
+    bool retry = false;
+    m_file.IoControl(IOCTRL_SET_RETRY, &retry);
+    m_position = 0;
+
+    while (!m_bStop)
+    {
+      SegmentPtr segment = m_owner.GetWork(m_bStop);
+      if (segment)
+        Fetch(segment);
+    }
+
+    m_file.Close();
+  }
+
+  void Fetch(const SegmentPtr& segment)
+  {
+    // only this worker writes behind segment->filled until it hands the
+    // segment back, so the counter can be read without the lock here
+    size_t filled = segment->filled;
+    const int64_t pos = segment->pos + filled;
+
+    // consecutive segments continue on the open request
+    if (m_position != pos && m_file.Seek(pos, SEEK_SET) != pos)
+    {
+      m_position = -1;
+      m_owner.FetchFailed(segment);
+      return;
+    }
+    m_position = pos;
+
+    while (filled < segment->size && !m_bStop)
+    {
+      ssize_t iRead = m_file.Read(segment->data.get() + filled, std::min(segment->size - filled, (size_t)RANGE_READ_SIZE));
+      if (iRead <= 0)
+      {
+        m_position = -1;
+        m_owner.FetchFailed(segment);
+        return;
+      }
+
+      m_position += iRead;
+      filled += iRead;
+      if (!m_owner.AddData(segment, iRead))
+        return; // cancelled by a seek
+    }
+  }
+
+private:
+  CParallelRangeReader& m_owner;
+  CFile m_file;
+  int64_t m_position;
+};
+
+CParallelRangeReader::CParallelRangeReader(unsigned int connections, size_t segmentSize)
+  : m_connections(std::max(connections, 1U))
+  , m_segmentSize(segmentSize)
+  , m_fileSize(0)
+  , m_position(0)
+  , m_nextPos(0)
+  , m_activeWorkers(0)
+  , m_aborted(false)
+  , m_reading(false)
+  , m_interrupted(false)
+{
+}
+
+CParallelRangeReader::~CParallelRangeReader()
+{
+  Close();
+}
+
+bool CParallelRangeReader::Open(const std::string& url, int64_t fileSize)
+{
+  Close();
+
+  if (fileSize <= 0 || m_segmentSize == 0)
+    return false;
+
+  m_url = url;
+  m_fileSize = fileSize;
+  m_position = 0;
+  m_nextPos = 0;
+  m_aborted = false;
+  m_reading = false;
+  m_interrupted = false;
+  m_activeWorkers = m_connections;
+
+  {
+    CSingleLock lock(m_section);
+    FillWindow();
+  }
+
+  for (unsigned int i = 0; i < m_connections; i++)
+  {
+    CWorker* worker = new CWorker(*this);
+    m_workers.push_back(worker);
+    worker->Create();
+  }
+
+  CLog::Log(LOGDEBUG, "CParallelRangeReader::Open - reading <%s> over %u connections",
+            CURL::GetRedacted(url).c_str(), m_connections);
+  return true;
+}
+
+void CParallelRangeReader::Close()
+{
+  for (std::vector<CWorker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+    (*it)->StopThread(false);
+
+  {
+    CSingleLock lock(m_section);
+    for (std::deque<SegmentPtr>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+      (*it)->cancelled = true;
+    m_segments.clear();
+    m_cond.notifyAll();
+  }
+
+  for (std::vector<CWorker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+  {
+    (*it)->StopThread();
+    delete *it;
+  }
+  m_workers.clear();
+}
+
+void CParallelRangeReader::FillWindow()
+{
+  // two segments per connection keep every connection busy while the
+  // reader drains the head of the queue
+  while (m_segments.size() < m_connections * 2 && m_nextPos < m_fileSize)
+  {
+    SegmentPtr segment(new Segment);
+    segment->pos = m_nextPos;
+    segment->size = (size_t)std::min((int64_t)m_segmentSize, m_fileSize - m_nextPos);
+    segment->filled = 0;
+    segment->consumed = 0;
+    segment->state = SegmentPending;
+    segment->retries = 0;
+    segment->cancelled = false;
+    segment->data.reset(new char[segment->size]);
+
+    m_segments.push_back(segment);
+    m_nextPos += segment->size;
+  }
+  m_cond.notifyAll();
+}
+
+CParallelRangeReader::SegmentPtr CParallelRangeReader::GetWork(const bool& stop)
+{
+  CSingleLock lock(m_section);
+
+  // the segment closest to the read position goes first
+  for (std::deque<SegmentPtr>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if ((*it)->state == SegmentPending)
+    {
+      (*it)->state = SegmentFetching;
+      return *it;
+    }
+  }
+
+  if (!stop)
+    m_cond.wait(lock, RANGE_WAIT_MS);
+
+  return SegmentPtr();
+}
+
+bool CParallelRangeReader::AddData(const SegmentPtr& segment, size_t size)
+{
+  CSingleLock lock(m_section);
+  if (segment->cancelled)
+    return false;
+
+  segment->filled += size;
+  segment->retries = 0;
+  m_cond.notifyAll();
+  return true;
+}
+
+void CParallelRangeReader::FetchFailed(const SegmentPtr& segment)
+{
+  CSingleLock lock(m_section);
+  if (segment->cancelled)
+    return;
+
+  // resume behind the data we already have, give up only if the
+  // connection keeps failing without making progress
+  if (++segment->retries < RANGE_RETRIES)
+    segment->state = SegmentPending;
+  else
+  {
+    CLog::Log(LOGERROR, "CParallelRangeReader - failed to fetch %u bytes at %" PRId64,
+              (unsigned int)(segment->size - segment->filled), segment->pos + segment->filled);
+    segment->state = SegmentFailed;
+  }
+  m_cond.notifyAll();
+}
+
+void CParallelRangeReader::WorkerFailed()
+{
+  CSingleLock lock(m_section);
+  if (--m_activeWorkers > 0)
+    return;
+
+  for (std::deque<SegmentPtr>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    (*it)->state = SegmentFailed;
+  m_cond.notifyAll();
+}
+
+ssize_t CParallelRangeReader::Read(void* lpBuf, size_t uiBufSize)
+{
+  CSingleLock lock(m_section);
+
+  // a slow link is no reason to give up, wait for as long as the
+  // connections keep trying unless the caller has something else to do
+  m_reading = true;
+  m_interrupted = false;
+  ssize_t result = -1;
+  while (!m_aborted)
+  {
+    if (m_segments.empty())
+    {
+      result = 0;
+      break;
+    }
+
+    SegmentPtr segment = m_segments.front();
+    if (segment->filled > segment->consumed)
+    {
+      size_t size = std::min(uiBufSize, segment->filled - segment->consumed);
+      memcpy(lpBuf, segment->data.get() + segment->consumed, size);
+      segment->consumed += size;
+      m_position += size;
+
+      if (segment->consumed == segment->size)
+      {
+        m_segments.pop_front();
+        FillWindow();
+      }
+      result = size;
+      break;
+    }
+
+    if (segment->state == SegmentFailed)
+      break;
+
+    if (m_interrupted)
+    {
+      result = 0;
+      break;
+    }
+
+    m_cond.wait(lock, RANGE_WAIT_MS);
+  }
+
+  m_reading = false;
+  m_interrupted = false;
+  return result;
+}
+
+int64_t CParallelRangeReader::Seek(int64_t pos)
+{
+  CSingleLock lock(m_section);
+
+  if (pos < 0 || pos > m_fileSize)
+    return -1;
+
+  for (std::deque<SegmentPtr>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    (*it)->cancelled = true;
+  m_segments.clear();
+
+  m_position = pos;
+  m_nextPos = pos;
+  FillWindow();
+
+  return pos;
+}
+
+int64_t CParallelRangeReader::GetPosition()
+{
+  CSingleLock lock(m_section);
+  return m_position;
+}
+
+void CParallelRangeReader::Interrupt()
+{
+  CSingleLock lock(m_section);
+  if (m_reading)
+  {
+    m_interrupted = true;
+    m_cond.notifyAll();
+  }
+}
+
+bool CParallelRangeReader::HasFailed()
+{
+  CSingleLock lock(m_section);
+  return m_activeWorkers == 0;
+}
+
+void CParallelRangeReader::Abort()
+{
+  CSingleLock lock(m_section);
+  m_aborted = true;
+  m_cond.notifyAll();
+}
@@ -0,0 +1,124 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "PlatformDefs.h" // for ssize_t
+
+namespace XFILE
+{
+  /*!
+   \brief Reads a file sequentially through several connections
+
+   The file is split into segments which worker threads fetch with their own
+   byte range requests. Read() hands the data out in file order, so a caller
+   sees a plain sequential stream while the transfer is spread over as many
+   connections as configured. Only a small window of segments ahead of the
+   read position is in flight at any time.
+   */
+  class CParallelRangeReader
+  {
+  public:
+    CParallelRangeReader(unsigned int connections, size_t segmentSize);
+    ~CParallelRangeReader();
+
+    bool Open(const std::string& url, int64_t fileSize);
+    void Close();
+
+    /*!
+     \brief Read the next bytes in file order, waits until data arrives
+     \return number of bytes read, 0 at end of file or when interrupted,
+             -1 if a segment could not be fetched or after Abort()
+     */
+    ssize_t Read(void* lpBuf, size_t uiBufSize);
+
+    /*!
+     \brief Drop all segments in flight and continue at the given position
+     */
+    int64_t Seek(int64_t pos);
+    int64_t GetPosition();
+
+    /*!
+     \brief Make a Read() which is waiting for data return 0, e.g. to handle a seek
+     */
+    void Interrupt();
+
+    /*!
+     \brief Make a blocked Read() return
+     */
+    void Abort();
+
+    /*!
+     \brief True if none of the connections could be opened
+     */
+    bool HasFailed();
+
+  private:
+    class CWorker;
+    friend class CWorker;
+
+    enum SegmentState
+    {
+      SegmentPending,
+      SegmentFetching,
+      SegmentFailed
+    };
+
+    struct Segment
+    {
+      int64_t pos;
+      size_t size;
+      size_t filled;
+      size_t consumed;
+      SegmentState state;
+      unsigned int retries;
+      bool cancelled;
+      std::unique_ptr<char[]> data;
+    };
+    typedef std::shared_ptr<Segment> SegmentPtr;
+
+    void FillWindow();
+    SegmentPtr GetWork(const bool& stop);
+    bool AddData(const SegmentPtr& segment, size_t size);
+    void FetchFailed(const SegmentPtr& segment);
+    void WorkerFailed();
+
+    unsigned int m_connections;
+    size_t m_segmentSize;
+    std::string m_url;
+    int64_t m_fileSize;
+    int64_t m_position;
+    int64_t m_nextPos;
+    unsigned int m_activeWorkers;
+    bool m_aborted;
+    bool m_reading;
+    bool m_interrupted;
+    std::deque<SegmentPtr> m_segments;
+    std::vector<CWorker*> m_workers;
+    CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_cond;
+  };
+}
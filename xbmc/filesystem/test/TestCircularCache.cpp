@@ -0,0 +1,66 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CircularCache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+TEST(TestCircularCache, ForwardSizeClamped)
+{
+  CCircularCache cache(768, 256);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  EXPECT_EQ(768U, cache.GetForwardSize());
+  EXPECT_EQ(256U, cache.SetForwardSize(0));
+  EXPECT_EQ(896U, cache.SetForwardSize(1 << 20));
+  EXPECT_EQ(512U, cache.SetForwardSize(512));
+  EXPECT_EQ(512U, cache.GetForwardSize());
+
+  cache.Close();
+}
+
+TEST(TestCircularCache, ForwardSizeLimitsWrite)
+{
+  CCircularCache cache(768, 256);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // fill the whole buffer and consume it, everything is back buffer now
+  std::vector<char> data(1024, 'x');
+  ASSERT_EQ(1024, cache.WriteToCache(data.data(), data.size()));
+  ASSERT_EQ(1024, cache.ReadFromCache(data.data(), data.size()));
+  EXPECT_EQ(768U, cache.GetMaxWriteSize(4096));
+
+  // a larger forward window gives up back buffer
+  cache.SetForwardSize(896);
+  EXPECT_EQ(896U, cache.GetMaxWriteSize(4096));
+
+  // a smaller one keeps more of it
+  cache.SetForwardSize(256);
+  EXPECT_EQ(256U, cache.GetMaxWriteSize(4096));
+
+  // data that is already read can still be seeked back to
+  EXPECT_TRUE(cache.IsCachedPosition(1024 - 768));
+
+  cache.Close();
+}
@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryDiskCache.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+#define CACHE_PATH "special://temp/test_directory_cache/"
+
+class TestDirectoryDiskCache : public testing::Test
+{
+protected:
+  virtual void TearDown()
+  {
+    CDirectory::RemoveRecursive(CACHE_PATH);
+  }
+
+  void FillItems(CFileItemList& items, const std::string& path)
+  {
+    items.SetPath(path);
+    items.Add(CFileItemPtr(new CFileItem(path + "movie.mkv", false)));
+    items.Add(CFileItemPtr(new CFileItem(path + "extras/", true)));
+  }
+};
+
+TEST_F(TestDirectoryDiskCache, ValidatesFingerprint)
+{
+  CDirectoryDiskCache cache(CACHE_PATH, 1024 * 1024);
+
+  CFileItemList items;
+  FillItems(items, "smb://server/share/a/");
+  cache.Put("smb://server/share/a", 1000, 4096, items);
+
+  CFileItemList result;
+  ASSERT_TRUE(cache.Get("smb://server/share/a", 1000, 4096, result));
+  ASSERT_EQ(2, result.Size());
+  EXPECT_EQ("smb://server/share/a/movie.mkv", result[0]->GetPath());
+  EXPECT_TRUE(result[1]->m_bIsFolder);
+
+  // the directory changed, the listing is gone for good
+  result.Clear();
+  EXPECT_FALSE(cache.Get("smb://server/share/a", 1001, 4096, result));
+  EXPECT_FALSE(cache.Contains("smb://server/share/a"));
+  EXPECT_EQ(0U, cache.GetSize());
+}
+
+TEST_F(TestDirectoryDiskCache, SurvivesRestart)
+{
+  {
+    CDirectoryDiskCache cache(CACHE_PATH, 1024 * 1024);
+    CFileItemList items;
+    FillItems(items, "nfs://server/export/b/");
+    cache.Put("nfs://server/export/b", 2000, 512, items);
+    cache.Flush();
+  }
+
+  CDirectoryDiskCache cache(CACHE_PATH, 1024 * 1024);
+  CFileItemList result;
+  ASSERT_TRUE(cache.Get("nfs://server/export/b", 2000, 512, result));
+  EXPECT_EQ(2, result.Size());
+}
+
+TEST_F(TestDirectoryDiskCache, EvictsLeastRecentlyUsed)
+{
+  uint64_t entrySize;
+  {
+    CDirectoryDiskCache cache(CACHE_PATH, 1024 * 1024);
+    CFileItemList items;
+    FillItems(items, "smb://server/share/1/");
+    cache.Put("smb://server/share/1", 1, 1, items);
+    entrySize = cache.GetSize();
+    cache.Remove("smb://server/share/1");
+    cache.Flush();
+  }
+  ASSERT_GT(entrySize, 0U);
+
+  // room for two listings
+  CDirectoryDiskCache cache(CACHE_PATH, entrySize * 2 + entrySize / 2);
+  for (int i = 1; i <= 2; i++)
+  {
+    CFileItemList items;
+    FillItems(items, StringUtils::Format("smb://server/share/%i/", i));
+    cache.Put(StringUtils::Format("smb://server/share/%i", i), 1, 1, items);
+  }
+
+  CFileItemList result;
+  ASSERT_TRUE(cache.Get("smb://server/share/1", 1, 1, result));
+
+  CFileItemList items;
+  FillItems(items, "smb://server/share/3/");
+  cache.Put("smb://server/share/3", 1, 1, items);
+
+  EXPECT_TRUE(cache.Contains("smb://server/share/1"));
+  EXPECT_FALSE(cache.Contains("smb://server/share/2"));
+  EXPECT_TRUE(cache.Contains("smb://server/share/3"));
+  EXPECT_LE(cache.GetSize(), entrySize * 2 + entrySize / 2);
+}
@@ -23,6 +23,7 @@
 #include "utils/log.h"
 #include <stdio.h>
 #include "DirtyRegionSolvers.h"
+#include "GraphicContext.h"
 
 CDirtyRegionTracker::CDirtyRegionTracker(int buffering)
 {
@@ -72,12 +73,32 @@ const CDirtyRegionList &CDirtyRegionTracker::GetMarkedRegions() const
   return m_markedRegions;
 }
 
-CDirtyRegionList CDirtyRegionTracker::GetDirtyRegions()
+CDirtyRegionList CDirtyRegionTracker::GetDirtyRegions(int bufferAge /* = -1 */)
 {
   CDirtyRegionList output;
 
-  if (m_solver)
+  if (!m_solver)
+    return output;
+
+  if (bufferAge < 0)
     m_solver->Solve(m_markedRegions, output);
+  else if (bufferAge == 0 || bufferAge > m_buffering)
+  {
+    // we don't know what's in the back buffer, so anything changing means rendering all of it
+    if (!m_markedRegions.empty())
+      output.push_back(CDirtyRegion(g_graphicsContext.GetViewWindow()));
+  }
+  else
+  {
+    // the back buffer misses what changed since it was last rendered to
+    CDirtyRegionList regions;
+    for (CDirtyRegionList::const_iterator i = m_markedRegions.begin(); i != m_markedRegions.end(); ++i)
+    {
+      if (i->GetAge() < bufferAge)
+        regions.push_back(*i);
+    }
+    m_solver->Solve(regions, output);
+  }
 
   return output;
 }
@@ -36,7 +36,13 @@ public:
   void MarkDirtyRegion(const CDirtyRegion &region);
 
   const CDirtyRegionList &GetMarkedRegions() const;
-  CDirtyRegionList GetDirtyRegions();
+
+  /*! \brief Get the regions that need to be rendered this frame.
+   \param bufferAge number of frames since the back buffer was last rendered to, 0 if its content is undefined
+                    and -1 if unknown, in which case regions are rendered for a fixed number of frames.
+   \return the regions to render.
+   */
+  CDirtyRegionList GetDirtyRegions(int bufferAge = -1);
   void CleanMarkedRegions();
 
 private:
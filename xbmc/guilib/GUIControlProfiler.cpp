@@ -22,11 +22,12 @@
 #include "utils/XBMCTinyXML.h"
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/log.h"
 
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
-: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_i64VisStart(0), m_i64RenderStart(0)
+: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_renderCount(0), m_i64VisStart(0), m_i64RenderStart(0)
 {
   if (m_pControl)
   {
@@ -54,6 +55,7 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
 
   m_visTime = 0;
   m_renderTime = 0;
+  m_renderCount = 0;
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
     delete m_vecChildren[i];
@@ -80,6 +82,7 @@ void CGUIControlProfilerItem::BeginRender(void)
 void CGUIControlProfilerItem::EndRender(void)
 {
   m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64RenderStart));
+  m_renderCount++;
 }
 
 void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
@@ -175,23 +178,36 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
     elem->LinkEndChild(text);
   }
 
-  // Note time is stored in 1/100 milliseconds but reported in ms
-  unsigned int vis = m_visTime / 100;
-  unsigned int rend = m_renderTime / 100;
-  if (vis || rend)
+  // times are in microseconds, rendering per frame is what a skin should keep low
+  if (m_visTime || m_renderTime)
   {
     std::string val;
     TiXmlElement *elem = new TiXmlElement("rendertime");
     xmlControl->LinkEndChild(elem);
-    val = StringUtils::Format("%u", rend);
+    val = StringUtils::Format("%u", m_renderTime);
     TiXmlText *text = new TiXmlText(val.c_str());
     elem->LinkEndChild(text);
 
     elem = new TiXmlElement("visibletime");
     xmlControl->LinkEndChild(elem);
-    val = StringUtils::Format("%u", vis);
+    val = StringUtils::Format("%u", m_visTime);
     text = new TiXmlText(val.c_str());
     elem->LinkEndChild(text);
+
+    elem = new TiXmlElement("rendercount");
+    xmlControl->LinkEndChild(elem);
+    val = StringUtils::Format("%u", m_renderCount);
+    text = new TiXmlText(val.c_str());
+    elem->LinkEndChild(text);
+
+    if (m_pProfiler->GetFrameCount() > 0)
+    {
+      elem = new TiXmlElement("renderperframe");
+      xmlControl->LinkEndChild(elem);
+      val = StringUtils::Format("%u", m_renderTime / m_pProfiler->GetFrameCount());
+      text = new TiXmlText(val.c_str());
+      elem->LinkEndChild(text);
+    }
   }
 
   if (m_vecChildren.size())
@@ -232,7 +248,7 @@ CGUIControlProfiler::CGUIControlProfiler(void)
 : m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0)
 // m_bIsRunning(false), no isRunning because it is static
 {
-  m_fPerfScale = 100000.0f / CurrentHostFrequency();
+  m_fPerfScale = 1000000.0f / CurrentHostFrequency();
 }
 
 CGUIControlProfiler &CGUIControlProfiler::Instance(void)
@@ -337,9 +353,13 @@ bool CGUIControlProfiler::SaveResults(void)
   TiXmlElement *root = new TiXmlElement("guicontrolprofiler");
   std::string str = StringUtils::Format("%d", m_iFrameCount);
   root->SetAttribute("framecount", str.c_str());
-  root->SetAttribute("timeunit", "ms");
+  root->SetAttribute("timeunit", "us");
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
-  return doc.SaveFile(m_strOutputFile);
+  if (!doc.SaveFile(m_strOutputFile))
+    return false;
+
+  CLog::Log(LOGNOTICE, "GUI control profile of %d frames saved to %s", m_iFrameCount, m_strOutputFile.c_str());
+  return true;
 }
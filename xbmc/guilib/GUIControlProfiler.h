@@ -39,8 +39,9 @@ public:
   std::string m_strDescription;
   int m_controlID;
   CGUIControl::GUICONTROLTYPES m_ControlType;
-  unsigned int m_visTime;
-  unsigned int m_renderTime;
+  unsigned int m_visTime;     ///< time spent on visibility checks, in microseconds
+  unsigned int m_renderTime;  ///< time spent rendering, including children, in microseconds
+  unsigned int m_renderCount;
   int64_t m_i64VisStart;
   int64_t m_i64RenderStart;
 
@@ -72,6 +73,7 @@ public:
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
+  int GetFrameCount(void) const { return m_iFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
   const std::string &GetOutputFile(void) const { return m_strOutputFile; };
@@ -21,6 +21,7 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GraphicContext.h"
+#include "GUITextLayout.h"
 
 #include "Application.h"
 #include "threads/SingleLock.h"
@@ -83,6 +84,7 @@ CGUIFont::~CGUIFont()
 {
   if (m_font)
     m_font->RemoveReference();
+  CGUITextLayout::InvalidateLineCache();
 }
 
 std::string& CGUIFont::GetFontName()
@@ -297,4 +299,5 @@ void CGUIFont::SetFont(CGUIFontTTFBase *font)
   m_font = font;
   if (m_font)
     m_font->AddReference();
+  CGUITextLayout::InvalidateLineCache();
 }
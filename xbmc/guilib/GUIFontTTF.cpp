@@ -56,6 +56,7 @@
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
+#define GLYPH_TEXTURE_BUDGET (16 * 1024 * 1024) // bytes of glyph textures all fonts may grow to combined
 
 
 class CFreeTypeLibrary
@@ -174,6 +175,9 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
   m_posX = m_posY = 0;
+  m_posLine = 0;
+  m_useStamp = 0;
+  m_textureBytes = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -207,6 +211,8 @@ void CGUIFontTTFBase::ClearCharacterCache()
   DeleteHardwareTexture();
 
   m_texture = NULL;
+  UpdateTextureBytes();
+  m_lineStamps.clear();
   delete[] m_char;
   m_char = new Character[CHAR_CHUNK];
   memset(m_charquick, 0, sizeof(m_charquick));
@@ -222,6 +228,8 @@ void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
   m_texture = NULL;
+  UpdateTextureBytes();
+  m_lineStamps.clear();
   delete[] m_char;
   memset(m_charquick, 0, sizeof(m_charquick));
   m_char = NULL;
@@ -305,6 +313,8 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   delete(m_texture);
   m_texture = NULL;
+  UpdateTextureBytes();
+  m_lineStamps.clear();
   delete[] m_char;
   m_char = NULL;
 
@@ -357,6 +367,9 @@ void CGUIFontTTFBase::End()
 
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
+  // texture lines holding glyphs of this string must not be reused while drawing it
+  m_useStamp++;
+
   Begin();
 
   uint32_t rawAlignment = alignment;
@@ -598,6 +611,7 @@ float CGUIFontTTFBase::GetLineHeight(float lineSpacing) const
 }
 
 const unsigned int CGUIFontTTFBase::spacing_between_characters_in_texture = 1;
+size_t CGUIFontTTFBase::m_allTextureBytes = 0;
 
 unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
 {
@@ -614,19 +628,16 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     return NULL;
 
   // quick access to ascii chars
+  Character *found = NULL;
   if (letter < 255)
-  {
-    character_t ch = (style << 8) | letter;
-    if (m_charquick[ch])
-      return m_charquick[ch];
-  }
+    found = m_charquick[(style << 8) | letter];
 
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
   int low = 0;
   int high = m_numChars - 1;
-  while (low <= high)
+  while (!found && low <= high)
   {
     int mid = (low + high) >> 1;
     if (ch > m_char[mid].letterAndStyle)
@@ -634,7 +645,32 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     else if (ch < m_char[mid].letterAndStyle)
       high = mid - 1;
     else
-      return &m_char[mid];
+      found = &m_char[mid];
+  }
+
+  if (found)
+  {
+    if (found->textureLine < TEXTURE_LINE_EVICTED)
+    {
+      m_lineStamps[found->textureLine] = m_useStamp;
+      return found;
+    }
+    if (found->textureLine == TEXTURE_LINE_NONE)
+      return found;
+
+    // the glyph's texture line has been reused - render it again in place
+    unsigned int nestedBeginCount = m_nestedBeginCount;
+    m_nestedBeginCount = 1;
+    if (nestedBeginCount) End();
+    bool cached = CacheCharacter(letter, style, found);
+    if (nestedBeginCount) Begin();
+    m_nestedBeginCount = nestedBeginCount;
+    if (cached)
+      return found;
+
+    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    ClearCharacterCache();
+    return GetCharacter(chr);
   }
   // if we get to here, then low is where we should insert the new character
 
@@ -656,6 +692,7 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   { // just move the data along as necessary
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
+  m_numChars++;
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
   unsigned int nestedBeginCount = m_nestedBeginCount;
@@ -666,9 +703,11 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
     ClearCharacterCache();
     low = 0;
+    m_numChars = 1;
     if (!CacheCharacter(letter, style, m_char + low))
     {
       CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
+      m_numChars = 0;
       if (nestedBeginCount) Begin();
       m_nestedBeginCount = nestedBeginCount;
       return NULL;
@@ -735,34 +774,14 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
     // check we have enough room for the character
     if ((m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
-
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
+    { // no space - gotta move on to a fresh line
+      if (!NextTextureLine())
       {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > g_Windowing.GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
-
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+        FT_Done_Glyph(glyph);
+        return false;
       }
+      if (bitGlyph->left < 0)
+        m_posX += -bitGlyph->left;
     }
 
     if(m_texture == NULL)
@@ -781,6 +800,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->textureLine = isEmptyGlyph ? TEXTURE_LINE_NONE : m_posLine;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -794,7 +814,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
   }
-  m_numChars++;
 
   // free the glyph
   FT_Done_Glyph(glyph);
@@ -802,6 +821,94 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   return true;
 }
 
+bool CGUIFontTTFBase::NextTextureLine()
+{
+  const unsigned int lineHeight = GetTextureLineHeight();
+  const unsigned int newY = m_lineStamps.size() * lineHeight;
+
+  if (newY + lineHeight >= m_textureHeight)
+  {
+    // create the new larger texture, unless we hit the size limits
+    unsigned int newHeight = newY + lineHeight;
+    bool overBudget = m_texture && m_allTextureBytes + (newHeight - m_textureHeight) * m_textureWidth > GLYPH_TEXTURE_BUDGET;
+    if (newHeight > g_Windowing.GetMaxTextureSize() || overBudget)
+    {
+      if (EvictTextureLine())
+        return true;
+      CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
+      return false;
+    }
+
+    CBaseTexture* newTexture = ReallocTexture(newHeight);
+    if (newTexture == NULL)
+    {
+      CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
+      return false;
+    }
+    m_texture = newTexture;
+    UpdateTextureBytes();
+  }
+
+  m_posX = 0;
+  m_posY = newY;
+  m_posLine = m_lineStamps.size();
+  m_lineStamps.push_back(m_useStamp);
+  return true;
+}
+
+bool CGUIFontTTFBase::EvictTextureLine()
+{
+  // find the least recently used line, sparing the one we are filling and
+  // those used by the string currently being drawn
+  unsigned int line = m_lineStamps.size();
+  for (unsigned int i = 0; i < m_lineStamps.size(); i++)
+  {
+    if (i == m_posLine || m_lineStamps[i] == m_useStamp)
+      continue;
+    if (line == m_lineStamps.size() || m_useStamp - m_lineStamps[i] > m_useStamp - m_lineStamps[line])
+      line = i;
+  }
+  if (line == m_lineStamps.size() || !m_texture)
+    return false;
+
+  // forget the glyphs on that line, they are rendered again when next used
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].textureLine == line)
+      m_char[i].textureLine = TEXTURE_LINE_EVICTED;
+  }
+
+  // blank the line so that old glyphs don't bleed into new ones
+  const unsigned int lineHeight = GetTextureLineHeight();
+  const unsigned int y1 = line * lineHeight;
+  const unsigned int y2 = std::min(y1 + lineHeight, m_textureHeight);
+  std::vector<unsigned char> blank(m_textureWidth * lineHeight);
+  FT_BitmapGlyphRec blankGlyph;
+  memset(&blankGlyph, 0, sizeof(blankGlyph));
+  blankGlyph.bitmap.width = m_textureWidth;
+  blankGlyph.bitmap.rows = lineHeight;
+  blankGlyph.bitmap.pitch = m_textureWidth;
+  blankGlyph.bitmap.buffer = &blank[0];
+  CopyCharToTexture(&blankGlyph, 0, y1, m_textureWidth, y2);
+
+  // cached vertices may refer to the old glyphs
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
+
+  m_posX = 0;
+  m_posY = y1;
+  m_posLine = line;
+  m_lineStamps[line] = m_useStamp;
+  return true;
+}
+
+void CGUIFontTTFBase::UpdateTextureBytes()
+{
+  size_t bytes = m_texture ? m_texture->GetPitch() * m_texture->GetRows() : 0;
+  m_allTextureBytes += bytes - m_textureBytes;
+  m_textureBytes = bytes;
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices)
 {
   // actual image width isn't same as the character width as that is
@@ -110,6 +110,12 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned short textureLine;  // line of our texture holding the glyph, or one of the TEXTURE_LINE_* values
+  };
+  enum
+  {
+    TEXTURE_LINE_EVICTED = 0xfffe,   // glyph was dropped from the texture and needs rendering again
+    TEXTURE_LINE_NONE    = 0xffff    // glyph has no pixels
   };
   void AddReference();
   void RemoveReference();
@@ -132,6 +138,9 @@ protected:
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
+  bool NextTextureLine();
+  bool EvictTextureLine();
+  void UpdateTextureBytes();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
@@ -147,6 +156,19 @@ protected:
   unsigned int m_textureHeight;      // heigth of our texture
   int m_posX;                        // current position in the texture
   int m_posY;
+  unsigned int m_posLine;            // texture line m_posY is on
+
+  /*! \brief when each texture line was last used, indexed by line.
+   Once the texture can't grow any further, the least recently used line is reused.
+   */
+  std::vector<unsigned int> m_lineStamps;
+  unsigned int m_useStamp;           // bumped for every string drawn
+
+  /*! \brief size of our texture, and of all font textures combined.
+   Fonts stop growing their texture once the combined size exceeds the budget.
+   */
+  size_t m_textureBytes;
+  static size_t m_allTextureBytes;
 
   /*! \brief the height of each line in the texture.
    Accounts for spacing between lines to avoid characters overlapping.
@@ -25,6 +25,7 @@
 #include "Texture.h"
 #include "TextureManager.h"
 #include "GraphicContext.h"
+#include "GUITexture.h"
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -57,6 +58,9 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
 
 bool CGUIFontTTFGL::FirstBegin()
 {
+  // draw the textures batched so far before the font changes the render state
+  CGUITexture::FlushBatch();
+
   if (m_textureStatus == TEXTURE_REALLOCATED)
   {
     if (glIsTexture(m_nTexture))
@@ -153,6 +157,7 @@ void CGUIFontTTFGL::LastEnd()
   glEnableClientState(GL_VERTEX_ARRAY);
   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
   glDrawArrays(GL_QUADS, 0, m_vertex.size());
+  g_graphicsContext.AddDrawCall(m_vertex.size());
   glPopClientAttrib();
 
   glActiveTexture(GL_TEXTURE1);
@@ -202,6 +207,7 @@ void CGUIFontTTFGL::LastEnd()
     glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
 
     glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    g_graphicsContext.AddDrawCall(vecVertices.size());
   }
   if (!m_vertexTrans.empty())
   {
@@ -248,6 +254,7 @@ void CGUIFontTTFGL::LastEnd()
         glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
 
         glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+        g_graphicsContext.AddDrawCall(4 * count);
       }
 
       glMatrixModview.Pop();
@@ -22,9 +22,56 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "GraphicContext.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+#define LINE_CACHE_SIZE 256 // number of laid out texts shared between all text layouts
+
+/* Wrapped and bidi transformed lines of a text, shared between all text layouts
+ so that strings shown by several controls, or shown again after scrolling back,
+ are only measured and wrapped once.
+ */
+struct CCachedLines
+{
+  size_t hash;
+  unsigned int generation;
+  const CGUIFont *font;
+  bool wrap;
+  float maxWidth;
+  float maxHeight;
+  float scaleX;
+  float scaleY;
+  bool forceLTRReadingOrder;
+  vecText text;
+  std::vector<CGUIString> lines;
+  float textWidth;
+  float textHeight;
+};
+
+typedef std::list<CCachedLines> LineCache; // most recently used first
+
+static CCriticalSection lineCacheSection;
+static LineCache lineCache;
+static std::unordered_multimap<size_t, LineCache::iterator> lineCacheIndex;
+// fonts may be released during static destruction, so invalidating must not touch the containers above
+static std::atomic<unsigned int> lineCacheGeneration(0);
+
+static size_t HashText(const vecText &text)
+{
+  // FNV-1a over the styled characters
+  size_t hash = 2166136261U;
+  for (vecText::const_iterator i = text.begin(); i != text.end(); ++i)
+    hash = (hash ^ *i) * 16777619U;
+  return hash;
+}
+
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
   m_text.assign(start, end);
@@ -253,6 +300,14 @@ void CGUITextLayout::UpdateStyled(const vecText &text, const vecColors &colors,
   m_lines.clear();
   m_colors = colors;
 
+  // maxWidth doesn't matter if we don't wrap
+  if (!m_wrap)
+    maxWidth = 0;
+
+  size_t hash = HashText(text);
+  if (GetCachedLines(hash, text, maxWidth, forceLTRReadingOrder))
+    return;
+
   // if we need to wrap the text, then do so
   if (m_wrap && maxWidth > 0)
     WrapText(text, maxWidth);
@@ -267,6 +322,82 @@ void CGUITextLayout::UpdateStyled(const vecText &text, const vecColors &colors,
 
   // and cache the width and height for later reading
   CalcTextExtent();
+
+  CacheLines(hash, text, maxWidth, forceLTRReadingOrder);
+}
+
+bool CGUITextLayout::GetCachedLines(size_t hash, const vecText &text, float maxWidth, bool forceLTRReadingOrder)
+{
+  unsigned int generation = lineCacheGeneration;
+  float scaleX = g_graphicsContext.GetGUIScaleX();
+  float scaleY = g_graphicsContext.GetGUIScaleY();
+
+  CSingleLock lock(lineCacheSection);
+  auto range = lineCacheIndex.equal_range(hash);
+  for (auto i = range.first; i != range.second; ++i)
+  {
+    const CCachedLines &entry = *i->second;
+    if (entry.generation == generation &&
+        entry.font == m_font &&
+        entry.wrap == m_wrap &&
+        entry.maxWidth == maxWidth &&
+        entry.maxHeight == m_maxHeight &&
+        entry.scaleX == scaleX &&
+        entry.scaleY == scaleY &&
+        entry.forceLTRReadingOrder == forceLTRReadingOrder &&
+        entry.text == text)
+    {
+      m_lines = entry.lines;
+      m_textWidth = entry.textWidth;
+      m_textHeight = entry.textHeight;
+      lineCache.splice(lineCache.begin(), lineCache, i->second);
+      return true;
+    }
+  }
+  return false;
+}
+
+void CGUITextLayout::CacheLines(size_t hash, const vecText &text, float maxWidth, bool forceLTRReadingOrder) const
+{
+  CCachedLines entry;
+  entry.hash = hash;
+  entry.generation = lineCacheGeneration;
+  entry.font = m_font;
+  entry.wrap = m_wrap;
+  entry.maxWidth = maxWidth;
+  entry.maxHeight = m_maxHeight;
+  entry.scaleX = g_graphicsContext.GetGUIScaleX();
+  entry.scaleY = g_graphicsContext.GetGUIScaleY();
+  entry.forceLTRReadingOrder = forceLTRReadingOrder;
+  entry.text = text;
+  entry.lines = m_lines;
+  entry.textWidth = m_textWidth;
+  entry.textHeight = m_textHeight;
+
+  CSingleLock lock(lineCacheSection);
+  lineCache.push_front(entry);
+  lineCacheIndex.insert(std::make_pair(hash, lineCache.begin()));
+
+  // drop the least recently used entry
+  if (lineCache.size() > LINE_CACHE_SIZE)
+  {
+    LineCache::iterator last = --lineCache.end();
+    auto range = lineCacheIndex.equal_range(last->hash);
+    for (auto i = range.first; i != range.second; ++i)
+    {
+      if (i->second == last)
+      {
+        lineCacheIndex.erase(i);
+        break;
+      }
+    }
+    lineCache.erase(last);
+  }
+}
+
+void CGUITextLayout::InvalidateLineCache()
+{
+  lineCacheGeneration++;
 }
 
 // BidiTransform is used to handle RTL text flipping in the string
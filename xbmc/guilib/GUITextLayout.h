@@ -111,12 +111,19 @@ public:
   static void DrawText(CGUIFont *font, float x, float y, color_t color, color_t shadowColor, const std::string &text, uint32_t align);
   static void Filter(std::string &text);
 
+  /*! \brief Invalidate all cached line layouts
+   Called whenever a font is replaced or released, as the cached lines depend on its metrics.
+   */
+  static void InvalidateLineCache();
+
 protected:
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
   void WrapText(const vecText &text, float maxWidth);
   static void BidiTransform(std::vector<CGUIString> &lines, bool forceLTRReadingOrder);
   static std::wstring BidiFlip(const std::wstring &text, bool forceLTRReadingOrder);
   void CalcTextExtent();
+  bool GetCachedLines(size_t hash, const vecText &text, float maxWidth, bool forceLTRReadingOrder);
+  void CacheLines(size_t hash, const vecText &text, float maxWidth, bool forceLTRReadingOrder) const;
   void UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder);
   
   /*! \brief Returns the text, utf8 encoded
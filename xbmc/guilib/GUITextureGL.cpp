@@ -26,6 +26,7 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/Geometry.h"
+#include "guilib/GraphicContext.h"
 #include "windowing/WindowingFactory.h"
 
 #if defined(HAS_GL)
@@ -34,6 +35,7 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
 : CGUITextureBase(posX, posY, width, height, texture)
 {
   memset(m_col, 0, sizeof(m_col));
+  m_vertices = 0;
 }
 
 void CGUITextureGL::Begin(color_t color)
@@ -113,11 +115,13 @@ void CGUITextureGL::Begin(color_t color)
   //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
   //glBegin(GL_LINE_LOOP);
   glBegin(GL_QUADS);
+  m_vertices = 0;
 }
 
 void CGUITextureGL::End()
 {
   glEnd();
+  g_graphicsContext.AddDrawCall(m_vertices);
   glActiveTexture(GL_TEXTURE2_ARB);
   glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
@@ -174,6 +178,7 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
       glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
   }
   glVertex3f(x[3], y[3], z[3]);
+  m_vertices += 4;
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
@@ -220,6 +225,7 @@ void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *tex
   glVertex3f(rect.x1, rect.y2, 0);
 
   glEnd();
+  g_graphicsContext.AddDrawCall(4);
   if (texture)
     glDisable(GL_TEXTURE_2D);
 }
@@ -43,6 +43,7 @@ protected:
   void End();
 private:
   GLubyte m_col[4];
+  unsigned int m_vertices; ///< vertices drawn since Begin(), for the render statistics
 };
 
 #endif
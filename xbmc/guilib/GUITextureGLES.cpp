@@ -30,10 +30,25 @@
 #include "guilib/GraphicContext.h"
 
 #include <cstddef>
+#include <cstring>
 
 #if defined(HAS_GLES)
 
 
+// glDrawElements() takes 16 bit indices
+#define MAX_BATCH_VERTICES 65536
+
+CGUITextureGLES::BatchState CGUITextureGLES::m_batchState = { NULL, NULL, SM_DEFAULT, false, { 0, 0, 0, 0 } };
+PackedVertices CGUITextureGLES::m_packedVertices;
+std::vector<GLushort> CGUITextureGLES::m_idx;
+bool CGUITextureGLES::m_flushing = false;
+
+bool CGUITextureGLES::BatchState::operator==(const BatchState &right) const
+{
+  return texture == right.texture && diffuse == right.diffuse && shader == right.shader &&
+         blend == right.blend && memcmp(col, right.col, sizeof(col)) == 0;
+}
+
 CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
@@ -41,50 +56,60 @@ CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float heig
 
 void CGUITextureGLES::Begin(color_t color)
 {
-  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
-  texture->LoadToGPU();
+  BatchState state;
+  state.texture = m_texture.m_textures[m_currentFrame];
+  state.texture->LoadToGPU();
+  state.diffuse = NULL;
   if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
-
-  texture->BindToUnit(0);
+  {
+    state.diffuse = m_diffuse.m_textures[0];
+    state.diffuse->LoadToGPU();
+  }
 
   // Setup Colors
   m_col[0] = (GLubyte)GET_R(color);
   m_col[1] = (GLubyte)GET_G(color);
   m_col[2] = (GLubyte)GET_B(color);
   m_col[3] = (GLubyte)GET_A(color);
+  memcpy(state.col, m_col, sizeof(state.col));
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
-
-  if (m_diffuse.size())
+  bool white = m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255;
+  state.blend = state.texture->HasAlpha() || m_col[3] < 255;
+  if (state.diffuse)
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
-    {
-      g_Windowing.EnableGUIShader(SM_MULTI);
-    }
-    else
-    {
-      g_Windowing.EnableGUIShader(SM_MULTI_BLENDCOLOR);
-    }
+    state.shader = white ? SM_MULTI : SM_MULTI_BLENDCOLOR;
+    state.blend |= state.diffuse->HasAlpha();
+  }
+  else
+    state.shader = white ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
 
-    hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
+  // textures drawn the same way as the previous ones join its batch
+  if (!m_packedVertices.empty() && !(state == m_batchState))
+    FlushBatch();
+  m_batchState = state;
+}
 
-    m_diffuse.m_textures[0]->BindToUnit(1);
+void CGUITextureGLES::End()
+{
+  // the quads are drawn with the next texture that doesn't fit into the batch,
+  // or when the batch is flushed
+}
 
-  }
-  else
-  {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
-    {
-      g_Windowing.EnableGUIShader(SM_TEXTURE_NOBLEND);
-    }
-    else
-    {
-      g_Windowing.EnableGUIShader(SM_TEXTURE);
-    }
-  }
+void CGUITextureGLES::FlushBatch()
+{
+  if (m_packedVertices.empty() || m_flushing)
+    return;
+
+  // enabling the shader flushes the batch
+  m_flushing = true;
+
+  m_batchState.texture->BindToUnit(0);
+  if (m_batchState.diffuse)
+    m_batchState.diffuse->BindToUnit(1);
 
-  if ( hasAlpha )
+  g_Windowing.EnableGUIShader(m_batchState.shader);
+
+  if (m_batchState.blend)
   {
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
     glEnable( GL_BLEND );
@@ -93,22 +118,19 @@ void CGUITextureGLES::Begin(color_t color)
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
-}
 
-void CGUITextureGLES::End()
-{
   GLint posLoc  = g_Windowing.GUIShaderGetPos();
   GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
   GLint tex1Loc = g_Windowing.GUIShaderGetCoord1();
   GLint uniColLoc = g_Windowing.GUIShaderGetUniCol();
 
+  const GLubyte *col = m_batchState.col;
   if(uniColLoc >= 0)
   {
-    glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
+    glUniform4f(uniColLoc,(col[0] / 255.0f), (col[1] / 255.0f), (col[2] / 255.0f), (col[3] / 255.0f));
   }
 
-  if(m_diffuse.size())
+  if(m_batchState.diffuse)
   {
     glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u2));
     glEnableVertexAttribArray(tex1Loc);
@@ -119,8 +141,9 @@ void CGUITextureGLES::End()
   glEnableVertexAttribArray(tex0Loc);
 
   glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+  g_graphicsContext.AddDrawCall(m_packedVertices.size());
 
-  if (m_diffuse.size())
+  if (m_batchState.diffuse)
   {
     glDisableVertexAttribArray(tex1Loc);
     glActiveTexture(GL_TEXTURE0);
@@ -131,6 +154,9 @@ void CGUITextureGLES::End()
 
   glEnable(GL_BLEND);
   g_Windowing.DisableGUIShader();
+
+  m_packedVertices.clear();
+  m_flushing = false;
 }
 
 void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
@@ -199,6 +225,9 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
     }
   }
 
+  if (m_packedVertices.size() + 4 > MAX_BATCH_VERTICES)
+    FlushBatch();
+
   for (int i=0; i<4; i++)
   {
     vertices[i].x = x[i];
@@ -221,6 +250,8 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  FlushBatch();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -278,6 +309,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
     tex[2][1] = tex[3][1] = coords.y2;
   }
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  g_graphicsContext.AddDrawCall(4);
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
@@ -29,6 +29,7 @@
  */
 
 #include "GUITexture.h"
+#include "rendering/gles/RenderSystemGLES.h"
 
 #include "system_gl.h"
 #include <vector>
@@ -46,6 +47,13 @@ class CGUITextureGLES : public CGUITextureBase
 public:
   CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+
+  /*! \brief Draw the quads batched up so far.
+   Consecutive textures using the same textures, shader, blending and color are
+   drawn with a single draw call. The batch has to be flushed before anything
+   else is drawn or the render state changes, which CRenderSystemGLES does.
+   */
+  static void FlushBatch();
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
@@ -53,8 +61,22 @@ protected:
 
   GLubyte m_col[4];
 
-  PackedVertices m_packedVertices;
-  std::vector<GLushort> m_idx;
+private:
+  struct BatchState
+  {
+    CBaseTexture *texture;
+    CBaseTexture *diffuse;
+    ESHADERMETHOD shader;
+    bool blend;
+    GLubyte col[4];
+
+    bool operator==(const BatchState &right) const;
+  };
+
+  static BatchState m_batchState;
+  static PackedVertices m_packedVertices;
+  static std::vector<GLushort> m_idx;
+  static bool m_flushing;
 };
 
 #endif
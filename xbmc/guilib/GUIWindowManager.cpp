@@ -35,6 +35,7 @@
 #include "utils/Variant.h"
 #include "input/Key.h"
 #include "utils/StringUtils.h"
+#include "windowing/WindowingFactory.h"
 
 #include "windows/GUIWindowHome.h"
 #include "events/windows/GUIWindowEventLog.h"
@@ -1077,7 +1078,8 @@ bool CGUIWindowManager::Render()
   assert(g_application.IsCurrentThread());
   CSingleExit lock(g_graphicsContext);
 
-  CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
+  // with the age of the back buffer only what changed since it was shown has to be rendered again
+  CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions(g_Windowing.GetBufferAge());
 
   bool hasRendered = false;
   // If we visualize the regions we will always render the entire viewport
@@ -1118,6 +1120,9 @@ bool CGUIWindowManager::Render()
       CGUITexture::DrawQuad(*i, 0x4c00ff00);
   }
 
+  // draw what is left batched so the frame is complete for callers reading it back
+  CGUITexture::FlushBatch();
+
   return hasRendered;
 }
 
@@ -29,6 +29,7 @@
 #include "settings/Settings.h"
 #include "windowing/WindowingFactory.h"
 #include "TextureManager.h"
+#include "GUITexture.h"
 #include "input/InputManager.h"
 #include "GUIWindowManager.h"
 #include "utils/log.h"
@@ -60,6 +61,10 @@ CGraphicContext::CGraphicContext(void) :
   m_stereoView(RENDER_STEREO_VIEW_OFF)
   , m_stereoMode(RENDER_STEREO_MODE_OFF)
   , m_nextStereoMode(RENDER_STEREO_MODE_OFF)
+  , m_drawCalls(0)
+  , m_drawVertices(0)
+  , m_lastDrawCalls(0)
+  , m_lastDrawVertices(0)
 {
 }
 
@@ -979,6 +984,15 @@ void CGraphicContext::SetMediaDir(const std::string &strMediaDir)
 
 void CGraphicContext::Flip(bool rendered, bool videoLayer)
 {
+  CGUITexture::FlushBatch();
+  if (rendered)
+  {
+    m_lastDrawCalls = m_drawCalls;
+    m_lastDrawVertices = m_drawVertices;
+  }
+  m_drawCalls = 0;
+  m_drawVertices = 0;
+
   g_Windowing.PresentRender(rendered, videoLayer);
 
   if(m_stereoMode != m_nextStereoMode)
@@ -990,6 +1004,12 @@ void CGraphicContext::Flip(bool rendered, bool videoLayer)
   }
 }
 
+void CGraphicContext::GetRenderStats(unsigned int &drawCalls, unsigned int &vertices) const
+{
+  drawCalls = m_lastDrawCalls;
+  vertices = m_lastDrawVertices;
+}
+
 void CGraphicContext::ApplyHardwareTransform()
 {
   g_Windowing.ApplyHardwareTransform(m_finalTransform.matrix);
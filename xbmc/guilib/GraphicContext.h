@@ -131,6 +131,15 @@ public:
   void SetScalingResolution(const RESOLUTION_INFO &res, bool needsScaling);    ///< Sets scaling up for skin loading etc.
   float GetScalingPixelRatio() const;
   void Flip(bool rendered, bool videoLayer);
+
+  /*! \brief Count a draw call of the GUI in the render statistics of the current frame
+   \param vertices the number of vertices drawn
+   */
+  void AddDrawCall(unsigned int vertices) { m_drawCalls++; m_drawVertices += vertices; }
+
+  /*! \brief Get the number of GUI draw calls and vertices of the last rendered frame
+   */
+  void GetRenderStats(unsigned int &drawCalls, unsigned int &vertices) const;
   void InvertFinalCoords(float &x, float &y) const;
   inline float ScaleFinalXCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.matrix.TransformXCoord(x, y, 0); }
   inline float ScaleFinalYCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.matrix.TransformYCoord(x, y, 0); }
@@ -281,6 +290,11 @@ private:
   RENDER_STEREO_MODE m_nextStereoMode;
 
   CRect m_scissors;
+
+  unsigned int m_drawCalls;
+  unsigned int m_drawVertices;
+  unsigned int m_lastDrawCalls;
+  unsigned int m_lastDrawVertices;
 };
 
 /*!
@@ -0,0 +1,203 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Texture.h"
+#include "TextureBundle.h"
+#include "utils/log.h"
+
+#define ATLAS_PAGE_SIZE      1024
+#define ATLAS_MAX_IMAGE_SIZE  256
+#define ATLAS_BORDER            1
+
+/*!
+ \brief A texture shared by several small images.
+
+ Images are copied straight into the pixels of the texture, which it drops
+ once they are on the GPU. An image added after that needs the whole page
+ again, so the images already on it are reloaded from their bundle first.
+ The page is uploaded again the next time it is bound for rendering.
+ */
+class CAtlasPage : public CTexture
+{
+public:
+  explicit CAtlasPage(unsigned int size)
+    : CTexture(size, size, XB_FMT_A8R8G8B8)
+  {
+    m_size = std::min(GetTextureWidth(), GetTextureHeight());
+    Clear();
+    m_shelfX = m_shelfY = m_shelfHeight = 0;
+  }
+
+  bool Add(const CBaseTexture *texture, CTextureBundle *bundle, const std::string &name, unsigned int &x, unsigned int &y)
+  {
+    unsigned int width = texture->GetWidth();
+    unsigned int height = texture->GetHeight();
+    unsigned int paddedWidth = width + 2 * ATLAS_BORDER;
+    unsigned int paddedHeight = height + 2 * ATLAS_BORDER;
+
+    // start a new shelf if the image doesn't fit next to the previous one
+    unsigned int shelfX = m_shelfX, shelfY = m_shelfY, shelfHeight = m_shelfHeight;
+    if (shelfX + paddedWidth > m_size)
+    {
+      shelfY += shelfHeight;
+      shelfX = 0;
+      shelfHeight = 0;
+    }
+    if (paddedWidth > m_size || shelfY + paddedHeight > m_size)
+      return false;
+
+    if (!m_pixels)
+      Rebuild();
+
+    x = shelfX + ATLAS_BORDER;
+    y = shelfY + ATLAS_BORDER;
+    m_shelfX = shelfX + paddedWidth;
+    m_shelfY = shelfY;
+    m_shelfHeight = std::max(shelfHeight, paddedHeight);
+
+    Copy(texture, x, y);
+
+    Image image = { bundle, name, x, y, width, height };
+    m_images.push_back(image);
+    return true;
+  }
+
+  bool Release(unsigned int x, unsigned int y)
+  {
+    for (std::vector<Image>::iterator i = m_images.begin(); i != m_images.end(); ++i)
+    {
+      if (i->x == x && i->y == y)
+      {
+        m_images.erase(i);
+        break;
+      }
+    }
+    return m_images.empty();
+  }
+
+private:
+  struct Image
+  {
+    CTextureBundle *bundle;
+    std::string name;
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+  };
+
+  void Clear()
+  {
+    if (m_pixels)
+      memset(m_pixels, 0, GetPitch() * GetRows());
+  }
+
+  void Rebuild()
+  {
+    Allocate(m_size, m_size, XB_FMT_A8R8G8B8);
+    Clear();
+    for (std::vector<Image>::const_iterator i = m_images.begin(); i != m_images.end(); ++i)
+    {
+      CBaseTexture *texture = NULL;
+      int width, height;
+      if (i->bundle->LoadTexture(i->name, &texture, width, height) &&
+          texture->GetWidth() == i->width && texture->GetHeight() == i->height)
+        Copy(texture, i->x, i->y);
+      else
+        CLog::Log(LOGERROR, "CTextureAtlas: unable to reload %s", i->name.c_str());
+      delete texture;
+    }
+  }
+
+  // copy the image with a border of repeated edge pixels around it
+  void Copy(const CBaseTexture *texture, unsigned int x, unsigned int y)
+  {
+    unsigned int width = texture->GetWidth();
+    unsigned int height = texture->GetHeight();
+    const unsigned char *src = texture->GetPixels();
+    unsigned int srcPitch = texture->GetPitch();
+    unsigned int dstPitch = GetPitch();
+    for (unsigned int row = 0; row < height + 2 * ATLAS_BORDER; row++)
+    {
+      unsigned int srcRow = std::min(std::max(row, 1u) - 1, height - 1);
+      const unsigned char *srcLine = src + srcRow * srcPitch;
+      unsigned char *dstLine = m_pixels + (y - ATLAS_BORDER + row) * dstPitch + (x - ATLAS_BORDER) * 4;
+      memcpy(dstLine, srcLine, 4);
+      memcpy(dstLine + 4, srcLine, width * 4);
+      memcpy(dstLine + (width + 1) * 4, srcLine + (width - 1) * 4, 4);
+    }
+  }
+
+  unsigned int m_size;
+  unsigned int m_shelfX;
+  unsigned int m_shelfY;
+  unsigned int m_shelfHeight;
+  std::vector<Image> m_images;
+};
+
+CTextureAtlas::~CTextureAtlas()
+{
+  for (std::vector<CAtlasPage*>::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+    delete *i;
+}
+
+bool CTextureAtlas::CanAdd(const CBaseTexture *texture)
+{
+  return texture && texture->GetPixels() &&
+         texture->GetFormat() == XB_FMT_A8R8G8B8 &&
+         texture->GetWidth() > 0 && texture->GetWidth() <= ATLAS_MAX_IMAGE_SIZE &&
+         texture->GetHeight() > 0 && texture->GetHeight() <= ATLAS_MAX_IMAGE_SIZE;
+}
+
+CBaseTexture* CTextureAtlas::Add(const CBaseTexture *texture, CTextureBundle *bundle, const std::string &name, unsigned int &x, unsigned int &y)
+{
+  if (!CanAdd(texture))
+    return NULL;
+
+  for (std::vector<CAtlasPage*>::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+  {
+    if ((*i)->Add(texture, bundle, name, x, y))
+      return *i;
+  }
+
+  CAtlasPage *page = new CAtlasPage(ATLAS_PAGE_SIZE);
+  if (!page->Add(texture, bundle, name, x, y))
+  {
+    delete page;
+    return NULL;
+  }
+  m_pages.push_back(page);
+  return page;
+}
+
+void CTextureAtlas::Release(CBaseTexture *page, unsigned int x, unsigned int y)
+{
+  std::vector<CAtlasPage*>::iterator i = std::find(m_pages.begin(), m_pages.end(), page);
+  if (i != m_pages.end() && (*i)->Release(x, y))
+  {
+    delete *i;
+    m_pages.erase(i);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class CBaseTexture;
+class CTextureBundle;
+class CAtlasPage;
+
+/*!
+ \ingroup textures
+ \brief Packs small skin textures into shared texture pages.
+
+ Each image is copied into a page with a one pixel border of repeated edge
+ pixels, so linear filtering at the edges of the image doesn't pick up its
+ neighbours. Space is handed out in shelves and only reclaimed once every
+ image on a page has been released, at which point the page is deleted.
+ Pages don't keep their pixels once they are on the GPU, images are reloaded
+ from their bundle if a page has to be uploaded again.
+
+ Callers have to hold the graphics context lock.
+ */
+class CTextureAtlas
+{
+public:
+  CTextureAtlas() = default;
+  ~CTextureAtlas();
+
+  /*! \brief Check whether a texture is small enough and in a format that can be packed.
+   */
+  static bool CanAdd(const CBaseTexture *texture);
+
+  /*! \brief Copy a texture into one of the pages.
+   \param texture the texture to copy, which still has to hold its pixels.
+   \param bundle the bundle the texture was loaded from.
+   \param name the name of the texture within the bundle.
+   \param x [out] horizontal position of the image within the page, in pixels.
+   \param y [out] vertical position of the image within the page, in pixels.
+   \return the page holding the image, NULL if the texture can't be packed.
+   */
+  CBaseTexture* Add(const CBaseTexture *texture, CTextureBundle *bundle, const std::string &name, unsigned int &x, unsigned int &y);
+
+  /*! \brief Release an image added with Add(), deleting the page once it is empty.
+   \param page the page returned by Add().
+   \param x horizontal position of the image returned by Add().
+   \param y vertical position of the image returned by Add().
+   */
+  void Release(CBaseTexture *page, unsigned int x, unsigned int y);
+
+  unsigned int GetPageCount() const { return m_pages.size(); }
+
+private:
+  std::vector<CAtlasPage*> m_pages;
+};
@@ -26,6 +26,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "GraphicContext.h"
+#include "settings/AdvancedSettings.h"
 #include "system.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
@@ -55,6 +56,9 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_texWidth = 0;
   m_texHeight = 0;
   m_texCoordsArePixels = false;
+  m_atlased = false;
+  m_atlasX = 0;
+  m_atlasY = 0;
 }
 
 CTextureArray::CTextureArray()
@@ -84,6 +88,9 @@ void CTextureArray::Reset()
   m_texWidth = 0;
   m_texHeight = 0;
   m_texCoordsArePixels = false;
+  m_atlased = false;
+  m_atlasX = 0;
+  m_atlasY = 0;
 }
 
 void CTextureArray::Add(CBaseTexture *texture, int delay)
@@ -131,6 +138,7 @@ CTextureMap::CTextureMap()
 {
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_atlas = NULL;
 }
 
 CTextureMap::CTextureMap(const std::string& textureName, int width, int height, int loops)
@@ -139,6 +147,7 @@ CTextureMap::CTextureMap(const std::string& textureName, int width, int height,
 {
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_atlas = NULL;
 }
 
 CTextureMap::~CTextureMap()
@@ -194,7 +203,16 @@ void CTextureMap::Flush()
 
 void CTextureMap::FreeTexture()
 {
-  m_texture.Free();
+  if (m_atlas)
+  { // the page is shared with other textures, so only give back our image
+    CSingleLock lock(g_graphicsContext);
+    for (unsigned int i = 0; i < m_texture.m_textures.size(); i++)
+      m_atlas->Release(m_texture.m_textures[i], m_texture.m_atlasX, m_texture.m_atlasY);
+    m_texture.Reset();
+    m_atlas = NULL;
+  }
+  else
+    m_texture.Free();
 }
 
 void CTextureMap::SetHeight(int height)
@@ -220,11 +238,23 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::AddAtlased(CTextureAtlas *atlas, CBaseTexture *page, int x, int y)
+{
+  // the memory of the page is owned by the atlas
+  m_texture.Add(page, 100);
+  m_texture.m_atlased = true;
+  m_texture.m_atlasX = x;
+  m_texture.m_atlasY = y;
+  m_atlas = atlas;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
 CGUITextureManager::CGUITextureManager(void)
 {
+  m_atlasPacked = 0;
+  m_atlasLoaded = 0;
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
 }
@@ -456,7 +486,24 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   if (!pTexture) return emptyTexture;
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
-  pMap->Add(pTexture, 100);
+
+  // small skin images share atlas pages, so they can be drawn without switching textures
+  CBaseTexture *page = NULL;
+  if (bundle >= 0)
+  {
+    m_atlasLoaded++;
+    unsigned int x, y;
+    if (g_advancedSettings.m_guiTextureAtlas)
+      page = m_atlas.Add(pTexture, &m_TexBundle[bundle], strTextureName, x, y);
+    if (page)
+    {
+      pMap->AddAtlased(&m_atlas, page, x, y);
+      delete pTexture;
+      m_atlasPacked++;
+    }
+  }
+  if (!page)
+    pMap->Add(pTexture, 100);
   m_vecTextures.push_back(pMap);
 
 #ifdef _DEBUG_TEXTURES
@@ -555,6 +602,7 @@ void CGUITextureManager::Cleanup()
 void CGUITextureManager::Dump() const
 {
   CLog::Log(LOGDEBUG, "%s: total texturemaps size:%" PRIuS, __FUNCTION__, m_vecTextures.size());
+  CLog::Log(LOGDEBUG, "%s: %u of %u bundled images packed into %u atlas pages", __FUNCTION__, m_atlasPacked, m_atlasLoaded, m_atlas.GetPageCount());
 
   for (int i = 0; i < (int)m_vecTextures.size(); ++i)
   {
@@ -586,6 +634,13 @@ void CGUITextureManager::Flush()
   }
 }
 
+void CGUITextureManager::GetAtlasStats(unsigned int &packed, unsigned int &loaded, unsigned int &pages) const
+{
+  packed = m_atlasPacked;
+  loaded = m_atlasLoaded;
+  pages = m_atlas.GetPageCount();
+}
+
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
@@ -28,6 +28,7 @@
 #include <vector>
 #include <utility>
 
+#include "TextureAtlas.h"
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -58,6 +59,9 @@ public:
   int m_texWidth;
   int m_texHeight;
   bool m_texCoordsArePixels;
+  bool m_atlased;  ///< true if the image is packed into a shared atlas page
+  int m_atlasX;    ///< position of the image within the atlas page, in pixels
+  int m_atlasY;
 };
 
 /*!
@@ -75,6 +79,7 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+  void AddAtlased(CTextureAtlas *atlas, CBaseTexture *page, int x, int y);
   bool Release();
 
   const std::string& GetName() const;
@@ -92,6 +97,7 @@ protected:
   std::string m_textureName;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
+  CTextureAtlas *m_atlas;
 };
 
 /*!
@@ -124,6 +130,13 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  /*! \brief Get the number of still images loaded from the texture bundles and how many of them were packed into atlas pages.
+   \param packed [out] number of images packed into atlas pages.
+   \param loaded [out] number of still images loaded from the texture bundles.
+   \param pages [out] number of atlas pages in use.
+   */
+  void GetAtlasStats(unsigned int &packed, unsigned int &loaded, unsigned int &pages) const;
 protected:
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
@@ -132,6 +145,9 @@ protected:
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
+  CTextureAtlas m_atlas;
+  unsigned int m_atlasPacked;
+  unsigned int m_atlasLoaded;
 
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
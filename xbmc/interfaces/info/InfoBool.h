@@ -27,6 +27,17 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*! \brief Sources of change an info bool depends on.
+ Volatile info bools are re-evaluated every frame, all others only once one of their sources changed.
+ */
+enum InfoSource
+{
+  SOURCE_CONSTANT = 0x00,    ///< never changes once evaluated
+  SOURCE_VOLATILE = 0x01,    ///< may change at any time
+  SOURCE_SKIN     = 0x02,    ///< skin settings
+  SOURCE_PLAYER   = 0x04,    ///< player state (playing, paused, audio or video)
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -73,11 +84,13 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  unsigned int GetSources() const { return m_sources; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_sources;      ///< InfoSource flags that invalidate the cached value
 
 private:
   std::string  m_expression;   ///< original expression
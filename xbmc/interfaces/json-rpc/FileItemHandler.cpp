@@ -36,6 +36,8 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "TextureDatabase.h"
+#include "threads/ThreadLocal.h"
+#include "utils/JSONVariantWriter.h"
 #include "video/VideoThumbLoader.h"
 #include "music/MusicThumbLoader.h"
 #include "Util.h"
@@ -48,6 +50,10 @@ using namespace MUSIC_INFO;
 using namespace JSONRPC;
 using namespace XFILE;
 
+#define STREAM_ITEMS_PER_CHUNK 64
+
+static XbmcThreads::ThreadLocal<CResultStream> currentStream;
+
 bool CFileItemHandler::GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader /* = NULL */)
 {
   if (result.isMember(field) && !result[field].empty())
@@ -222,6 +228,37 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
     end = items.Size();
   }
 
+  std::set<std::string> fields;
+  if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
+  {
+    for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
+      fields.insert(field->asString());
+  }
+
+  // when the response is streamed only keep the requested page of items,
+  // they are serialized straight into the output by CResultStream::Write()
+  CResultStream *stream = resultname != NULL ? CResultStream::GetBound(result) : NULL;
+  if (stream != NULL)
+  {
+    if (end - start > 0)
+    {
+      if (!result.isMember(resultname))
+        result[resultname] = CVariant(CVariant::VariantTypeArray);
+
+      CResultStream::DeferredList list;
+      list.resultname = resultname;
+      if (ID)
+        list.ID = ID;
+      list.allowFile = allowFile;
+      list.fields = fields;
+      list.items.reserve(end - start);
+      for (int i = start; i < end; i++)
+        list.items.push_back(items.Get(i));
+      stream->m_lists.push_back(list);
+    }
+    return;
+  }
+
   CThumbLoader *thumbLoader = NULL;
   if (end - start > 0)
   {
@@ -234,13 +271,6 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       thumbLoader->OnLoaderStart();
   }
 
-  std::set<std::string> fields;
-  if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
-  {
-    for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
-      fields.insert(field->asString());
-  }
-
   for (int i = start; i < end; i++)
   {
     CFileItemPtr item = items.Get(i);
@@ -265,6 +295,19 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const std::set<std::string> &validFields, CVariant &result, bool append /* = true */, CThumbLoader *thumbLoader /* = NULL */)
 {
   CVariant object;
+  SerializeFileItem(ID, allowFile, item, validFields, object, thumbLoader);
+
+  if (resultname)
+  {
+    if (append)
+      result[resultname].append(object);
+    else
+      result[resultname] = object;
+  }
+}
+
+void CFileItemHandler::SerializeFileItem(const char *ID, bool allowFile, const CFileItemPtr &item, const std::set<std::string> &validFields, CVariant &object, CThumbLoader *thumbLoader /* = NULL */)
+{
   std::set<std::string> fields(validFields.begin(), validFields.end());
 
   if (item.get())
@@ -377,14 +420,6 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   }
   else
     object = CVariant(CVariant::VariantTypeNull);
-
-  if (resultname)
-  {
-    if (append)
-      result[resultname].append(object);
-    else
-      result[resultname] = object;
-  }
 }
 
 bool CFileItemHandler::FillFileItemList(const CVariant &parameterObject, CFileItemList &list)
@@ -436,3 +471,130 @@ void CFileItemHandler::Sort(CFileItemList &items, const CVariant &parameterObjec
 
   items.Sort(sorting);
 }
+
+CResultStream::CResultStream()
+  : m_result(NULL),
+    m_previous(NULL)
+{ }
+
+CResultStream::~CResultStream()
+{
+  Bind(NULL);
+}
+
+void CResultStream::Bind(const CVariant *result)
+{
+  // bound streams form a stack per thread so nested method calls each get their own
+  if (m_result != NULL)
+    currentStream.set(m_previous);
+
+  m_result = result;
+  if (m_result != NULL)
+  {
+    m_previous = currentStream.get();
+    currentStream.set(this);
+  }
+}
+
+CResultStream* CResultStream::GetBound(const CVariant &result)
+{
+  CResultStream *stream = currentStream.get();
+  if (stream == NULL || stream->m_result != &result)
+    return NULL;
+
+  return stream;
+}
+
+bool CResultStream::Write(const CVariant &response, CJSONVariantWriter &writer, std::string &output) const
+{
+  if (m_lists.empty() || !response.isObject())
+    return writer.Value(response);
+
+  bool success = writer.BeginObject();
+  for (CVariant::const_iterator_map itr = response.begin_map(); itr != response.end_map() && success; ++itr)
+  {
+    success = writer.Key(itr->first);
+    if (!success)
+      break;
+
+    if (itr->first == "result" && itr->second.isObject())
+      success = WriteResult(itr->second, writer, output);
+    else
+      success = writer.Value(itr->second);
+  }
+
+  return success && writer.EndObject();
+}
+
+bool CResultStream::WriteResult(const CVariant &result, CJSONVariantWriter &writer, std::string &output) const
+{
+  bool success = writer.BeginObject();
+  for (CVariant::const_iterator_map itr = result.begin_map(); itr != result.end_map() && success; ++itr)
+  {
+    success = writer.Key(itr->first);
+    if (!success)
+      break;
+
+    bool deferred = false;
+    for (std::vector<DeferredList>::const_iterator list = m_lists.begin(); list != m_lists.end(); ++list)
+    {
+      if (list->resultname == itr->first)
+      {
+        deferred = true;
+        break;
+      }
+    }
+
+    if (!deferred || !itr->second.isArray())
+    {
+      success = writer.Value(itr->second);
+      continue;
+    }
+
+    // items that were appended the regular way come first, followed by the
+    // deferred lists in the order they were handled
+    success = writer.BeginArray();
+    for (CVariant::const_iterator_array item = itr->second.begin_array(); item != itr->second.end_array() && success; ++item)
+      success = writer.Value(*item);
+
+    for (std::vector<DeferredList>::const_iterator list = m_lists.begin(); list != m_lists.end() && success; ++list)
+    {
+      if (list->resultname == itr->first)
+        success = WriteItems(*list, writer, output);
+    }
+
+    success = success && writer.EndArray();
+  }
+
+  return success && writer.EndObject();
+}
+
+bool CResultStream::WriteItems(const DeferredList &list, CJSONVariantWriter &writer, std::string &output) const
+{
+  if (list.items.empty())
+    return true;
+
+  CThumbLoader *thumbLoader = NULL;
+  if (list.items.front()->HasVideoInfoTag())
+    thumbLoader = new CVideoThumbLoader();
+  else if (list.items.front()->HasMusicInfoTag())
+    thumbLoader = new CMusicThumbLoader();
+
+  if (thumbLoader != NULL)
+    thumbLoader->OnLoaderStart();
+
+  bool success = true;
+  for (size_t i = 0; i < list.items.size() && success; i++)
+  {
+    CVariant object;
+    CFileItemHandler::SerializeFileItem(list.ID.empty() ? NULL : list.ID.c_str(), list.allowFile, list.items[i], list.fields, object, thumbLoader);
+    success = writer.Value(object);
+
+    if ((i + 1) % STREAM_ITEMS_PER_CHUNK == 0)
+      writer.Flush(output);
+  }
+
+  delete thumbLoader;
+
+  return success;
+}
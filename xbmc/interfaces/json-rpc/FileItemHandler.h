@@ -20,18 +20,74 @@
  */
 
 #include <set>
+#include <string>
+#include <vector>
 
 #include "JSONRPC.h"
 #include "JSONUtils.h"
 #include "FileItem.h"
 
+class CJSONVariantWriter;
 class CThumbLoader;
 class CVariant;
 
 namespace JSONRPC
 {
+  /*!
+   \brief Writes file item lists of a response without building them as CVariant trees
+
+   While a stream is bound to a result object on the current thread,
+   CFileItemHandler::HandleFileItemList() only keeps the requested page of
+   items for that result and leaves an empty array in its place. Write() then
+   serializes the response and turns every deferred item into JSON one at a time.
+   */
+  class CResultStream
+  {
+  public:
+    CResultStream();
+    ~CResultStream();
+
+    /*!
+     \brief Starts (or with NULL stops) deferring item lists added to the given result
+     */
+    void Bind(const CVariant *result);
+
+    /*!
+     \brief Writes the given response, replacing the placeholders of deferred lists
+     \param response Response object containing the bound result as its "result" member
+     \param writer Writer to serialize into
+     \param output String the serialized data is flushed to in chunks of items
+     */
+    bool Write(const CVariant &response, CJSONVariantWriter &writer, std::string &output) const;
+
+  private:
+    friend class CFileItemHandler;
+
+    CResultStream(const CResultStream&);
+    CResultStream& operator=(const CResultStream&);
+
+    struct DeferredList
+    {
+      std::string resultname;
+      std::string ID;
+      bool allowFile;
+      std::set<std::string> fields;
+      std::vector<CFileItemPtr> items;
+    };
+
+    bool WriteResult(const CVariant &result, CJSONVariantWriter &writer, std::string &output) const;
+    bool WriteItems(const DeferredList &list, CJSONVariantWriter &writer, std::string &output) const;
+    static CResultStream* GetBound(const CVariant &result);
+
+    const CVariant *m_result;
+    CResultStream *m_previous;
+    std::vector<DeferredList> m_lists;
+  };
+
   class CFileItemHandler : public CJSONUtils
   {
+    friend class CResultStream;
+
   protected:
     static void FillDetails(const ISerializable *info, const CFileItemPtr &item, std::set<std::string> &fields, CVariant &result, CThumbLoader *thumbLoader = NULL);
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit = true);
@@ -42,6 +98,7 @@ namespace JSONRPC
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
   private:
     static void Sort(CFileItemList &items, const CVariant& parameterObject);
+    static void SerializeFileItem(const char *ID, bool allowFile, const CFileItemPtr &item, const std::set<std::string> &validFields, CVariant &object, CThumbLoader *thumbLoader = NULL);
     static bool GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader = NULL);
   };
 }
@@ -21,6 +21,7 @@
 #include <string.h>
 
 #include "JSONRPC.h"
+#include "FileItemHandler.h"
 #include "ServiceDescription.h"
 #include "addons/Addon.h"
 #include "addons/IAddon.h"
@@ -29,6 +30,7 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -236,6 +238,8 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
 {
   CVariant inputroot, outputroot, result;
+  std::list<CResultStream> streams;
+  const bool streamed = g_advancedSettings.m_jsonOutputStreamed;
   bool hasResponse = false;
 
   if(g_advancedSettings.CanLogComponent(LOGJSONRPC))
@@ -257,16 +261,24 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
         for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
         {
           CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
+          if (streamed)
+            streams.emplace_back();
+          if (HandleMethodCall(*itr, response, transport, client, streamed ? &streams.back() : NULL))
           {
             outputroot.append(response);
             hasResponse = true;
           }
+          else if (streamed)
+            streams.pop_back();
         }
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+    {
+      if (streamed)
+        streams.emplace_back();
+      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client, streamed ? &streams.back() : NULL);
+    }
   }
   else
   {
@@ -275,11 +287,11 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
     hasResponse = true;
   }
 
-  std::string str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
+  std::string str = hasResponse ? WriteResponse(outputroot, streams) : "";
   return str;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CResultStream *stream /* = NULL */)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
@@ -296,7 +308,14 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CVariant params;
 
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      // item lists of a notification are never written so there is no point in streaming them
+      if (stream != NULL && !isNotification)
+        stream->Bind(&result);
       errorCode = method(methodName, transport, client, params, result);
+      if (stream != NULL)
+        stream->Bind(NULL);
+    }
     else
       result = params;
   }
@@ -311,6 +330,34 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
   return !isNotification;
 }
 
+std::string CJSONRPC::WriteResponse(const CVariant& output, const std::list<CResultStream> &streams)
+{
+  std::string str;
+  bool success = true;
+  CJSONVariantWriter writer(g_advancedSettings.m_jsonOutputCompact);
+
+  // the responses of a batch call line up with the streams of the calls that
+  // produced them, anything else (e.g. parse errors) is written as it is
+  if (output.isArray() && output.size() == streams.size())
+  {
+    success = writer.BeginArray();
+    std::list<CResultStream>::const_iterator stream = streams.begin();
+    for (CVariant::const_iterator_array itr = output.begin_array(); itr != output.end_array() && success; ++itr, ++stream)
+      success = stream->Write(*itr, writer, str);
+    success = success && writer.EndArray();
+  }
+  else if (!output.isArray() && streams.size() == 1)
+    success = streams.front().Write(output, writer, str);
+  else
+    success = writer.Value(output);
+
+  if (!success)
+    return "";
+
+  writer.Flush(str);
+  return str;
+}
+
 inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
 {
   return inputroot.isObject() && inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
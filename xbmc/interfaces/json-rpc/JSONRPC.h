@@ -20,6 +20,7 @@
  */
 
 #include <iostream>
+#include <list>
 #include <map>
 #include <stdio.h>
 #include <string>
@@ -31,6 +32,8 @@ class CVariant;
 
 namespace JSONRPC
 {
+  class CResultStream;
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -74,7 +77,8 @@ namespace JSONRPC
   
   private:
     static void setup();
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CResultStream *stream = NULL);
+    static std::string WriteResponse(const CVariant& output, const std::list<CResultStream> &streams);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
@@ -0,0 +1,205 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/IClient.h"
+#include "interfaces/json-rpc/ITransportLayer.h"
+#include "filesystem/SpecialProtocol.h"
+#include "profiles/ProfilesManager.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace JSONRPC;
+
+namespace
+{
+class CTestTransport : public ITransportLayer
+{
+public:
+  virtual bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) { return false; }
+  virtual bool Download(const char *path, CVariant &result) { return false; }
+  virtual int GetCapabilities() { return Response; }
+};
+
+class CTestClient : public IClient
+{
+public:
+  virtual int GetPermissionFlags() { return OPERATION_PERMISSION_ALL; }
+  virtual int GetAnnouncementFlags() { return 0; }
+  virtual bool SetAnnouncementFlags(int flags) { return false; }
+};
+}
+
+/* The streamed response serializes the item lists of CFileItemHandler::HandleFileItemList()
+ * straight into the output, it has to be identical to the response built as a whole. */
+class TestJSONRPC : public testing::Test
+{
+protected:
+  TestJSONRPC()
+  {
+    CJSONRPC::Initialize();
+
+    CProfilesManager &profiles = CProfilesManager::GetInstance();
+    m_profilePath = CSpecialProtocol::TranslatePath("special://profile/");
+    for (size_t i = 0; i < profiles.GetNumberOfProfiles(); i++)
+      m_profiles.push_back(*profiles.GetProfile(i));
+    profiles.Clear();
+  }
+
+  ~TestJSONRPC()
+  {
+    CProfilesManager &profiles = CProfilesManager::GetInstance();
+    profiles.Clear();
+    for (std::vector<CProfile>::const_iterator it = m_profiles.begin(); it != m_profiles.end(); ++it)
+      profiles.AddProfile(*it);
+    CSpecialProtocol::SetProfilePath(m_profilePath);
+
+    g_advancedSettings.m_jsonOutputStreamed = true;
+    CJSONRPC::Cleanup();
+  }
+
+  void AddProfiles(unsigned int count)
+  {
+    for (unsigned int i = 0; i < count; i++)
+    {
+      CProfile profile(StringUtils::Format("special://temp/profile%u/", i), StringUtils::Format("Profile %03u", i), i);
+      profile.setThumb(StringUtils::Format("special://temp/profile%u.png", i));
+      // every other profile is locked so the lockmode values differ between items
+      profile.SetLocks(CProfile::CLock(i % 2 ? LOCK_MODE_NUMERIC : LOCK_MODE_EVERYONE, "1234"));
+      CProfilesManager::GetInstance().AddProfile(profile);
+    }
+  }
+
+  // returns the streamed response after checking it against the one built as a whole
+  std::string Call(const std::string &request)
+  {
+    g_advancedSettings.m_jsonOutputStreamed = false;
+    std::string built = CJSONRPC::MethodCall(request, &m_transport, &m_client);
+    g_advancedSettings.m_jsonOutputStreamed = true;
+    std::string streamed = CJSONRPC::MethodCall(request, &m_transport, &m_client);
+
+    EXPECT_FALSE(built.empty());
+    EXPECT_EQ(built, streamed);
+    return streamed;
+  }
+
+  CTestTransport m_transport;
+  CTestClient m_client;
+
+private:
+  std::vector<CProfile> m_profiles;
+  std::string m_profilePath;
+};
+
+TEST_F(TestJSONRPC, GetProfilesLockMode)
+{
+  AddProfiles(4);
+
+  CVariant response = CJSONVariantParser::Parse(Call(
+    "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"params\":{\"properties\":[\"lockmode\",\"thumbnail\"]},\"id\":1}"));
+
+  const CVariant &result = response["result"];
+  ASSERT_TRUE(result["profiles"].isArray());
+  ASSERT_EQ(4U, result["profiles"].size());
+  EXPECT_EQ(4, result["limits"]["total"].asInteger());
+  for (unsigned int i = 0; i < 4; i++)
+  {
+    const CVariant &profile = result["profiles"][i];
+    EXPECT_EQ(StringUtils::Format("Profile %03u", i), profile["label"].asString());
+    EXPECT_EQ(i % 2 ? LOCK_MODE_NUMERIC : LOCK_MODE_EVERYONE, profile["lockmode"].asInteger());
+    EXPECT_TRUE(profile.isMember("thumbnail"));
+  }
+}
+
+TEST_F(TestJSONRPC, GetProfilesWithoutProperties)
+{
+  AddProfiles(3);
+
+  CVariant response = CJSONVariantParser::Parse(Call(
+    "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"id\":\"no properties\"}"));
+
+  const CVariant &result = response["result"];
+  ASSERT_EQ(3U, result["profiles"].size());
+  EXPECT_FALSE(result["profiles"][0].isMember("lockmode"));
+  EXPECT_FALSE(result["profiles"][0].isMember("thumbnail"));
+}
+
+TEST_F(TestJSONRPC, GetProfilesEmpty)
+{
+  CVariant response = CJSONVariantParser::Parse(Call(
+    "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"params\":{\"properties\":[\"lockmode\"]},\"id\":1}"));
+
+  EXPECT_EQ(0, response["result"]["limits"]["total"].asInteger());
+}
+
+TEST_F(TestJSONRPC, GetProfilesLongList)
+{
+  // spans several of the chunks the streamed output is flushed in
+  AddProfiles(150);
+
+  CVariant response = CJSONVariantParser::Parse(Call(
+    "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"params\":{\"properties\":[\"lockmode\"]},\"id\":1}"));
+  EXPECT_EQ(150U, response["result"]["profiles"].size());
+
+  response = CJSONVariantParser::Parse(Call(
+    "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"params\":{\"properties\":[\"lockmode\"],\"limits\":{\"start\":10,\"end\":140}},\"id\":2}"));
+
+  const CVariant &result = response["result"];
+  ASSERT_EQ(130U, result["profiles"].size());
+  EXPECT_EQ("Profile 010", result["profiles"][0]["label"].asString());
+  EXPECT_EQ("Profile 139", result["profiles"][129]["label"].asString());
+  EXPECT_EQ(150, result["limits"]["total"].asInteger());
+}
+
+TEST_F(TestJSONRPC, BatchCallOrder)
+{
+  AddProfiles(80);
+
+  CVariant response = CJSONVariantParser::Parse(Call(
+    "["
+      "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"params\":{\"properties\":[\"lockmode\"],\"limits\":{\"start\":5,\"end\":75}},\"id\":1},"
+      "{\"jsonrpc\":\"2.0\",\"method\":\"JSONRPC.Version\",\"id\":2},"
+      "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"params\":{\"properties\":[\"thumbnail\"]}},"
+      "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.GetProfiles\",\"params\":{\"properties\":[\"thumbnail\",\"lockmode\"],\"sort\":{\"method\":\"label\",\"order\":\"descending\"}},\"id\":3},"
+      "{\"jsonrpc\":\"2.0\",\"method\":\"Profiles.Unknown\",\"id\":4}"
+    "]"));
+
+  // the notification doesn't get a response
+  ASSERT_TRUE(response.isArray());
+  ASSERT_EQ(4U, response.size());
+  EXPECT_EQ(1, response[0]["id"].asInteger());
+  EXPECT_EQ(2, response[1]["id"].asInteger());
+  EXPECT_EQ(3, response[2]["id"].asInteger());
+  EXPECT_EQ(4, response[3]["id"].asInteger());
+
+  EXPECT_EQ(70U, response[0]["result"]["profiles"].size());
+  EXPECT_EQ("Profile 005", response[0]["result"]["profiles"][0]["label"].asString());
+  EXPECT_TRUE(response[1]["result"].isMember("version"));
+  EXPECT_EQ(80U, response[2]["result"]["profiles"].size());
+  EXPECT_EQ("Profile 079", response[2]["result"]["profiles"][0]["label"].asString());
+  EXPECT_EQ(LOCK_MODE_NUMERIC, response[2]["result"]["profiles"][0]["lockmode"].asInteger());
+  EXPECT_TRUE(response[3].isMember("error"));
+}
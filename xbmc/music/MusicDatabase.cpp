@@ -6201,8 +6201,10 @@ bool CMusicDatabase::GetArtForItem(int mediaId, const std::string &mediaType, st
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS2.get()) return false; // using dataset 2 as we're likely called in loops on dataset 1
 
-    std::string sql = PrepareSQL("SELECT type,url FROM art WHERE media_id=%i AND media_type='%s'", mediaId, mediaType.c_str());
-    m_pDS2->query(sql);
+    dbiplus::sql_params params;
+    params.push_back(mediaId);
+    params.push_back(mediaType);
+    m_pDS2->query("SELECT type,url FROM art WHERE media_id=? AND media_type=?", params);
     while (!m_pDS2->eof())
     {
       art.insert(std::make_pair(m_pDS2->fv(0).get_asString(), m_pDS2->fv(1).get_asString()));
@@ -6220,8 +6222,11 @@ bool CMusicDatabase::GetArtForItem(int mediaId, const std::string &mediaType, st
 
 std::string CMusicDatabase::GetArtForItem(int mediaId, const std::string &mediaType, const std::string &artType)
 {
-  std::string query = PrepareSQL("SELECT url FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
-  return GetSingleValue(query, m_pDS2);
+  dbiplus::sql_params params;
+  params.push_back(mediaId);
+  params.push_back(mediaType);
+  params.push_back(artType);
+  return GetSingleValue("SELECT url FROM art WHERE media_id=? AND media_type=? AND type=?", params, m_pDS2);
 }
 
 bool CMusicDatabase::GetArtistArtForItem(int mediaId, const std::string &mediaType, std::map<std::string, std::string> &art)
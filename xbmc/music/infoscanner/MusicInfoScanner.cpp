@@ -45,7 +45,7 @@
 #include "interfaces/AnnouncementManager.h"
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
-#include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/MusicInfoTagReader.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "NfoFile.h"
@@ -536,6 +536,7 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
 {
   std::vector<std::string> regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> songs;
   for (int i = 0; i < items.Size(); ++i)
   {
     if (m_bStop)
@@ -549,15 +550,27 @@ INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList&
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
-    m_currentItem++;
+    songs.push_back(pItem);
+  }
 
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
+  // read the tags on worker threads while the results are consumed in order below
+  CMusicInfoTagReader reader(songs, g_advancedSettings.m_iMusicLibraryTagReaders);
+
+  for (size_t i = 0; i < songs.size(); ++i)
+  {
+    while (!reader.WaitForItem(i, 100))
     {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (NULL != pLoader.get())
-        pLoader->Load(pItem->GetPath(), tag);
+      if (m_bStop)
+        return INFO_CANCELLED;
     }
+    if (m_bStop)
+      return INFO_CANCELLED;
+
+    CFileItemPtr pItem = songs[i];
+
+    m_currentItem++;
+
+    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(m_currentItem / (float)m_itemCount * 100);
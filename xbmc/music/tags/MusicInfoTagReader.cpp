@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MusicInfoTagReader.h"
+
+#include <algorithm>
+
+#include "FileItem.h"
+#include "MusicInfoTag.h"
+#include "MusicInfoTagLoaderFactory.h"
+#include "threads/SingleLock.h"
+#include "URL.h"
+#include "utils/log.h"
+
+using namespace MUSIC_INFO;
+
+// how many items each worker may read ahead of the consumer
+#define READ_AHEAD_PER_WORKER 4
+
+CMusicInfoTagReader::CMusicInfoTagReader(const std::vector<CFileItemPtr> &items, unsigned int workers)
+  : m_items(items),
+    m_read(items.size(), false),
+    m_next(0),
+    m_consumed(0),
+    m_readAhead(std::max(workers, 1U) * READ_AHEAD_PER_WORKER),
+    m_stop(false)
+{
+  workers = std::min(workers, (unsigned int)items.size());
+  if (workers < 2)
+    return;
+
+  for (unsigned int i = 0; i < workers; i++)
+  {
+    CThread *worker = new CThread(this, "MusicTagReader");
+    worker->Create();
+    worker->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
+    m_workers.push_back(worker);
+  }
+}
+
+CMusicInfoTagReader::~CMusicInfoTagReader()
+{
+  Stop();
+  for (std::vector<CThread*>::iterator i = m_workers.begin(); i != m_workers.end(); ++i)
+  {
+    (*i)->StopThread();
+    delete *i;
+  }
+}
+
+void CMusicInfoTagReader::Stop()
+{
+  CSingleLock lock(m_section);
+  m_stop = true;
+  m_itemConsumed.notifyAll();
+  m_itemRead.notifyAll();
+}
+
+bool CMusicInfoTagReader::WaitForItem(size_t index, unsigned int milliseconds)
+{
+  if (index >= m_items.size())
+    return true;
+
+  if (m_workers.empty())
+  {
+    ReadTag(*m_items[index]);
+    return true;
+  }
+
+  CSingleLock lock(m_section);
+  if (index > m_consumed)
+  {
+    // everything before index has been handed out, let the workers move on
+    m_consumed = index;
+    m_itemConsumed.notifyAll();
+  }
+
+  if (!m_read[index] && !m_stop)
+    m_itemRead.wait(lock, milliseconds);
+
+  return m_read[index];
+}
+
+void CMusicInfoTagReader::Run()
+{
+  CSingleLock lock(m_section);
+  while (!m_stop && m_next < m_items.size())
+  {
+    if (m_next >= m_consumed + m_readAhead)
+    {
+      m_itemConsumed.wait(lock);
+      continue;
+    }
+
+    size_t index = m_next++;
+    {
+      CSingleExit exit(m_section);
+      ReadTag(*m_items[index]);
+    }
+    m_read[index] = true;
+    m_itemRead.notifyAll();
+  }
+}
+
+void CMusicInfoTagReader::ReadTag(CFileItem &item)
+{
+  CMusicInfoTag &tag = *item.GetMusicInfoTag();
+  if (tag.Loaded())
+    return;
+
+  try
+  {
+    std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(item));
+    if (NULL != pLoader.get())
+      pLoader->Load(item.GetPath(), tag);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception reading %s", __FUNCTION__, CURL::GetRedacted(item.GetPath()).c_str());
+  }
+}
@@ -0,0 +1,80 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <vector>
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+class CFileItem; typedef std::shared_ptr<CFileItem> CFileItemPtr;
+
+namespace MUSIC_INFO
+{
+  /*! \brief Reads the tags of a list of items on a bounded set of worker threads.
+
+   The workers read at most a fixed number of items ahead of the consumer, which
+   picks the results up in the original order with WaitForItem(). This overlaps
+   the I/O latency of network sources without changing the order in which the
+   scanner sees the items. With a single worker the tags are read on the calling
+   thread inside WaitForItem().
+   */
+  class CMusicInfoTagReader : public IRunnable
+  {
+  public:
+    /*! \brief Start reading the tags of items.
+     \param items the items to read the tags of. Items that already have a loaded tag are skipped.
+     \param workers the number of threads to read on.
+     */
+    CMusicInfoTagReader(const std::vector<CFileItemPtr> &items, unsigned int workers);
+    virtual ~CMusicInfoTagReader();
+
+    /*! \brief Wait for the tag of an item to be read.
+     Items must be waited for in order, which lets the workers move on.
+     \param index the position of the item in the list passed to the constructor.
+     \param milliseconds how long to wait at most.
+     \return true if the tag has been read (or couldn't be), false on timeout.
+     */
+    bool WaitForItem(size_t index, unsigned int milliseconds);
+
+    /*! \brief Stop the workers after the items they are currently reading. */
+    void Stop();
+
+    /*! \brief Read the tag of a single item with the matching tag loader. */
+    static void ReadTag(CFileItem &item);
+
+    virtual void Run();
+
+  private:
+    std::vector<CFileItemPtr> m_items;
+    std::vector<bool> m_read;
+    size_t m_next;       ///< next item to be picked up by a worker
+    size_t m_consumed;   ///< items before this one have been handed back to the consumer
+    size_t m_readAhead;  ///< how many items the workers may be ahead of the consumer
+    bool m_stop;
+
+    std::vector<CThread*> m_workers;
+    CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_itemRead;
+    XbmcThreads::ConditionVariable m_itemConsumed;
+  };
+}
@@ -0,0 +1,164 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicInfoTagReader.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+
+using namespace MUSIC_INFO;
+using namespace XFILE;
+
+#define CORPUS_PATH "special://temp/test_music_tags/"
+
+namespace
+{
+void AppendTextFrame(std::string &tag, const char *id, const std::string &text)
+{
+  // ID3v2.3 frame: id, big endian size, flags, ISO-8859-1 encoding byte, text
+  size_t size = text.size() + 1;
+  tag.append(id, 4);
+  tag += (char)((size >> 24) & 0xff);
+  tag += (char)((size >> 16) & 0xff);
+  tag += (char)((size >> 8) & 0xff);
+  tag += (char)(size & 0xff);
+  tag.append(2, '\0');
+  tag += '\0';
+  tag += text;
+}
+
+/* Write an mp3 file with an ID3v2 tag followed by a few silent MPEG frames */
+bool WriteTaggedFile(const std::string &path, int album, int track)
+{
+  std::string frames;
+  AppendTextFrame(frames, "TIT2", StringUtils::Format("Title %i", track));
+  AppendTextFrame(frames, "TPE1", StringUtils::Format("Artist %i", album % 10));
+  AppendTextFrame(frames, "TALB", StringUtils::Format("Album %i", album));
+  AppendTextFrame(frames, "TRCK", StringUtils::Format("%i", track));
+
+  // ID3v2.3 header with the synchsafe tag size
+  std::string header("ID3\x03\x00\x00", 6);
+  size_t size = frames.size();
+  header += (char)((size >> 21) & 0x7f);
+  header += (char)((size >> 14) & 0x7f);
+  header += (char)((size >> 7) & 0x7f);
+  header += (char)(size & 0x7f);
+
+  // MPEG-1 layer III, 128kbit/s, 44.1kHz frames are 417 bytes long
+  std::string frame(417, '\0');
+  frame[0] = (char)0xff;
+  frame[1] = (char)0xfb;
+  frame[2] = (char)0x90;
+  frame[3] = (char)0x64;
+
+  std::ofstream file(CSpecialProtocol::TranslatePath(path).c_str(), std::ios::binary);
+  file << header << frames;
+  for (int i = 0; i < 8; i++)
+    file << frame;
+  return file.good();
+}
+}
+
+class TestMusicInfoTagReader : public testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    CDirectory::RemoveRecursive(CORPUS_PATH);
+    CDirectory::Create(CORPUS_PATH);
+  }
+
+  virtual void TearDown()
+  {
+    CDirectory::RemoveRecursive(CORPUS_PATH);
+  }
+
+  std::vector<CFileItemPtr> CreateCorpus(int albums, int tracks)
+  {
+    std::vector<CFileItemPtr> items;
+    for (int album = 0; album < albums; album++)
+    {
+      for (int track = 1; track <= tracks; track++)
+      {
+        std::string path = StringUtils::Format("%salbum%i_track%02i.mp3", CORPUS_PATH, album, track);
+        EXPECT_TRUE(WriteTaggedFile(path, album, track));
+        items.push_back(CFileItemPtr(new CFileItem(path, false)));
+      }
+    }
+    return items;
+  }
+
+  /* Read all tags through a reader the way the scanner does */
+  void ReadAll(const std::vector<CFileItemPtr> &items, unsigned int workers)
+  {
+    CMusicInfoTagReader reader(items, workers);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+      while (!reader.WaitForItem(i, 100))
+        ;
+    }
+  }
+};
+
+TEST_F(TestMusicInfoTagReader, ReadsItemsInOrder)
+{
+  for (unsigned int workers = 1; workers <= 4; workers += 3)
+  {
+    std::vector<CFileItemPtr> items = CreateCorpus(3, 12);
+    ReadAll(items, workers);
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+      const CMusicInfoTag &tag = *items[i]->GetMusicInfoTag();
+      EXPECT_TRUE(tag.Loaded());
+      EXPECT_EQ((int)(i % 12) + 1, tag.GetTrackNumber());
+      EXPECT_EQ(StringUtils::Format("Title %i", (int)(i % 12) + 1), tag.GetTitle());
+      EXPECT_EQ(StringUtils::Format("Album %i", (int)(i / 12)), tag.GetAlbum());
+    }
+  }
+}
+
+TEST_F(TestMusicInfoTagReader, MissingFilesDontStall)
+{
+  std::vector<CFileItemPtr> items = CreateCorpus(1, 4);
+  items.insert(items.begin() + 2, CFileItemPtr(new CFileItem(CORPUS_PATH "missing.mp3", false)));
+  ReadAll(items, 4);
+
+  EXPECT_FALSE(items[2]->GetMusicInfoTag()->Loaded());
+  EXPECT_TRUE(items[4]->GetMusicInfoTag()->Loaded());
+}
+
+TEST_F(TestMusicInfoTagReader, StopsWithItemsLeft)
+{
+  std::vector<CFileItemPtr> items = CreateCorpus(4, 10);
+  {
+    CMusicInfoTagReader reader(items, 4);
+    EXPECT_TRUE(reader.WaitForItem(0, 10000));
+    reader.Stop();
+  }
+  EXPECT_TRUE(items[0]->GetMusicInfoTag()->Loaded());
+  EXPECT_FALSE(items.back()->GetMusicInfoTag()->Loaded());
+}
@@ -31,10 +31,14 @@
 #include <utility>
 
 #if defined(TARGET_POSIX)
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -67,6 +71,9 @@
 
 #define HEADER_NEWLINE        "\r\n"
 
+// size of the blocks MHD asks ContentReaderCallback to fill when serving files
+#define FILE_DOWNLOAD_BLOCK_SIZE  (64 * 1024)
+
 typedef struct {
   std::shared_ptr<XFILE::CFile> file;
   CHttpRanges ranges;
@@ -753,6 +760,47 @@ int CWebServer::CreateRedirect(struct MHD_Connection *connection, const std::str
   return MHD_YES;
 }
 
+struct MHD_Response* CWebServer::CreateFileDescriptorResponse(const std::string &filePath, const CHttpRanges &ranges) const
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094400)
+  CHttpRange range;
+  if (!ranges.GetFirst(range))
+    return nullptr;
+
+  // only plain files on a local filesystem can be handed over as descriptors
+  std::string localPath = CSpecialProtocol::TranslatePath(filePath);
+  if (localPath.empty() || URIUtils::IsURL(localPath))
+    return nullptr;
+
+  int fd = open(localPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat statBuffer;
+  if (fstat(fd, &statBuffer) != 0 || !S_ISREG(statBuffer.st_mode) ||
+      static_cast<uint64_t>(statBuffer.st_size) <= range.GetLastPosition())
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  // MHD takes over the descriptor and closes it together with the response
+  struct MHD_Response *response = MHD_create_response_from_fd_at_offset64(range.GetLength(), fd, range.GetFirstPosition());
+  if (response == nullptr)
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  if (g_advancedSettings.CanLogComponent(LOGWEBSERVER))
+    CLog::Log(LOGDEBUG, "CWebServer[%hu]: sending %" PRIu64 " bytes of %s from its file descriptor", m_port, range.GetLength(), localPath.c_str());
+
+  return response;
+#else
+  return nullptr;
+#endif
+}
+
 int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const
 {
   if (handler == nullptr)
@@ -850,18 +898,26 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
     // set the initial write position
     context->ranges.GetFirstPosition(context->writePosition);
 
+    // a single range of a local file is sent straight from its file descriptor
+    // so that MHD can use sendfile() instead of copying it through ContentReaderCallback
+    if (context->rangeCountTotal == 1)
+      response = CreateFileDescriptorResponse(filePath, context->ranges);
+
     // create the response object
-    response = MHD_create_response_from_callback(totalLength, 2048,
-                                                  &CWebServer::ContentReaderCallback,
-                                                  context.get(),
-                                                  &CWebServer::ContentReaderFreeCallback);
     if (response == nullptr)
     {
-      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
-      return MHD_NO;
-    }
+      response = MHD_create_response_from_callback(totalLength, FILE_DOWNLOAD_BLOCK_SIZE,
+                                                    &CWebServer::ContentReaderCallback,
+                                                    context.get(),
+                                                    &CWebServer::ContentReaderFreeCallback);
+      if (response == nullptr)
+      {
+        CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
+        return MHD_NO;
+      }
 
-    context.release(); // ownership was passed to mhd
+      context.release(); // ownership was passed to mhd
+    }
 
     // add Content-Range header
     if (ranged)
@@ -1049,6 +1105,10 @@ int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
   // adjust the maximum number of read bytes
   maximum = std::min(maximum, end - context->writePosition + 1);
 
+  // the boundary may have used up the whole block, the data follows with the next one
+  if (maximum == 0)
+    return written;
+
   // seek to the position if necessary
   if (context->file->GetPosition() < 0 || context->writePosition != static_cast<uint64_t>(context->file->GetPosition()))
     context->file->Seek(static_cast<uint64_t>(context->writePosition));
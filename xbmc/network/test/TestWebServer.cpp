@@ -26,6 +26,7 @@
 #include "URL.h"
 #include "filesystem/CurlFile.h"
 #include "filesystem/File.h"
+#include "filesystem/ParallelRangeReader.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
@@ -51,6 +52,9 @@ using namespace XFILE;
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
 
+// larger than a few of the blocks the webserver reads files in
+#define TEST_LARGE_FILE_SIZE    (4 * 1024 * 1024 + 123)
+
 class TestWebServer : public testing::Test
 {
 protected:
@@ -101,6 +105,45 @@ protected:
     CMediaSourceSettings::GetInstance().Clear();
   }
 
+  // creates a temporary file of the given size filled with a non-repeating pattern
+  // and shares its directory so that it can be downloaded through the webserver
+  CFile* CreateLargeTestFile(size_t size, std::string& content)
+  {
+    content.resize(size);
+    for (size_t i = 0; i < size; ++i)
+      content[i] = static_cast<char>((i * 7 + i / 251) & 0xFF);
+
+    CFile *file = XBMC_CREATETEMPFILE(".bin");
+    if (file == nullptr)
+      return nullptr;
+
+    if (file->Write(content.c_str(), content.size()) != static_cast<ssize_t>(content.size()))
+    {
+      XBMC_DELETETEMPFILE(file);
+      return nullptr;
+    }
+    file->Close();
+
+    std::string directory = CXBMCTestUtils::Instance().TempFileDirectory(file);
+    CMediaSource source;
+    source.strName = "WebServer Temp Share";
+    source.strPath = directory;
+    source.vecPaths.push_back(directory);
+    source.m_allowSharing = true;
+    source.m_iDriveType = CMediaSource::SOURCE_TYPE_LOCAL;
+    source.m_iLockMode = LOCK_MODE_EVERYONE;
+    source.m_ignore = true;
+
+    CMediaSourceSettings::GetInstance().AddShare("videos", source);
+
+    return file;
+  }
+
+  std::string GetUrlOfFile(const std::string& filePath)
+  {
+    return GetUrl(URIUtils::AddFileToFolder("vfs", CURL::Encode(filePath)));
+  }
+
   std::string GetUrl(const std::string& path)
   {
     if (path.empty())
@@ -787,4 +830,118 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   curl.SetRequestHeader(MHD_HTTP_HEADER_IF_RANGE, lastModifiedNewer.GetAsRFC1123DateTime());
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
-}
\ No newline at end of file
+}
+
+TEST_F(TestWebServer, CanReadFileOverParallelRanges)
+{
+  const std::string content = TEST_FILES_DATA_RANGES;
+
+  // tiny segments, so every few bytes are a range request of their own
+  CParallelRangeReader reader(3, 4);
+  ASSERT_TRUE(reader.Open(GetUrlOfTestFile(TEST_FILES_RANGES), content.size()));
+
+  std::string result;
+  char buffer[16];
+  ssize_t read;
+  while ((read = reader.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_EQ(0, read);
+  EXPECT_STREQ(content.c_str(), result.c_str());
+
+  // continue from the middle of a segment
+  ASSERT_EQ(7, reader.Seek(7));
+  result.clear();
+  while ((read = reader.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, read);
+  EXPECT_STREQ(content.substr(7).c_str(), result.c_str());
+  EXPECT_EQ((int64_t)content.size(), reader.GetPosition());
+
+  reader.Close();
+}
+
+TEST_F(TestWebServer, ParallelRangesMatchSourceFile)
+{
+  std::vector<char> expected;
+  CFile file;
+  ASSERT_TRUE(file.Open(URIUtils::AddFileToFolder(sourcePath, "test.png"), READ_NO_CACHE));
+  expected.resize((size_t)file.GetLength());
+  ASSERT_EQ((ssize_t)expected.size(), file.Read(expected.data(), expected.size()));
+  file.Close();
+
+  CParallelRangeReader reader(4, 512);
+  ASSERT_TRUE(reader.Open(GetUrlOfTestFile("test.png"), expected.size()));
+
+  std::vector<char> result;
+  char buffer[300];
+  ssize_t read;
+  while ((read = reader.Read(buffer, sizeof(buffer))) > 0)
+    result.insert(result.end(), buffer, buffer + read);
+  EXPECT_EQ(0, read);
+  EXPECT_TRUE(expected == result);
+
+  reader.Close();
+}
+
+TEST_F(TestWebServer, CanGetLargeFile)
+{
+  std::string content;
+  CFile *file = CreateLargeTestFile(TEST_LARGE_FILE_SIZE, content);
+  ASSERT_NE(nullptr, file);
+
+  std::string result;
+  CCurlFile curl;
+  EXPECT_TRUE(curl.Get(GetUrlOfFile(XBMC_TEMPFILEPATH(file)), result));
+  EXPECT_EQ(content.size(), result.size());
+  EXPECT_TRUE(content == result);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST_F(TestWebServer, CanGetRangedLargeFile)
+{
+  std::string content;
+  CFile *file = CreateLargeTestFile(TEST_LARGE_FILE_SIZE, content);
+  ASSERT_NE(nullptr, file);
+
+  // a single range starting in the middle of the file
+  const uint64_t first = 1000001;
+  const uint64_t last = content.size() - 4097;
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, StringUtils::Format("bytes=%" PRIu64 "-%" PRIu64, first, last));
+  EXPECT_TRUE(curl.Get(GetUrlOfFile(XBMC_TEMPFILEPATH(file)), result));
+  EXPECT_STREQ(HttpRangeUtils::GenerateContentRangeHeaderValue(first, last, content.size()).c_str(), curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_CONTENT_RANGE).c_str());
+  EXPECT_TRUE(content.substr(first, last - first + 1) == result);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST_F(TestWebServer, CanGetMultipleRangesOfLargeFile)
+{
+  std::string content;
+  CFile *file = CreateLargeTestFile(TEST_LARGE_FILE_SIZE, content);
+  ASSERT_NE(nullptr, file);
+
+  // ranges spanning several read blocks each
+  const std::string range = "bytes=0-99999,200000-1300000,-70000";
+  CHttpRanges ranges;
+  ASSERT_TRUE(ranges.Parse(range, content.size()));
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+  EXPECT_TRUE(curl.Get(GetUrlOfFile(XBMC_TEMPFILEPATH(file)), result));
+
+  // every range must be part of the multipart response in the requested order
+  size_t position = 0;
+  for (HttpRanges::const_iterator it = ranges.Begin(); it != ranges.End(); ++it)
+  {
+    const std::string expected = content.substr(static_cast<size_t>(it->GetFirstPosition()), static_cast<size_t>(it->GetLength()));
+    position = result.find(expected, position);
+    ASSERT_NE(std::string::npos, position);
+    position += expected.size();
+  }
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
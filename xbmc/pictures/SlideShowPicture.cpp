@@ -21,6 +21,7 @@
 #include "SlideShowPicture.h"
 #include "system.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITexture.h"
 #include "guilib/Texture.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -915,6 +916,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
 
   glEnd();
 #elif defined(HAS_GLES)
+  CGUITexture::FlushBatch();
   if (pTexture)
   {
     pTexture->LoadToGPU();
@@ -24,6 +24,7 @@
 #if HAS_GLES == 2
 
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITextureGLES.h"
 #include "settings/AdvancedSettings.h"
 #include "RenderSystemGLES.h"
 #include "guilib/MatrixGLES.h"
@@ -224,6 +225,8 @@ bool CRenderSystemGLES::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGLES::FlushBatch();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -274,6 +277,8 @@ void CRenderSystemGLES::PresentRender(bool rendered, bool videoLayer)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   PresentRenderImpl(rendered);
 
   // if video is rendered to a separate layer, we should not block this thread
@@ -315,6 +320,8 @@ void CRenderSystemGLES::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -343,6 +350,8 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
 { 
   if (!m_bRenderCreated)
     return;
+
+  CGUITextureGLES::FlushBatch();
   
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
   
@@ -420,6 +429,8 @@ void CRenderSystemGLES::ApplyHardwareTransform(const TransformMatrix &finalMatri
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glMatrixModview.Push();
   GLfloat matrix[4][4];
 
@@ -441,6 +452,8 @@ void CRenderSystemGLES::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glMatrixModview.PopLoad();
 }
 
@@ -467,6 +480,8 @@ void CRenderSystemGLES::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -501,6 +516,9 @@ void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUITextureGLES::FlushBatch();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -552,6 +570,9 @@ void CRenderSystemGLES::InitialiseGUIShader()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  // batched GUI textures have to be drawn first
+  CGUITextureGLES::FlushBatch();
+
   m_method = method;
   if (m_pGUIshader[m_method])
   {
@@ -122,6 +122,9 @@ void CAdvancedSettings::Initialize()
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
 
+  // seconds of the next track paplayer decodes in advance, 0 to disable
+  m_audioDecodeAhead = 0;
+
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
   m_omxDecodeStartWithValidFrame = true;
@@ -285,6 +288,7 @@ void CAdvancedSettings::Initialize()
   m_musicArtistSeparators = { ";", ":", "|", " feat. ", " ft. " };
   m_videoItemSeparator = " / ";
   m_iMusicLibraryDateAdded = 1; // prefer mtime over ctime and current time
+  m_iMusicLibraryTagReaders = 4; // threads reading tags while scanning
 
   m_bVideoLibraryAllItemsOnBottom = false;
   m_iVideoLibraryRecentlyAddedItems = 25;
@@ -368,10 +372,18 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  // size the forward cache from stream bitrate and source latency and
+  // prefetch the index region of mkv/mp4 files
+  m_cacheAdaptive = true;
+  // parallel range requests for http and webdav sources, 1 disables
+  m_cacheConnections = 1;
+  // bytes of smb/nfs directory listings kept on disk, 0 disables
+  m_cacheDirectorySize = 32 * 1024 * 1024;
 
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
+  m_jsonOutputStreamed = true;
   m_jsonTcpPort = 9090;
 
   m_enableMultimediaKeys = false;
@@ -383,6 +395,7 @@ void CAdvancedSettings::Initialize()
 #endif
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
+  m_guiTextureAtlas = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -502,6 +515,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+    XMLUtils::GetInt(pElement, "decodeahead", m_audioDecodeAhead, 0, 30);
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -712,6 +726,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
+    XMLUtils::GetInt(pElement, "tagreaders", m_iMusicLibraryTagReaders, 1, 32);
     //Music artist name separators
     TiXmlElement* separators = pElement->FirstChildElement("artistseparators");
     if (separators)
@@ -776,12 +791,16 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetBoolean(pElement, "adaptive", m_cacheAdaptive);
+    XMLUtils::GetUInt(pElement, "connections", m_cacheConnections, 1, 8);
+    XMLUtils::GetUInt(pElement, "directorysize", m_cacheDirectorySize);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "compactoutput", m_jsonOutputCompact);
+    XMLUtils::GetBoolean(pElement, "streamoutput", m_jsonOutputStreamed);
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
@@ -1147,6 +1166,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
+    XMLUtils::GetBoolean(pElement, "textureatlas", m_guiTextureAtlas);
   }
 
   std::string seekSteps;
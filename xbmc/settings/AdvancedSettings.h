@@ -142,6 +142,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    int m_audioDecodeAhead;
 
     bool  m_omxDecodeStartWithValidFrame;
 
@@ -253,6 +254,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     int m_iMusicLibraryRecentlyAddedItems;
     int m_iMusicLibraryDateAdded;
+    int m_iMusicLibraryTagReaders;
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
     std::string m_strMusicLibraryAlbumFormat;
@@ -338,13 +340,18 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
+    bool m_guiTextureAtlas;
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    bool m_cacheAdaptive;
+    unsigned int m_cacheConnections;
+    unsigned int m_cacheDirectorySize;
 
     bool m_jsonOutputCompact;
+    bool m_jsonOutputStreamed;
     unsigned int m_jsonTcpPort;
 
     bool m_enableMultimediaKeys;
@@ -22,6 +22,42 @@
 
 using namespace Actor;
 
+Message::Message()
+{
+  isSync = false;
+  data = NULL;
+  event = NULL;
+  replyMessage = NULL;
+  next = NULL;
+  largeBuffer = NULL;
+  largeBufferSize = 0;
+  syncEvent = NULL;
+}
+
+Message::~Message()
+{
+  delete [] largeBuffer;
+  delete syncEvent;
+}
+
+void Message::SetPayload(const void *payload, int size)
+{
+  if (size > MSG_INTERNAL_BUFFER_SIZE)
+  {
+    if (size > largeBufferSize)
+    {
+      delete [] largeBuffer;
+      largeBuffer = new uint8_t[size];
+      largeBufferSize = size;
+    }
+    data = largeBuffer;
+  }
+  else
+    data = buffer;
+  memcpy(data, payload, size);
+  payloadSize = size;
+}
+
 void Message::Release()
 {
   bool skip;
@@ -33,13 +69,9 @@ void Message::Release()
   if (skip)
     return;
 
-  // free data buffer
-  if (data != buffer)
-    delete [] data;
-
-  // delete event in case of sync message
-  if (event)
-    delete event;
+  // data buffer and event stay with the message for the next use
+  data = NULL;
+  event = NULL;
 
   origin->ReturnMessage(this);
 }
@@ -63,13 +95,7 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
     msg->isOut = !isOut;
     replyMessage = msg;
     if (data)
-    {
-      if (size > MSG_INTERNAL_BUFFER_SIZE)
-        msg->data = new uint8_t[size];
-      else
-        msg->data = msg->buffer;
-      memcpy(msg->data, data, size);
-    }
+      msg->SetPayload(data, size);
   }
 
   origin->Unlock();
@@ -80,30 +106,100 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
   return true;
 }
 
+MessageQueue::MessageQueue()
+{
+  head = &stub;
+  tail = &stub;
+  requeuedHead = NULL;
+  requeuedTail = NULL;
+  count = 0;
+}
+
+void MessageQueue::Push(Message *msg)
+{
+  msg->next.store(NULL, std::memory_order_relaxed);
+  Message *prev = head.exchange(msg, std::memory_order_acq_rel);
+  // the message becomes visible to the consumer with this store
+  prev->next.store(msg, std::memory_order_release);
+  count.fetch_add(1, std::memory_order_release);
+}
+
+Message *MessageQueue::Pop()
+{
+  if (requeuedHead)
+  {
+    Message *msg = requeuedHead;
+    requeuedHead = msg->next.load(std::memory_order_relaxed);
+    if (!requeuedHead)
+      requeuedTail = NULL;
+    count.fetch_sub(1, std::memory_order_release);
+    return msg;
+  }
+
+  Message *first = tail;
+  Message *next = first->next.load(std::memory_order_acquire);
+  if (first == &stub)
+  {
+    if (!next)
+      return NULL;
+    tail = next;
+    first = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next)
+  {
+    tail = next;
+    count.fetch_sub(1, std::memory_order_release);
+    return first;
+  }
+
+  // a producer has swapped the head but not linked its message yet,
+  // it sets the event after linking, so just report empty
+  if (first != head.load(std::memory_order_acquire))
+    return NULL;
+
+  // first is the last message, put the stub behind it to be able to take it
+  Push(&stub);
+  count.fetch_sub(1, std::memory_order_release);
+  next = first->next.load(std::memory_order_acquire);
+  if (next)
+  {
+    tail = next;
+    count.fetch_sub(1, std::memory_order_release);
+    return first;
+  }
+  return NULL;
+}
+
+void MessageQueue::Requeue(Message *msg)
+{
+  msg->next.store(NULL, std::memory_order_relaxed);
+  if (requeuedTail)
+    requeuedTail->next.store(msg, std::memory_order_relaxed);
+  else
+    requeuedHead = msg;
+  requeuedTail = msg;
+  count.fetch_add(1, std::memory_order_release);
+}
+
 Protocol::~Protocol()
 {
   Message *msg;
   Purge();
-  while (!freeMessageQueue.empty())
-  {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+  while ((msg = freeMessageQueue.Pop()) != NULL)
     delete msg;
-  }
 }
 
 Message *Protocol::GetMessage()
 {
-  Message *msg;
+  Message *msg = NULL;
 
-  CSingleLock lock(criticalSection);
-
-  if (!freeMessageQueue.empty())
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    CSingleTryLock lock(freeMessageLock);
+    if (lock.IsOwner())
+      msg = freeMessageQueue.Pop();
   }
-  else
+  if (!msg)
     msg = new Message();
 
   msg->isSync = false;
@@ -120,9 +216,7 @@ Message *Protocol::GetMessage()
 
 void Protocol::ReturnMessage(Message *msg)
 {
-  CSingleLock lock(criticalSection);
-
-  freeMessageQueue.push(msg);
+  freeMessageQueue.Push(msg);
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* = 0 */, Message *outMsg /* = NULL */)
@@ -137,17 +231,9 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = true;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetPayload(data, size);
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
+  outMessages.Push(msg);
   containerOutEvent->Set();
 
   return true;
@@ -165,17 +251,9 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = false;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetPayload(data, size);
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
+  inMessages.Push(msg);
   containerInEvent->Set();
 
   return true;
@@ -187,7 +265,9 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  if (!msg->syncEvent)
+    msg->syncEvent = new CEvent;
+  msg->event = msg->syncEvent;
   msg->event->Reset();
   SendOutMessage(signal, data, size, msg);
 
@@ -216,28 +296,27 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
 
 bool Protocol::ReceiveOutMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (outMessages.empty() || outDefered)
+  // polling an empty port does not need the lock
+  if (outDefered || outMessages.IsEmpty())
     return false;
 
-  *msg = outMessages.front();
-  outMessages.pop();
+  CSingleLock lock(criticalSection);
 
-  return true;
+  *msg = outMessages.Pop();
+
+  return *msg != NULL;
 }
 
 bool Protocol::ReceiveInMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (inMessages.empty() || inDefered)
+  if (inDefered || inMessages.IsEmpty())
     return false;
 
-  *msg = inMessages.front();
-  inMessages.pop();
+  CSingleLock lock(criticalSection);
+
+  *msg = inMessages.Pop();
 
-  return true;
+  return *msg != NULL;
 }
 
 
@@ -252,46 +331,43 @@ void Protocol::Purge()
     msg->Release();
 }
 
-void Protocol::PurgeIn(int signal)
+void Protocol::PurgeQueue(MessageQueue &queue, int signal)
 {
   Message *msg;
-  std::queue<Message*> msgs;
+  Message *keepHead = NULL, *keepTail = NULL;
 
   CSingleLock lock(criticalSection);
 
-  while (!inMessages.empty())
+  // take everything out and put back the ones to keep in front of
+  // messages arriving in the meantime
+  while ((msg = queue.Pop()) != NULL)
   {
-    msg = inMessages.front();
-    inMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
+    if (msg->signal == signal)
+    {
+      msg->Release();
+      continue;
+    }
+    msg->next.store(NULL, std::memory_order_relaxed);
+    if (keepTail)
+      keepTail->next.store(msg, std::memory_order_relaxed);
+    else
+      keepHead = msg;
+    keepTail = msg;
   }
-  while (!msgs.empty())
+  while (keepHead)
   {
-    msg = msgs.front();
-    msgs.pop();
-    inMessages.push(msg);
+    msg = keepHead;
+    keepHead = msg->next.load(std::memory_order_relaxed);
+    queue.Requeue(msg);
   }
 }
 
-void Protocol::PurgeOut(int signal)
+void Protocol::PurgeIn(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
+  PurgeQueue(inMessages, signal);
+}
 
-  while (!outMessages.empty())
-  {
-    msg = outMessages.front();
-    outMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    outMessages.push(msg);
-  }
+void Protocol::PurgeOut(int signal)
+{
+  PurgeQueue(outMessages, signal);
 }
@@ -21,7 +21,7 @@
 #pragma once
 
 #include "threads/Thread.h"
-#include <queue>
+#include <atomic>
 #include "memory.h"
 
 #define MSG_INTERNAL_BUFFER_SIZE 32
@@ -30,10 +30,12 @@ namespace Actor
 {
 
 class Protocol;
+class MessageQueue;
 
 class Message
 {
   friend class Protocol;
+  friend class MessageQueue;
 public:
   int signal;
   bool isSync;
@@ -51,7 +53,39 @@ public:
   bool Reply(int sig, void *data = NULL, int size = 0);
 
 private:
-  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL;};
+  Message();
+  ~Message();
+  void SetPayload(const void *payload, int size);
+
+  std::atomic<Message*> next;
+  // payloads exceeding the internal buffer, kept for reuse
+  uint8_t *largeBuffer;
+  int largeBufferSize;
+  // event of sync messages, kept for reuse
+  CEvent *syncEvent;
+};
+
+/**
+ * Intrusive message queue after Dmitry Vyukov's non-blocking MPSC queue.
+ * Any thread may push without taking a lock, Pop and Requeue have to be
+ * serialized by the owner.
+ */
+class MessageQueue
+{
+public:
+  MessageQueue();
+  void Push(Message *msg);
+  Message *Pop();
+  void Requeue(Message *msg);
+  bool IsEmpty() const { return count.load(std::memory_order_acquire) <= 0; };
+
+protected:
+  std::atomic<Message*> head;
+  Message *tail;
+  Message stub;
+  // consumer owned messages which go before the ones in the queue
+  Message *requeuedHead, *requeuedTail;
+  std::atomic<int> count;
 };
 
 class Protocol
@@ -77,11 +111,17 @@ public:
   std::string portName;
 
 protected:
+  void PurgeQueue(MessageQueue &queue, int signal);
+
   CEvent *containerInEvent, *containerOutEvent;
+  // serializes receivers and sync replies, senders don't lock
   CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
+  MessageQueue outMessages;
+  MessageQueue inMessages;
+  // messages are taken from the free list by whoever gets the lock first,
+  // everyone else allocates a new one instead of waiting
+  CCriticalSection freeMessageLock;
+  MessageQueue freeMessageQueue;
   bool inDefered, outDefered;
 };
 
@@ -0,0 +1,160 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CollationKey.h"
+#include "LangInfo.h"
+
+#include <algorithm>
+#include <map>
+#include <stdint.h>
+
+// AlphaNumericCompare() compares up to 15 digits as one number
+#define MAX_NUMBER_DIGITS 15
+
+namespace
+{
+inline bool IsDigit(wchar_t c)
+{
+  return c >= L'0' && c <= L'9';
+}
+
+inline wchar_t ToLower(wchar_t c)
+{
+  if (c >= L'A' && c <= L'Z')
+    return c + (L'a' - L'A');
+  return c;
+}
+
+class CCharacterRanks
+{
+public:
+  CCharacterRanks() : m_ascii(128, 0) { }
+
+  void Add(wchar_t c)
+  {
+    if (c >= 0 && c < 128)
+      m_ascii[c] = 1;
+    else
+      m_other[c] = 1;
+  }
+
+  // sort the characters by their collation and number them, starting at 1
+  void Rank(const std::collate<wchar_t> &collate)
+  {
+    std::vector<wchar_t> characters;
+    for (wchar_t c = 0; c < 128; c++)
+    {
+      if (m_ascii[c] != 0)
+        characters.push_back(c);
+    }
+    for (std::map<wchar_t, uint32_t>::const_iterator it = m_other.begin(); it != m_other.end(); ++it)
+      characters.push_back(it->first);
+
+    std::stable_sort(characters.begin(), characters.end(), [&collate](wchar_t left, wchar_t right)
+    {
+      return collate.compare(&left, &left + 1, &right, &right + 1) < 0;
+    });
+
+    // characters that collate the same share a rank
+    uint32_t rank = 0;
+    for (size_t i = 0; i < characters.size(); i++)
+    {
+      if (i == 0 || collate.compare(&characters[i - 1], &characters[i - 1] + 1, &characters[i], &characters[i] + 1) != 0)
+        rank++;
+      Set(characters[i], rank);
+    }
+    m_wide = rank > 0xFFFF;
+  }
+
+  void Append(std::string &key, wchar_t c) const
+  {
+    uint32_t rank = (c >= 0 && c < 128) ? m_ascii[c] : m_other.find(c)->second;
+    if (m_wide)
+      key.push_back((char)(rank >> 16));
+    key.push_back((char)(rank >> 8));
+    key.push_back((char)rank);
+  }
+
+private:
+  void Set(wchar_t c, uint32_t rank)
+  {
+    if (c >= 0 && c < 128)
+      m_ascii[c] = rank;
+    else
+      m_other[c] = rank;
+  }
+
+  std::vector<uint32_t> m_ascii;
+  std::map<wchar_t, uint32_t> m_other;
+  bool m_wide = false;
+};
+}
+
+CCollationKeyGenerator::CCollationKeyGenerator()
+  : m_collate(std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale()))
+{ }
+
+CCollationKeyGenerator::CCollationKeyGenerator(const std::locale &locale)
+  : m_collate(std::use_facet<std::collate<wchar_t> >(locale))
+{ }
+
+void CCollationKeyGenerator::GetKeys(const std::vector<std::wstring> &labels, std::vector<std::string> &keys) const
+{
+  // rank all characters used by the labels. Numbers sort where their digits
+  // would, which is where '0' is.
+  CCharacterRanks ranks;
+  for (std::vector<std::wstring>::const_iterator label = labels.begin(); label != labels.end(); ++label)
+  {
+    for (std::wstring::const_iterator c = label->begin(); c != label->end(); ++c)
+      ranks.Add(IsDigit(*c) ? L'0' : ToLower(*c));
+  }
+  ranks.Rank(m_collate);
+
+  keys.resize(labels.size());
+  for (size_t i = 0; i < labels.size(); i++)
+  {
+    std::string &key = keys[i];
+    key.clear();
+    key.reserve(labels[i].size() * 2);
+
+    const wchar_t *c = labels[i].c_str();
+    while (*c != 0)
+    {
+      if (IsDigit(*c))
+      {
+        const wchar_t *start = c;
+        uint64_t number = 0;
+        while (IsDigit(*c) && c < start + MAX_NUMBER_DIGITS)
+        {
+          number *= 10;
+          number += *c++ - L'0';
+        }
+
+        // numbers of up to 15 digits fit into 7 bytes
+        ranks.Append(key, L'0');
+        for (int shift = 48; shift >= 0; shift -= 8)
+          key.push_back((char)(number >> shift));
+        continue;
+      }
+
+      ranks.Append(key, ToLower(*c++));
+    }
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <locale>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Creates binary sort keys for a list of labels.
+
+ Comparing two keys with memcmp() (or std::string::compare()) gives the same
+ result as comparing their labels with StringUtils::AlphaNumericCompare(): runs
+ of digits compare by their numeric value, ASCII letters compare without case
+ and everything else compares using the collation of the locale. Like
+ AlphaNumericCompare() this expects the digits to collate next to each other.
+
+ Characters are stored as their rank among the characters of all labels, so
+ keys can only be compared with keys created by the same call.
+ */
+class CCollationKeyGenerator
+{
+public:
+  CCollationKeyGenerator();
+  explicit CCollationKeyGenerator(const std::locale &locale);
+
+  /*! \brief Create the sort keys of a list of labels.
+   \param labels the labels to create the keys for.
+   \param keys receives the key of every label in the same order.
+   */
+  void GetKeys(const std::vector<std::wstring> &labels, std::vector<std::string> &keys) const;
+
+private:
+  const std::collate<wchar_t> &m_collate;
+};
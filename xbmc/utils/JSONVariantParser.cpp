@@ -69,7 +69,7 @@ CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int lengt
 
   parser.push_buffer(json, length);
 
-  return callback.GetOutput();
+  return std::move(callback.GetOutput());
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
@@ -135,7 +135,7 @@ int CJSONVariantParser::ParseMapKey(void * ctx, const unsigned char * stringVal,
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->m_key = std::string((const char *)stringVal, 0, stringLen);
+  parser->m_key.assign((const char *)stringVal, stringLen);
 
   return 1;
 }
@@ -167,27 +167,34 @@ int CJSONVariantParser::ParseArrayEnd(void * ctx)
   return 1;
 }
 
-void CJSONVariantParser::PushObject(CVariant variant)
+void CJSONVariantParser::PushObject(CVariant &&variant)
 {
+  // values are moved into their parent and filled in place from there on
+  CVariant *pushed = NULL;
   if (m_status == ParseObject)
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    pushed = &(*m_parse[m_parse.size() - 1])[m_key];
+    *pushed = std::move(variant);
+    m_parse.push_back(pushed);
   }
   else if (m_status == ParseArray)
   {
     CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    temp->push_back(std::move(variant));
+    pushed = &(*temp)[temp->size() - 1];
+    m_parse.push_back(pushed);
   }
   else if (m_parse.empty())
   {
-    m_parse.push_back(new CVariant(variant));
+    pushed = new CVariant(std::move(variant));
+    m_parse.push_back(pushed);
   }
 
-  if (variant.isObject())
+  if (pushed == NULL)
+    m_status = ParseVariable;
+  else if (pushed->isObject())
     m_status = ParseObject;
-  else if (variant.isArray())
+  else if (pushed->isArray())
     m_status = ParseArray;
   else
     m_status = ParseVariable;
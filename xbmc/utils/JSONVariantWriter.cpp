@@ -18,62 +18,98 @@
  *
  */
 
+#include <cmath>
+#include <iomanip>
 #include <locale>
+#include <sstream>
+
+#include <yajl/yajl_version.h>
 
 #include "JSONVariantWriter.h"
 #include "utils/Variant.h"
 
-std::string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+CJSONVariantWriter::CJSONVariantWriter(bool compact)
 {
-  std::string output;
+  m_generator = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_generator, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_generator, yajl_gen_indent_string, "\t");
+}
 
-  yajl_gen g = yajl_gen_alloc(NULL);
-  yajl_gen_config(g, yajl_gen_beautify, compact ? 0 : 1);
-  yajl_gen_config(g, yajl_gen_indent_string, "\t");
+CJSONVariantWriter::~CJSONVariantWriter()
+{
+  yajl_gen_clear(m_generator);
+  yajl_gen_free(m_generator);
+}
 
-  // Set locale to classic ("C") to ensure valid JSON numbers
-#ifndef TARGET_WINDOWS
-  const char *currentLocale = setlocale(LC_NUMERIC, NULL);
-  std::string backupLocale;
-  if (currentLocale != NULL && (currentLocale[0] != 'C' || currentLocale[1] != 0))
-  {
-    backupLocale = currentLocale;
-    setlocale(LC_NUMERIC, "C");
-  }
-#else  // TARGET_WINDOWS
-  const wchar_t* const currentLocale = _wsetlocale(LC_NUMERIC, NULL);
-  std::wstring backupLocale;
-  if (currentLocale != NULL && (currentLocale[0] != L'C' || currentLocale[1] != 0))
-  {
-    backupLocale = currentLocale;
-    _wsetlocale(LC_NUMERIC, L"C");
-  }
-#endif // TARGET_WINDOWS
+bool CJSONVariantWriter::BeginObject()
+{
+  return yajl_gen_status_ok == yajl_gen_map_open(m_generator);
+}
 
-  if (InternalWrite(g, value))
-  {
-    const unsigned char * buffer;
+bool CJSONVariantWriter::EndObject()
+{
+  return yajl_gen_status_ok == yajl_gen_map_close(m_generator);
+}
 
-    size_t length;
-    yajl_gen_get_buf(g, &buffer, &length);
-    output = std::string((const char *)buffer, length);
-  }
+bool CJSONVariantWriter::BeginArray()
+{
+  return yajl_gen_status_ok == yajl_gen_array_open(m_generator);
+}
 
-  // Re-set locale to what it was before using yajl
-#ifndef TARGET_WINDOWS
-  if (!backupLocale.empty())
-    setlocale(LC_NUMERIC, backupLocale.c_str());
-#else  // TARGET_WINDOWS
-  if (!backupLocale.empty())
-    _wsetlocale(LC_NUMERIC, backupLocale.c_str());
-#endif // TARGET_WINDOWS
+bool CJSONVariantWriter::EndArray()
+{
+  return yajl_gen_status_ok == yajl_gen_array_close(m_generator);
+}
+
+bool CJSONVariantWriter::Key(const std::string &key)
+{
+  return yajl_gen_status_ok == yajl_gen_string(m_generator, (const unsigned char*)key.c_str(), key.length());
+}
+
+bool CJSONVariantWriter::Value(const CVariant &value)
+{
+  return InternalWrite(m_generator, value);
+}
+
+void CJSONVariantWriter::Flush(std::string &output)
+{
+  const unsigned char * buffer;
+  size_t length;
+  yajl_gen_get_buf(m_generator, &buffer, &length);
+  output.append((const char *)buffer, length);
+  yajl_gen_clear(m_generator);
+}
 
-  yajl_gen_clear(g);
-  yajl_gen_free(g);
+std::string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+{
+  std::string output;
+
+  CJSONVariantWriter writer(compact);
+  if (writer.Value(value))
+    writer.Flush(output);
 
   return output;
 }
 
+bool CJSONVariantWriter::WriteDouble(yajl_gen g, double value)
+{
+  if (!std::isfinite(value))
+    return false;
+
+  // format like yajl_gen_double() does, but with the classic ("C") locale
+  // instead of the process wide one so the decimal point is always a '.'
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  stream << std::setprecision(20) << value;
+  std::string number = stream.str();
+#if YAJL_VERSION >= 20100
+  if (number.find_first_not_of("0123456789-") == std::string::npos)
+    number += ".0";
+#endif
+
+  return yajl_gen_status_ok == yajl_gen_number(g, number.c_str(), number.length());
+}
+
 bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 {
   bool success = false;
@@ -87,7 +123,7 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
     success = yajl_gen_status_ok == yajl_gen_integer(g, (long long int)value.asUnsignedInteger());
     break;
   case CVariant::VariantTypeDouble:
-    success = yajl_gen_status_ok == yajl_gen_double(g, value.asDouble());
+    success = WriteDouble(g, value.asDouble());
     break;
   case CVariant::VariantTypeBoolean:
     success = yajl_gen_status_ok == yajl_gen_bool(g, value.asBoolean() ? 1 : 0);
@@ -27,7 +27,35 @@ class CVariant;
 class CJSONVariantWriter
 {
 public:
+  /*!
+   \brief Creates an incremental writer
+
+   The output is generated piece by piece through the Begin*(), End*(), Key()
+   and Value() calls and can be moved out with Flush() at any point, so large
+   documents never have to exist as a single CVariant tree or output buffer.
+   */
+  explicit CJSONVariantWriter(bool compact);
+  ~CJSONVariantWriter();
+
+  bool BeginObject();
+  bool EndObject();
+  bool BeginArray();
+  bool EndArray();
+  bool Key(const std::string &key);
+  bool Value(const CVariant &value);
+
+  /*!
+   \brief Appends everything generated since the last flush to the given string
+   */
+  void Flush(std::string &output);
+
   static std::string Write(const CVariant &value, bool compact);
 private:
+  CJSONVariantWriter(const CJSONVariantWriter&);
+  CJSONVariantWriter& operator=(const CJSONVariantWriter&);
+
   static bool InternalWrite(yajl_gen g, const CVariant &value);
+  static bool WriteDouble(yajl_gen g, double value);
+
+  yajl_gen m_generator;
 };
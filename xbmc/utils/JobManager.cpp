@@ -23,6 +23,7 @@
 #include <functional>
 #include <stdexcept>
 #include "threads/SingleLock.h"
+#include "threads/ThreadLocal.h"
 #include "utils/log.h"
 #ifdef TARGET_POSIX
 #include "linux/XTimeUtils.h"
@@ -30,6 +31,8 @@
 
 #include "system.h"
 
+#define JOB_MAX_WORKERS   5U
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -37,25 +40,28 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+namespace
+{
+// the worker running on the current thread, if any
+XbmcThreads::ThreadLocal<CJobWorker> currentWorker;
+}
+
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int index) : CThread("JobWorker")
 {
   m_jobManager = manager;
-  Create(true); // start work immediately, and kill ourselves when we're done
+  m_index = index;
+  Create(); // start work immediately
 }
 
 CJobWorker::~CJobWorker()
 {
-  // while we should already be removed from the job manager, if an exception
-  // occurs during processing that we haven't caught, we may skip over that step.
-  // Thus, before we go out of scope, ensure the job manager knows we're gone.
-  m_jobManager->RemoveWorker(this);
-  if(!IsAutoDelete())
-    StopThread();
+  StopThread();
 }
 
 void CJobWorker::Process()
 {
   SetPriority( GetMinPriority() );
+  currentWorker.set(this);
   while (true)
   {
     // request an item from our manager (this call is blocking)
@@ -74,6 +80,7 @@ void CJobWorker::Process()
     }
     m_jobManager->OnJobComplete(success, job);
   }
+  currentWorker.set(NULL);
 }
 
 void CJobQueue::CJobPointer::CancelJob()
@@ -180,15 +187,22 @@ CJobManager &CJobManager::GetInstance()
 }
 
 CJobManager::CJobManager()
+  : m_jobCounter(0)
+  , m_pauseJobs(false)
+  , m_running(true)
+  , m_active(0)
+  , m_workerCount(0)
+  , m_poolSize(0)
+  , m_stopWorkers(false)
+  , m_sleeping(0)
 {
-  m_jobCounter = 0;
-  m_running = true;
-  m_pauseJobs = false;
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    m_queued[priority] = 0;
 }
 
 void CJobManager::Restart()
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(m_poolSection);
 
   if (m_running)
     throw std::logic_error("CJobManager already running");
@@ -197,27 +211,45 @@ void CJobManager::Restart()
 
 void CJobManager::CancelJobs()
 {
-  CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), std::mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
-  }
+    CSingleLock lock(m_poolSection);
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), std::mem_fun_ref(&CWorkItem::Cancel));
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      std::vector<CJobQueueLocked*> queues;
+      queues.push_back(&m_jobQueue[priority]);
+      for (WorkerStates::iterator it = m_workerStates.begin(); it != m_workerStates.end(); ++it)
+        queues.push_back(&(*it)->m_queue[priority]);
+
+      for (std::vector<CJobQueueLocked*>::iterator queue = queues.begin(); queue != queues.end(); ++queue)
+      {
+        CSingleLock queueLock((*queue)->m_section);
+        for (JobQueue::iterator it = (*queue)->m_jobs.begin(); it != (*queue)->m_jobs.end(); ++it)
+        {
+          --m_queued[priority];
+          int state = CWorkItem::STATE_QUEUED;
+          if ((*it)->m_state.compare_exchange_strong(state, CWorkItem::STATE_CANCELLED) ||
+              state == CWorkItem::STATE_CANCELLED)
+            FreeItem(*it);
+        }
+        (*queue)->m_jobs.clear();
+      }
+    }
 
-  // tell our workers to finish
-  while (m_workers.size())
-  {
-    lock.Leave();
-    m_jobEvent.Set();
-    Sleep(0); // yield after setting the event to give the workers some time to die
-    lock.Enter();
+    // cancel any callbacks on jobs still processing
+    for (WorkerStates::iterator it = m_workerStates.begin(); it != m_workerStates.end(); ++it)
+    {
+      CSingleLock workerLock((*it)->m_section);
+      if ((*it)->m_current)
+        (*it)->m_current->m_callback = NULL;
+    }
   }
+
+  // tell our workers to finish
+  StopWorkers();
 }
 
 CJobManager::~CJobManager()
@@ -226,83 +258,270 @@ CJobManager::~CJobManager()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   if (!m_running)
     return 0;
 
+  if (!m_poolSize)
+    StartWorkers();
+
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem *work = new CWorkItem(job, id, priority, callback);
+  RegisterItem(work);
+
+  // jobs added by a job stay with its worker until another worker steals them
+  CJobWorker *worker = currentWorker.get();
+  CJobQueueLocked &queue = (worker && worker->m_jobManager == this)
+                           ? m_workerStates[worker->m_index]->m_queue[priority]
+                           : m_jobQueue[priority];
+  {
+    CSingleLock lock(queue.m_section);
+    queue.m_jobs.push_back(work);
+  }
+  ++m_queued[priority];
+
+  // CancelJobs() may have cleared the queues before we got here
+  if (!m_running)
+  {
+    CancelJob(id);
+    return 0;
+  }
 
-  StartWorkers(priority);
-  return work.m_id;
+  WakeWorkers(false);
+  return id;
 }
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
-  CSingleLock lock(m_section);
+  {
+    CRegistryShard &shard = m_registry[jobID % REGISTRY_SHARDS];
+    CSingleLock lock(shard.m_section);
+    std::map<unsigned int, CWorkItem*>::iterator it = shard.m_items.find(jobID);
+    if (it == shard.m_items.end())
+      return;
+
+    // if the job is in progress, the only thing to do is to remove the callback
+    CWorkItem *item = it->second;
+    item->m_callback = NULL;
+    int state = CWorkItem::STATE_QUEUED;
+    if (!item->m_state.compare_exchange_strong(state, CWorkItem::STATE_CANCELLED))
+      return;
+  }
 
-  // check whether we have this job in the queue
+  // the job won't be started anymore, take it out of its queue. if a worker
+  // has taken it in the meantime, the worker frees it instead.
+  CSingleLock lock(m_poolSection);
   for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
-    {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+    if (RemoveQueued(m_jobQueue[priority], (CJob::PRIORITY)priority, jobID))
       return;
+
+    for (WorkerStates::iterator it = m_workerStates.begin(); it != m_workerStates.end(); ++it)
+    {
+      if (RemoveQueued((*it)->m_queue[priority], (CJob::PRIORITY)priority, jobID))
+        return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
-void CJobManager::StartWorkers(CJob::PRIORITY priority)
+bool CJobManager::RemoveQueued(CJobQueueLocked &queue, CJob::PRIORITY priority, unsigned int jobID)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(queue.m_section);
+  for (JobQueue::iterator it = queue.m_jobs.begin(); it != queue.m_jobs.end(); ++it)
+  {
+    if ((*it)->m_id == jobID)
+    {
+      CWorkItem *item = *it;
+      queue.m_jobs.erase(it);
+      --m_queued[priority];
+      lock.Leave();
+      FreeItem(item);
+      return true;
+    }
+  }
+  return false;
+}
+
+void CJobManager::RegisterItem(CWorkItem *item)
+{
+  CRegistryShard &shard = m_registry[item->m_id % REGISTRY_SHARDS];
+  CSingleLock lock(shard.m_section);
+  shard.m_items[item->m_id] = item;
+}
+
+void CJobManager::FreeItem(CWorkItem *item)
+{
+  {
+    CRegistryShard &shard = m_registry[item->m_id % REGISTRY_SHARDS];
+    CSingleLock lock(shard.m_section);
+    shard.m_items.erase(item->m_id);
+  }
+  delete item->m_job;
+  delete item;
+}
 
-  // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+void CJobManager::StartWorkers()
+{
+  CSingleLock lock(m_poolSection);
+  if (m_poolSize || m_stopWorkers || !m_running)
     return;
 
-  // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  unsigned int count = GetWorkerCount();
+  for (unsigned int i = 0; i < count; ++i)
+    m_workerStates.push_back(new CWorkerState);
+  m_poolSize = count;
+
+  for (unsigned int i = 0; i < count; ++i)
+    m_workers.push_back(new CJobWorker(this, i));
+}
+
+void CJobManager::StopWorkers()
+{
+  Workers workers;
   {
-    m_jobEvent.Set();
+    CSingleLock lock(m_poolSection);
+    workers.swap(m_workers);
+    m_stopWorkers = true;
+  }
+
+  // jobs still processing are finished first
+  WakeWorkers(true);
+  for (Workers::iterator it = workers.begin(); it != workers.end(); ++it)
+    delete *it;
+
+  CSingleLock lock(m_poolSection);
+  m_poolSize = 0;
+  for (WorkerStates::iterator it = m_workerStates.begin(); it != m_workerStates.end(); ++it)
+    delete *it;
+  m_workerStates.clear();
+  m_stopWorkers = false;
+}
+
+void CJobManager::WakeWorkers(bool all)
+{
+  // a worker going to sleep counts itself in m_sleeping before it checks
+  // the queues a last time, so either it sees our change or we see it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!m_sleeping)
     return;
+
+  CSingleLock lock(m_idleSection);
+  if (all)
+    m_idleCond.notifyAll();
+  else
+    m_idleCond.notify();
+}
+
+bool CJobManager::AcquireSlot(CJob::PRIORITY priority)
+{
+  const unsigned int limit = GetMaxWorkers(priority);
+  unsigned int active = m_active;
+  do
+  {
+    if (active >= limit)
+      return false;
+  } while (!m_active.compare_exchange_weak(active, active + 1));
+  return true;
+}
+
+void CJobManager::ReleaseSlot()
+{
+  --m_active;
+}
+
+bool CJobManager::HasRunnableJobs() const
+{
+  for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
+  {
+    if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
+      continue;
+
+    if (m_queued[priority] && m_active < GetMaxWorkers(CJob::PRIORITY(priority)))
+      return true;
+  }
+  return false;
+}
+
+CJobManager::CWorkItem *CJobManager::TakeJob(unsigned int worker, CJob::PRIORITY priority)
+{
+  CWorkItem *item = NULL;
+
+  // our own jobs first, oldest first
+  {
+    CJobQueueLocked &queue = m_workerStates[worker]->m_queue[priority];
+    CSingleLock lock(queue.m_section);
+    if (!queue.m_jobs.empty())
+    {
+      item = queue.m_jobs.front();
+      queue.m_jobs.pop_front();
+    }
+  }
+
+  // then jobs from outside the pool
+  if (!item)
+  {
+    CJobQueueLocked &queue = m_jobQueue[priority];
+    CSingleLock lock(queue.m_section);
+    if (!queue.m_jobs.empty())
+    {
+      item = queue.m_jobs.front();
+      queue.m_jobs.pop_front();
+    }
+  }
+
+  // and steal the newest job of someone else
+  const unsigned int poolSize = m_poolSize;
+  for (unsigned int i = 1; !item && i < poolSize; ++i)
+  {
+    CJobQueueLocked &queue = m_workerStates[(worker + i) % poolSize]->m_queue[priority];
+    CSingleLock lock(queue.m_section);
+    if (!queue.m_jobs.empty())
+    {
+      item = queue.m_jobs.back();
+      queue.m_jobs.pop_back();
+    }
   }
 
-  // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  if (item)
+    --m_queued[priority];
+  return item;
 }
 
-CJob *CJobManager::PopJob()
+CJobManager::CWorkItem *CJobManager::PopJob(unsigned int worker)
 {
-  CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    while (m_queued[priority] && AcquireSlot(CJob::PRIORITY(priority)))
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      CWorkItem *item = TakeJob(worker, CJob::PRIORITY(priority));
+      if (!item)
+      {
+        ReleaseSlot();
+        break;
+      }
+
+      int state = CWorkItem::STATE_QUEUED;
+      if (!item->m_state.compare_exchange_strong(state, CWorkItem::STATE_RUNNING))
+      {
+        // cancelled while we took it
+        ReleaseSlot();
+        FreeItem(item);
+        continue;
+      }
+
+      CWorkerState *workerState = m_workerStates[worker];
+      CSingleLock lock(workerState->m_section);
+      workerState->m_current = item;
+      item->m_job->m_callback = this;
+      return item;
     }
   }
   return NULL;
@@ -310,26 +529,25 @@ CJob *CJobManager::PopJob()
 
 void CJobManager::PauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = false;
+  WakeWorkers(true);
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
-  CSingleLock lock(m_section);
-
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  CSingleLock lock(m_poolSection);
+  for (WorkerStates::const_iterator it = m_workerStates.begin(); it != m_workerStates.end(); ++it)
   {
-    if (priority == it->m_priority)
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current && priority == (*it)->m_current->m_priority)
       return true;
   }
   return false;
@@ -338,102 +556,140 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  CSingleLock lock(m_poolSection);
+  for (WorkerStates::const_iterator it = m_workerStates.begin(); it != m_workerStates.end(); ++it)
   {
-    if (type == std::string(it->m_job->GetType()))
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current && type == std::string((*it)->m_current->m_job->GetType()))
       jobsMatched++;
   }
   return jobsMatched;
 }
 
+void CJobManager::SetWorkerCount(unsigned int count)
+{
+  CSingleLock lock(m_poolSection);
+  m_workerCount = count;
+}
+
+unsigned int CJobManager::GetWorkerCount() const
+{
+  CSingleLock lock(m_poolSection);
+  if (m_poolSize)
+    return m_poolSize;
+  if (m_workerCount)
+    return m_workerCount;
+
+  // more workers than jobs allowed to run at once would only sleep
+  return JOB_MAX_WORKERS;
+}
+
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
-  while (m_running)
+  while (!m_stopWorkers)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
-    if (job)
-      return job;
-    // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
-      break;
+    CWorkItem *item = PopJob(worker->m_index);
+    if (item)
+      return item->m_job;
+
+    // no jobs are left - sleep until new jobs come in. everything that
+    // makes a job runnable wakes us, so there is no need to poll.
+    CSingleLock lock(m_idleSection);
+    ++m_sleeping;
+    if (!HasRunnableJobs() && !m_stopWorkers)
+      m_idleCond.wait(lock);
+    --m_sleeping;
   }
-  // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  CJob *job = PopJob();
-  if (job)
-    return job;
-  // have no jobs
-  RemoveWorker(worker);
   return NULL;
 }
 
-bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
+CJobManager::CWorkItem *CJobManager::GetCurrentItem(const CJob *job, unsigned int &jobID, IJobCallback *&callback) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // usually asked from the worker running the job
+  CJobWorker *worker = currentWorker.get();
+  if (worker && worker->m_jobManager == this)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    CWorkerState *workerState = m_workerStates[worker->m_index];
+    CSingleLock lock(workerState->m_section);
+    if (workerState->m_current && workerState->m_current->m_job == job)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      jobID = workerState->m_current->m_id;
+      callback = workerState->m_current->m_callback;
+      return workerState->m_current;
     }
   }
-  return true; // couldn't find the job, or it's been cancelled
-}
 
-void CJobManager::OnJobComplete(bool success, CJob *job)
-{
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  CSingleLock lock(m_poolSection);
+  for (WorkerStates::const_iterator it = m_workerStates.begin(); it != m_workerStates.end(); ++it)
   {
-    // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
-    lock.Leave();
-    try
-    {
-      if (item.m_callback)
-        item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
-    }
-    catch (...)
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current && (*it)->m_current->m_job == job)
     {
-      CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
+      jobID = (*it)->m_current->m_id;
+      callback = (*it)->m_current->m_callback;
+      return (*it)->m_current;
     }
-    lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
-    lock.Leave();
-    item.FreeJob();
   }
+  return NULL;
 }
 
-void CJobManager::RemoveWorker(const CJobWorker *worker)
+bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // remove our worker
-  Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
-  if (i != m_workers.end())
-    m_workers.erase(i); // workers auto-delete
+  // find the job in the processing queue, and check whether it's cancelled (no callback)
+  unsigned int jobID;
+  IJobCallback *callback;
+  if (GetCurrentItem(job, jobID, callback) && callback)
+  {
+    callback->OnJobProgress(jobID, progress, total, job);
+    return false;
+  }
+  return true; // couldn't find the job, or it's been cancelled
+}
+
+void CJobManager::OnJobComplete(bool success, CJob *job)
+{
+  CJobWorker *worker = currentWorker.get();
+  if (!worker || worker->m_jobManager != this)
+    return;
+
+  CWorkerState *workerState = m_workerStates[worker->m_index];
+  CWorkItem *item = workerState->m_current;
+  if (!item || item->m_job != job)
+    return;
+
+  // tell any listeners we're done with the job, then delete it
+  try
+  {
+    IJobCallback *callback = item->m_callback;
+    if (callback)
+      callback->OnJobComplete(item->m_id, success, item->m_job);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item->m_job->GetType());
+  }
+
+  {
+    CSingleLock lock(workerState->m_section);
+    workerState->m_current = NULL;
+  }
+  FreeItem(item);
+
+  // a lower priority job may fit in now
+  ReleaseSlot();
+  WakeWorkers(false);
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
+unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  // at most JOB_MAX_WORKERS jobs at once, leaving room for higher
+  // priority jobs with one worker per priority level
+  const unsigned int reserved = CJob::PRIORITY_HIGH - priority;
+  const unsigned int workers = std::min(JOB_MAX_WORKERS, (unsigned int)m_poolSize);
+  return workers > reserved ? workers - reserved : 1;
 }
@@ -19,9 +19,12 @@
  *
  */
 
+#include <atomic>
+#include <map>
 #include <queue>
 #include <vector>
 #include <string>
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "Job.h"
@@ -31,12 +34,14 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  CJobWorker(CJobManager *manager);
+  CJobWorker(CJobManager *manager, unsigned int index);
   virtual ~CJobWorker();
 
   void Process();
 private:
+  friend class CJobManager;
   CJobManager  *m_jobManager;
+  unsigned int  m_index;
 };
 
 /*!
@@ -170,6 +175,14 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Jobs run on a fixed pool of 5 workers which sleep while there is nothing to
+ do. At most 5 jobs run at once, one less for every priority level below
+ PRIORITY_HIGH. Jobs added from outside the pool go to one injection queue per
+ priority, jobs added by a running job go to the queue of its worker. Idle
+ workers take from their own queue, then the injection queue, then steal from
+ the other workers, highest priority first. Every queue has its own lock, so
+ workers only meet on a lock when they touch the same queue.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -177,34 +190,44 @@ class CJobManager
   class CWorkItem
   {
   public:
-    CWorkItem(CJob *job, unsigned int id, CJob::PRIORITY priority, IJobCallback *callback)
-    {
-      m_job = job;
-      m_id = id;
-      m_callback = callback;
-      m_priority = priority;
-    }
-    bool operator==(unsigned int jobID) const
+    enum STATE
     {
-      return m_id == jobID;
+      STATE_QUEUED,
+      STATE_RUNNING,
+      STATE_CANCELLED
     };
-    bool operator==(const CJob *job) const
-    {
-      return m_job == job;
-    };
-    void FreeJob()
-    {
-      delete m_job;
-      m_job = NULL;
-    };
-    void Cancel()
+
+    CWorkItem(CJob *job, unsigned int id, CJob::PRIORITY priority, IJobCallback *callback)
+      : m_job(job)
+      , m_id(id)
+      , m_callback(callback)
+      , m_priority(priority)
+      , m_state(STATE_QUEUED)
     {
-      m_callback = NULL;
-    };
+    }
     CJob         *m_job;
     unsigned int  m_id;
-    IJobCallback *m_callback;
+    std::atomic<IJobCallback*> m_callback;
     CJob::PRIORITY m_priority;
+    std::atomic<int> m_state;
+  };
+
+  typedef std::deque<CWorkItem*> JobQueue;
+
+  class CJobQueueLocked
+  {
+  public:
+    JobQueue         m_jobs;
+    CCriticalSection m_section;
+  };
+
+  class CWorkerState
+  {
+  public:
+    CWorkerState() : m_current(NULL) {}
+    CJobQueueLocked  m_queue[CJob::PRIORITY_HIGH+1]; ///< jobs added by jobs running on this worker
+    CWorkItem       *m_current;
+    CCriticalSection m_section;                      ///< guards m_current
   };
 
   template<typename F>
@@ -297,13 +320,27 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Set the number of worker threads, 0 for the default of 5.
+   A pool of fewer workers also lowers the per-priority limits accordingly.
+   Takes effect when the workers are next started, i.e. after CancelJobs() and Restart().
+   \sa GetWorkerCount()
+   */
+  void SetWorkerCount(unsigned int count);
+
+  /*!
+   \brief Number of worker threads of the running pool, or of the next one to start.
+   */
+  unsigned int GetWorkerCount() const;
+
 protected:
   friend class CJobWorker;
   friend class CJob;
 
   /*!
-   \brief Get a new job to process. Blocks until a new job is available, or a timeout has occurred.
+   \brief Get a new job to process. Blocks until a new job is available or the pool is stopped.
    \param worker a pointer to the current CJobWorker instance requesting a job.
+   \return the job to process, NULL once the worker should exit.
    \sa CJob
    */
   CJob *GetNextJob(const CJobWorker *worker);
@@ -335,27 +372,56 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
-   \return the job to process, NULL if no jobs are available
+  /*! \brief Take the next runnable job for a worker and mark it as processing
+   \return the work item to process, NULL if no jobs are available
    */
-  CJob *PopJob();
-
-  void StartWorkers(CJob::PRIORITY priority);
-  void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
-
-  unsigned int m_jobCounter;
+  CWorkItem *PopJob(unsigned int worker);
+  CWorkItem *TakeJob(unsigned int worker, CJob::PRIORITY priority);
+  bool HasRunnableJobs() const;
+
+  bool AcquireSlot(CJob::PRIORITY priority);
+  void ReleaseSlot();
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
+
+  void StartWorkers();
+  void StopWorkers();
+  void WakeWorkers(bool all);
+
+  void RegisterItem(CWorkItem *item);
+  void FreeItem(CWorkItem *item);
+  bool RemoveQueued(CJobQueueLocked &queue, CJob::PRIORITY priority, unsigned int jobID);
+  CWorkItem *GetCurrentItem(const CJob *job, unsigned int &jobID, IJobCallback *&callback) const;
+
+  std::atomic<unsigned int> m_jobCounter;
+  std::atomic<bool> m_pauseJobs;
+  std::atomic<bool> m_running;
+
+  // injection queues for jobs added from outside the pool
+  CJobQueueLocked m_jobQueue[CJob::PRIORITY_HIGH+1];
+  std::atomic<unsigned int> m_queued[CJob::PRIORITY_HIGH+1];
+  std::atomic<unsigned int> m_active;
+
+  // queued and processing jobs by id, spread over a few locks
+  static const unsigned int REGISTRY_SHARDS = 16;
+  class CRegistryShard
+  {
+  public:
+    std::map<unsigned int, CWorkItem*> m_items;
+    CCriticalSection m_section;
+  };
+  mutable CRegistryShard m_registry[REGISTRY_SHARDS];
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
   typedef std::vector<CJobWorker*> Workers;
-
-  JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
-  bool       m_pauseJobs;
-  Processing m_processing;
-  Workers    m_workers;
-
-  CCriticalSection m_section;
-  CEvent           m_jobEvent;
-  bool             m_running;
+  typedef std::vector<CWorkerState*> WorkerStates;
+
+  CCriticalSection m_poolSection; ///< guards starting and stopping the pool
+  Workers          m_workers;
+  WorkerStates     m_workerStates;
+  unsigned int     m_workerCount;
+  std::atomic<unsigned int> m_poolSize;
+  std::atomic<bool> m_stopWorkers;
+
+  CCriticalSection m_idleSection;
+  XbmcThreads::ConditionVariable m_idleCond;
+  std::atomic<unsigned int> m_sleeping;
 };
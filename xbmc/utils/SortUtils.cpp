@@ -24,6 +24,7 @@
 #include "Util.h"
 #include "XBDateTime.h"
 #include "utils/CharsetConverter.h"
+#include "utils/CollationKey.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
@@ -691,32 +692,23 @@ std::map<SortBy, Fields> SortUtils::m_sortingFields = fillSortingFields();
 
 void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, DatabaseResults& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
 {
-  if (sortBy != SortByNone)
+  if (sortBy != SortByNone && getPreparator(sortBy) != NULL)
   {
-    // get the matching SortPreparator
-    SortPreparator preparator = getPreparator(sortBy);
-    if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
+    CSortKeys keys(sortBy, attributes, items.size());
+    for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
+      keys.Add(*item);
 
-      // Prepare the string used for sorting and store it under FieldSort
-      for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
+    std::vector<size_t> order;
+    keys.Sort(sortOrder, order, limitEnd, limitStart);
 
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
+    // move the items into their new order, dropping the ones outside the limits
+    DatabaseResults sortedItems;
+    sortedItems.reserve(order.size());
+    for (std::vector<size_t>::const_iterator index = order.begin(); index != order.end(); ++index)
+      sortedItems.push_back(std::move(items[*index]));
 
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
-    }
+    items = std::move(sortedItems);
+    return;
   }
 
   if (limitStart > 0 && (size_t)limitStart < items.size())
@@ -832,6 +824,156 @@ const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
   return m_sortingFields[SortByNone];
 }
 
+// largest value AlphaNumericCompare() still compares as a whole number
+#define SORT_MAX_NUMERIC_KEY 1000000000000000LL
+
+CSortKeys::CSortKeys(SortBy sortBy, SortAttribute attributes, size_t size /* = 0 */)
+  : m_attributes(attributes),
+    m_preparator(SortUtils::getPreparator(sortBy)),
+    m_fields(SortUtils::GetFieldsForSorting(sortBy)),
+    m_numberField(FieldNone),
+    m_numberAsInt(false),
+    m_numeric(false)
+{
+  // sort methods whose label is nothing but a single integer can compare that
+  // integer directly as long as it sorts the same as its label would
+  switch (sortBy)
+  {
+  case SortBySize:
+    m_numberField = FieldSize;
+    break;
+  case SortByBitrate:
+    m_numberField = FieldBitrate;
+    break;
+  case SortByListeners:
+    m_numberField = FieldListeners;
+    break;
+  case SortByTrackNumber:
+    m_numberField = FieldTrackNumber;
+    m_numberAsInt = true;
+    break;
+  case SortByProgramCount:
+  case SortByPlaylistOrder:
+    m_numberField = FieldProgramCount;
+    m_numberAsInt = true;
+    break;
+  case SortByChannelNumber:
+    m_numberField = FieldChannelNumber;
+    m_numberAsInt = true;
+    break;
+  case SortByRelevance:
+    m_numberField = FieldRelevance;
+    m_numberAsInt = true;
+    break;
+  default:
+    break;
+  }
+  m_numeric = m_numberField != FieldNone;
+
+  m_specials.reserve(size);
+  m_folders.reserve(size);
+  m_labels.reserve(size);
+  if (m_numeric)
+    m_numbers.reserve(size);
+}
+
+void CSortKeys::Add(SortItem &values)
+{
+  // add all fields to the item that are required for sorting if they are currently missing
+  for (Fields::const_iterator field = m_fields.begin(); field != m_fields.end(); ++field)
+  {
+    if (values.find(*field) == values.end())
+      values.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+  }
+
+  SortItem::const_iterator it = values.find(FieldSortSpecial);
+  if (it != values.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+    m_specials.push_back((SortSpecial)it->second.asInteger());
+  else
+    m_specials.push_back(SortSpecialNone);
+
+  it = values.find(FieldFolder);
+  if (it != values.end())
+    m_folders.push_back(it->second.asBoolean() ? 1 : 0);
+  else
+    m_folders.push_back(-1);
+
+  m_labels.push_back(std::wstring());
+  if (m_preparator != NULL)
+    g_charsetConverter.utf8ToW(m_preparator(m_attributes, values), m_labels.back(), false);
+
+  if (m_numeric)
+  {
+    int64_t number = values.at(m_numberField).asInteger();
+    if (m_numberAsInt)
+      number = (int)number;
+
+    // negative or very large numbers don't compare like their labels
+    if (number < 0 || number >= SORT_MAX_NUMERIC_KEY)
+    {
+      m_numeric = false;
+      m_numbers.clear();
+    }
+    else
+      m_numbers.push_back(number);
+  }
+}
+
+void CSortKeys::Sort(SortOrder sortOrder, std::vector<size_t> &order, int limitEnd /* = -1 */, int limitStart /* = 0 */) const
+{
+  order.resize(m_labels.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  if (m_preparator != NULL)
+  {
+    // compare the labels through their collation keys unless the integer column is used
+    std::vector<std::string> keys;
+    if (!m_numeric)
+      CCollationKeyGenerator().GetKeys(m_labels, keys);
+
+    bool handleFolders = !(m_attributes & SortAttributeIgnoreFolders);
+    bool descending = sortOrder == SortOrderDescending;
+    std::stable_sort(order.begin(), order.end(), [this, &keys, handleFolders, descending](size_t left, size_t right)
+    {
+      return Less(keys, left, right, handleFolders, descending);
+    });
+  }
+
+  if (limitStart > 0 && (size_t)limitStart < order.size())
+  {
+    order.erase(order.begin(), order.begin() + limitStart);
+    limitEnd -= limitStart;
+  }
+  if (limitEnd > 0 && (size_t)limitEnd < order.size())
+    order.erase(order.begin() + limitEnd, order.end());
+}
+
+bool CSortKeys::Less(const std::vector<std::string> &keys, size_t left, size_t right, bool handleFolders, bool descending) const
+{
+  // one has a special sort: items sorted on top come first and items sorted
+  // on bottom come last, regardless of the sort order
+  SortSpecial leftSortSpecial = m_specials[left];
+  SortSpecial rightSortSpecial = m_specials[right];
+  if (leftSortSpecial != rightSortSpecial)
+    return leftSortSpecial == SortSpecialOnTop || rightSortSpecial == SortSpecialOnBottom;
+  // both have either sort on top or sort on bottom -> leave as-is
+  if (leftSortSpecial != SortSpecialNone)
+    return false;
+
+  if (handleFolders && m_folders[left] >= 0 && m_folders[right] >= 0 &&
+      m_folders[left] != m_folders[right])
+    return m_folders[left] > 0;
+
+  int64_t result;
+  if (m_numeric)
+    result = m_numbers[left] - m_numbers[right];
+  else
+    result = keys[left].compare(keys[right]);
+
+  return descending ? result > 0 : result < 0;
+}
+
 std::string SortUtils::RemoveArticles(const std::string &label)
 {
   std::set<std::string> sortTokens = g_langInfo.GetSortTokens();
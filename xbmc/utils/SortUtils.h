@@ -226,4 +226,55 @@ private:
 
   static std::map<SortBy, SortPreparator> m_preparators;
   static std::map<SortBy, Fields> m_sortingFields;
+
+  friend class CSortKeys;
+};
+
+/*!
+ \brief Sort keys of a list of items, stored column by column.
+
+ The keys of every item are computed once when it is added. Sorting then only
+ compares the columns and returns the new order as a permutation of the item
+ indices, so the items themselves don't have to be kept around or moved while
+ sorting. Labels are compared through their collation keys (see
+ CCollationKeyGenerator), sort methods that compare a single integer field use an
+ integer column instead.
+ */
+class CSortKeys
+{
+public:
+  CSortKeys(SortBy sortBy, SortAttribute attributes, size_t size = 0);
+
+  /*! \brief Compute the keys of the next item.
+   \param values the sort values of the item. Fields needed for sorting that are
+   missing are added as null values.
+   */
+  void Add(SortItem &values);
+
+  /*! \brief Sort the added items.
+   \param sortOrder the order to sort in.
+   \param order receives the indices of the items in sorted order, limited to the given range.
+   \param limitEnd index after the last item to return, -1 for all items.
+   \param limitStart index of the first item to return.
+   */
+  void Sort(SortOrder sortOrder, std::vector<size_t> &order, int limitEnd = -1, int limitStart = 0) const;
+
+  /*! \brief The label the item at the given index was sorted by. */
+  const std::wstring& GetLabel(size_t index) const { return m_labels[index]; }
+  size_t Size() const { return m_labels.size(); }
+
+private:
+  bool Less(const std::vector<std::string> &keys, size_t left, size_t right, bool handleFolders, bool descending) const;
+
+  SortAttribute m_attributes;
+  SortUtils::SortPreparator m_preparator;
+  const Fields &m_fields;
+  Field m_numberField;    ///< field holding the integer key, FieldNone if the label is used
+  bool m_numberAsInt;     ///< the label of the integer key is formatted as int
+  bool m_numeric;         ///< all added items have an integer key that sorts like its label
+
+  std::vector<SortSpecial> m_specials;
+  std::vector<signed char> m_folders;  ///< -1 if unknown
+  std::vector<int64_t> m_numbers;
+  std::vector<std::wstring> m_labels;
 };
@@ -20,6 +20,8 @@
 
 #include "Variant.h"
 
+#include <algorithm>
+#include <new>
 #include <stdlib.h>
 #include <string.h>
 #include <sstream>
@@ -131,6 +133,13 @@ double str2double(const std::wstring &str, double fallback /* = 0.0 */)
 
 CVariant CVariant::ConstNullVariant = CVariant::VariantTypeConstNull;
 
+template<typename Iterator>
+static Iterator FindMember(Iterator begin, Iterator end, const std::string &key)
+{
+  return std::lower_bound(begin, end, key,
+    [](const std::pair<std::string, CVariant> &member, const std::string &key) { return member.first < key; });
+}
+
 CVariant::CVariant(VariantType type)
 {
   m_type = type;
@@ -150,10 +159,10 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new std::string();
+      new (&m_data.string) std::string();
       break;
     case VariantTypeWideString:
-      m_data.wstring = new std::wstring();
+      new (&m_data.wstring) std::wstring();
       break;
     case VariantTypeArray:
       m_data.array = new VariantArray();
@@ -162,7 +171,7 @@ CVariant::CVariant(VariantType type)
       m_data.map = new VariantMap();
       break;
     default:
-      memset(&m_data, 0, sizeof(m_data));
+      m_data.unsignedinteger = 0;
       break;
   }
 }
@@ -212,49 +221,49 @@ CVariant::CVariant(bool boolean)
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  new (&m_data.string) std::string(str);
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str, length);
+  new (&m_data.string) std::string(str, length);
 }
 
 CVariant::CVariant(const std::string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  new (&m_data.string) std::string(str);
 }
 
 CVariant::CVariant(std::string &&str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(std::move(str));
+  new (&m_data.string) std::string(std::move(str));
 }
 
 CVariant::CVariant(const wchar_t *str)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(str);
+  new (&m_data.wstring) std::wstring(str);
 }
 
 CVariant::CVariant(const wchar_t *str, unsigned int length)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(str, length);
+  new (&m_data.wstring) std::wstring(str, length);
 }
 
 CVariant::CVariant(const std::wstring &str)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(str);
+  new (&m_data.wstring) std::wstring(str);
 }
 
 CVariant::CVariant(std::wstring &&str)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(std::move(str));
+  new (&m_data.wstring) std::wstring(std::move(str));
 }
 
 CVariant::CVariant(const std::vector<std::string> &strArray)
@@ -270,8 +279,9 @@ CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 {
   m_type = VariantTypeObject;
   m_data.map = new VariantMap;
+  m_data.map->reserve(strMap.size());
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); ++it)
-    m_data.map->insert(make_pair(it->first, CVariant(it->second)));
+    m_data.map->push_back(std::make_pair(it->first, CVariant(it->second)));
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
@@ -286,13 +296,10 @@ CVariant::CVariant(const CVariant &variant)
   *this = variant;
 }
 
-CVariant::CVariant(CVariant&& rhs)
+CVariant::CVariant(CVariant&& rhs) noexcept
 {
-  //Set this so that operator= don't try and run cleanup
-  //when we're not initialized.
   m_type = VariantTypeNull;
-
-  *this = std::move(rhs);
+  moveFrom(rhs);
 }
 
 CVariant::~CVariant()
@@ -303,9 +310,9 @@ CVariant::~CVariant()
 void CVariant::cleanup()
 {
   if (m_type == VariantTypeString)
-    delete m_data.string;
+    m_data.string.~basic_string();
   else if (m_type == VariantTypeWideString)
-    delete m_data.wstring;
+    m_data.wstring.~basic_string();
   else if (m_type == VariantTypeArray)
     delete m_data.array;
   else if (m_type == VariantTypeObject)
@@ -313,6 +320,44 @@ void CVariant::cleanup()
   m_type = VariantTypeNull;
 }
 
+void CVariant::moveFrom(CVariant &rhs)
+{
+  // expects this variant to hold nothing that needs cleaning up
+  m_type = rhs.m_type;
+
+  switch (m_type)
+  {
+  case VariantTypeString:
+    new (&m_data.string) std::string(std::move(rhs.m_data.string));
+    break;
+  case VariantTypeWideString:
+    new (&m_data.wstring) std::wstring(std::move(rhs.m_data.wstring));
+    break;
+  case VariantTypeArray:
+    m_data.array = rhs.m_data.array;
+    rhs.m_type = VariantTypeNull;
+    break;
+  case VariantTypeObject:
+    m_data.map = rhs.m_data.map;
+    rhs.m_type = VariantTypeNull;
+    break;
+  case VariantTypeBoolean:
+    m_data.boolean = rhs.m_data.boolean;
+    break;
+  case VariantTypeDouble:
+    m_data.dvalue = rhs.m_data.dvalue;
+    break;
+  case VariantTypeInteger:
+  case VariantTypeUnsignedInteger:
+    m_data.unsignedinteger = rhs.m_data.unsignedinteger;
+    break;
+  default:
+    break;
+  }
+
+  rhs.cleanup();
+}
+
 bool CVariant::isInteger() const
 {
   return m_type == VariantTypeInteger;
@@ -374,9 +419,9 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(m_data.string, fallback);
     case VariantTypeWideString:
-      return str2int64(*m_data.wstring, fallback);
+      return str2int64(m_data.wstring, fallback);
     default:
       return fallback;
   }
@@ -395,9 +440,9 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(m_data.string, fallback);
     case VariantTypeWideString:
-      return str2uint64(*m_data.wstring, fallback);
+      return str2uint64(m_data.wstring, fallback);
     default:
       return fallback;
   }
@@ -416,9 +461,9 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(m_data.string, fallback);
     case VariantTypeWideString:
-      return str2double(*m_data.wstring, fallback);
+      return str2double(m_data.wstring, fallback);
     default:
       return fallback;
   }
@@ -437,9 +482,9 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(m_data.string, fallback);
     case VariantTypeWideString:
-      return (float)str2double(*m_data.wstring, fallback);
+      return (float)str2double(m_data.wstring, fallback);
     default:
       return fallback;
   }
@@ -460,11 +505,11 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+      if (m_data.string.empty() || m_data.string.compare("0") == 0 || m_data.string.compare("false") == 0)
         return false;
       return true;
     case VariantTypeWideString:
-      if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
+      if (m_data.wstring.empty() || m_data.wstring.compare(L"0") == 0 || m_data.wstring.compare(L"false") == 0)
         return false;
       return true;
     default:
@@ -479,7 +524,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return m_data.string;
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -507,7 +552,7 @@ std::wstring CVariant::asWideString(const std::wstring &fallback /* = L"" */) co
   switch (m_type)
   {
     case VariantTypeWideString:
-      return *m_data.wstring;
+      return m_data.wstring;
     case VariantTypeBoolean:
       return m_data.boolean ? L"true" : L"false";
     case VariantTypeInteger:
@@ -538,19 +583,42 @@ CVariant &CVariant::operator[](const std::string &key)
     m_data.map = new VariantMap;
   }
 
-  if (m_type == VariantTypeObject)
-    return (*m_data.map)[key];
-  else
+  if (m_type != VariantTypeObject)
     return ConstNullVariant;
+
+  VariantMap &map = *m_data.map;
+
+  // members are mostly added in order (e.g. by the JSON parser)
+  if (map.empty() || map.back().first < key)
+  {
+    map.push_back(std::make_pair(key, CVariant()));
+    return map.back().second;
+  }
+
+  VariantMap::iterator it = FindMember(map.begin(), map.end(), key);
+  if (it != map.end() && it->first == key)
+    return it->second;
+
+  // insert at the end and swap into place, assignment must not be used to
+  // shift members as it is a no-op on copies of ConstNullVariant
+  size_t position = it - map.begin();
+  map.push_back(std::make_pair(key, CVariant()));
+  for (size_t i = map.size() - 1; i > position; i--)
+    map[i].swap(map[i - 1]);
+
+  return map[position].second;
 }
 
 const CVariant &CVariant::operator[](const std::string &key) const
 {
-  VariantMap::const_iterator it;
-  if (m_type == VariantTypeObject && (it = m_data.map->find(key)) != m_data.map->end())
-    return it->second;
-  else
-    return ConstNullVariant;
+  if (m_type == VariantTypeObject)
+  {
+    VariantMap::const_iterator it = FindMember(m_data.map->begin(), m_data.map->end(), key);
+    if (it != m_data.map->end() && it->first == key)
+      return it->second;
+  }
+
+  return ConstNullVariant;
 }
 
 CVariant &CVariant::operator[](unsigned int position)
@@ -574,6 +642,13 @@ CVariant &CVariant::operator=(const CVariant &rhs)
   if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
 
+  // reuse the existing buffer when assigning a string to a string
+  if (m_type == VariantTypeString && rhs.m_type == VariantTypeString)
+  {
+    m_data.string = rhs.m_data.string;
+    return *this;
+  }
+
   cleanup();
 
   m_type = rhs.m_type;
@@ -593,16 +668,16 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new std::string(*rhs.m_data.string);
+    new (&m_data.string) std::string(rhs.m_data.string);
     break;
   case VariantTypeWideString:
-    m_data.wstring = new std::wstring(*rhs.m_data.wstring);
+    new (&m_data.wstring) std::wstring(rhs.m_data.wstring);
     break;
   case VariantTypeArray:
-    m_data.array = new VariantArray(rhs.m_data.array->begin(), rhs.m_data.array->end());
+    m_data.array = new VariantArray(*rhs.m_data.array);
     break;
   case VariantTypeObject:
-    m_data.map = new VariantMap(rhs.m_data.map->begin(), rhs.m_data.map->end());
+    m_data.map = new VariantMap(*rhs.m_data.map);
     break;
   default:
     break;
@@ -611,7 +686,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
   return *this;
 }
 
-CVariant& CVariant::operator=(CVariant&& rhs)
+CVariant& CVariant::operator=(CVariant&& rhs) noexcept
 {
   if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
@@ -620,21 +695,7 @@ CVariant& CVariant::operator=(CVariant&& rhs)
   if (m_type != VariantTypeNull)
     cleanup();
 
-  m_type = rhs.m_type;
-  m_data = std::move(rhs.m_data);
-
-  //Should be enough to just set m_type here
-  //but better safe than sorry, could probably lead to coverity warnings
-  if (rhs.m_type == VariantTypeString)
-    rhs.m_data.string = nullptr;
-  else if (rhs.m_type == VariantTypeWideString)
-    rhs.m_data.wstring = nullptr;
-  else if (rhs.m_type == VariantTypeArray)
-    rhs.m_data.array = nullptr;
-  else if (rhs.m_type == VariantTypeObject)
-    rhs.m_data.map = nullptr;
-
-  rhs.m_type = VariantTypeNull;
+  moveFrom(rhs);
 
   return *this;
 }
@@ -654,9 +715,9 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return m_data.string == rhs.m_data.string;
     case VariantTypeWideString:
-      return *m_data.wstring == *rhs.m_data.wstring;
+      return m_data.wstring == rhs.m_data.wstring;
     case VariantTypeArray:
       return *m_data.array == *rhs.m_data.array;
     case VariantTypeObject:
@@ -706,21 +767,20 @@ void CVariant::append(CVariant&& variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return m_data.string.c_str();
   else
     return NULL;
 }
 
 void CVariant::swap(CVariant &rhs)
 {
-  VariantType  temp_type = m_type;
-  VariantUnion temp_data = m_data;
+  if (this == &rhs)
+    return;
 
-  m_type = rhs.m_type;
-  m_data = rhs.m_data;
-
-  rhs.m_type = temp_type;
-  rhs.m_data = temp_data;
+  CVariant temp;
+  temp.moveFrom(rhs);
+  rhs.moveFrom(*this);
+  moveFrom(temp);
 }
 
 CVariant::iterator_array CVariant::begin_array()
@@ -794,9 +854,9 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return m_data.string.size();
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->size();
+    return m_data.wstring.size();
   else
     return 0;
 }
@@ -808,9 +868,9 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return m_data.string.empty();
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->empty();
+    return m_data.wstring.empty();
   else if (m_type == VariantTypeNull)
     return true;
 
@@ -824,9 +884,9 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+    m_data.string.clear();
   else if (m_type == VariantTypeWideString)
-    m_data.wstring->clear();
+    m_data.wstring.clear();
 }
 
 void CVariant::erase(const std::string &key)
@@ -837,7 +897,17 @@ void CVariant::erase(const std::string &key)
     m_data.map = new VariantMap;
   }
   else if (m_type == VariantTypeObject)
-    m_data.map->erase(key);
+  {
+    VariantMap &map = *m_data.map;
+    VariantMap::iterator it = FindMember(map.begin(), map.end(), key);
+    if (it == map.end() || it->first != key)
+      return;
+
+    // swap the member to the end instead of shifting the others by assignment
+    for (size_t i = it - map.begin(); i + 1 < map.size(); i++)
+      map[i].swap(map[i + 1]);
+    map.pop_back();
+  }
 }
 
 void CVariant::erase(unsigned int position)
@@ -849,13 +919,21 @@ void CVariant::erase(unsigned int position)
   }
 
   if (m_type == VariantTypeArray && position < size())
-    m_data.array->erase(m_data.array->begin() + position);
+  {
+    VariantArray &array = *m_data.array;
+    for (size_t i = position; i + 1 < array.size(); i++)
+      array[i].swap(array[i + 1]);
+    array.pop_back();
+  }
 }
 
 bool CVariant::isMember(const std::string &key) const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->find(key) != m_data.map->end();
+  {
+    VariantMap::const_iterator it = FindMember(m_data.map->begin(), m_data.map->end(), key);
+    return it != m_data.map->end() && it->first == key;
+  }
 
   return false;
 }
@@ -21,6 +21,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <utility>
 #include <stdint.h>
 #include <wchar.h>
 
@@ -68,7 +69,7 @@ public:
   CVariant(const std::map<std::string, std::string> &strMap);
   CVariant(const std::map<std::string, CVariant> &variantMap);
   CVariant(const CVariant &variant);
-  CVariant(CVariant &&rhs);
+  CVariant(CVariant &&rhs) noexcept;
   ~CVariant();
 
 
@@ -99,7 +100,7 @@ public:
   const CVariant &operator[](unsigned int position) const;
 
   CVariant &operator=(const CVariant &rhs);
-  CVariant &operator=(CVariant &&rhs);
+  CVariant &operator=(CVariant &&rhs) noexcept;
   bool operator==(const CVariant &rhs) const;
   bool operator!=(const CVariant &rhs) const { return !(*this == rhs); }
 
@@ -114,7 +115,13 @@ public:
 
 private:
   typedef std::vector<CVariant> VariantArray;
-  typedef std::map<std::string, CVariant> VariantMap;
+  /*!
+   Objects are kept as a vector of key/value pairs sorted by key. Iteration
+   order is the same as with a std::map but a member doesn't cost a tree node
+   allocation. Note that adding or removing members invalidates references to
+   the other members of the same object.
+   */
+  typedef std::vector<std::pair<std::string, CVariant> > VariantMap;
 
 public:
   typedef VariantArray::iterator        iterator_array;
@@ -145,14 +152,20 @@ public:
 
 private:
   void cleanup();
+  void moveFrom(CVariant &rhs);
+
   union VariantUnion
   {
+    VariantUnion() { }
+    ~VariantUnion() { }
+
     int64_t integer;
     uint64_t unsignedinteger;
     bool boolean;
     double dvalue;
-    std::string *string;
-    std::wstring *wstring;
+    // strings live inside the variant so short ones fit the string's own buffer
+    std::string string;
+    std::wstring wstring;
     VariantArray *array;
     VariantMap *map;
   };
@@ -160,3 +173,8 @@ private:
   VariantType m_type;
   VariantUnion m_data;
 };
+
+inline void swap(CVariant &lhs, CVariant &rhs)
+{
+  lhs.swap(rhs);
+}
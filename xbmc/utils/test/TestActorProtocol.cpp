@@ -0,0 +1,248 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/ActorProtocol.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Actor;
+
+namespace
+{
+struct TestPayload
+{
+  int producer;
+  int sequence;
+};
+
+struct LargePayload
+{
+  uint8_t bytes[100];
+};
+
+class TestActorProtocol : public testing::Test
+{
+protected:
+  TestActorProtocol() : m_port("TestPort", &m_inEvent, &m_outEvent) {}
+
+  CEvent m_inEvent;
+  CEvent m_outEvent;
+  Protocol m_port;
+};
+
+// replies to every sync message with the doubled int payload
+class CReplier : public IRunnable
+{
+public:
+  CReplier(Protocol &port, CEvent &event, int count) : m_port(port), m_event(event), m_count(count) {}
+  virtual void Run()
+  {
+    Message *msg;
+    while (m_count > 0)
+    {
+      if (!m_port.ReceiveOutMessage(&msg))
+      {
+        m_event.WaitMSec(100);
+        continue;
+      }
+      int value = *(int*)msg->data * 2;
+      msg->Reply(msg->signal, &value, sizeof(value));
+      msg->Release();
+      m_count--;
+    }
+  }
+private:
+  Protocol &m_port;
+  CEvent &m_event;
+  int m_count;
+};
+
+class CProducer : public IRunnable
+{
+public:
+  CProducer(Protocol &port, int id, int count) : m_port(port), m_id(id), m_count(count) {}
+  virtual void Run()
+  {
+    TestPayload payload;
+    payload.producer = m_id;
+    for (int i = 0; i < m_count; i++)
+    {
+      payload.sequence = i;
+      m_port.SendOutMessage(0, &payload, sizeof(payload));
+    }
+  }
+private:
+  Protocol &m_port;
+  int m_id;
+  int m_count;
+};
+}
+
+TEST_F(TestActorProtocol, SendReceive)
+{
+  for (int i = 0; i < 100; i++)
+    m_port.SendOutMessage(i, &i, sizeof(i));
+  EXPECT_TRUE(m_outEvent.WaitMSec(0));
+
+  Message *msg;
+  for (int i = 0; i < 100; i++)
+  {
+    ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(i, msg->signal);
+    EXPECT_TRUE(msg->isOut);
+    EXPECT_EQ((int)sizeof(int), msg->payloadSize);
+    EXPECT_EQ(i, *(int*)msg->data);
+    msg->Release();
+  }
+  EXPECT_FALSE(m_port.ReceiveOutMessage(&msg));
+  EXPECT_FALSE(m_port.ReceiveInMessage(&msg));
+
+  m_port.SendInMessage(7);
+  ASSERT_TRUE(m_port.ReceiveInMessage(&msg));
+  EXPECT_EQ(7, msg->signal);
+  EXPECT_FALSE(msg->isOut);
+  EXPECT_EQ(NULL, msg->data);
+  msg->Release();
+}
+
+TEST_F(TestActorProtocol, LargePayload)
+{
+  LargePayload payload;
+  Message *msg;
+  for (int n = 0; n < 3; n++)
+  {
+    for (unsigned int i = 0; i < sizeof(payload.bytes); i++)
+      payload.bytes[i] = i + n;
+    m_port.SendOutMessage(1, &payload, sizeof(payload));
+    ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+    EXPECT_EQ((int)sizeof(payload), msg->payloadSize);
+    EXPECT_EQ(0, memcmp(&payload, msg->data, sizeof(payload)));
+    msg->Release();
+  }
+}
+
+TEST_F(TestActorProtocol, Purge)
+{
+  const int signals[] = { 1, 2, 1, 3, 1 };
+  for (int signal : signals)
+    m_port.SendOutMessage(signal);
+  m_port.PurgeOut(1);
+  m_port.SendOutMessage(4);
+
+  Message *msg;
+  for (int signal : { 2, 3, 4 })
+  {
+    ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(signal, msg->signal);
+    msg->Release();
+  }
+  EXPECT_FALSE(m_port.ReceiveOutMessage(&msg));
+
+  m_port.SendInMessage(1);
+  m_port.SendOutMessage(1);
+  m_port.Purge();
+  EXPECT_FALSE(m_port.ReceiveInMessage(&msg));
+  EXPECT_FALSE(m_port.ReceiveOutMessage(&msg));
+}
+
+TEST_F(TestActorProtocol, Defer)
+{
+  m_port.SendOutMessage(1);
+  m_port.DeferOut(true);
+  Message *msg;
+  EXPECT_FALSE(m_port.ReceiveOutMessage(&msg));
+  m_port.DeferOut(false);
+  ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+  msg->Release();
+}
+
+TEST_F(TestActorProtocol, SyncMessage)
+{
+  const int count = 50;
+  CReplier replier(m_port, m_outEvent, count);
+  CThread thread(&replier, "TestReplier");
+  thread.Create();
+
+  for (int i = 0; i < count; i++)
+  {
+    Message *reply;
+    ASSERT_TRUE(m_port.SendOutMessageSync(i, &reply, 2000, &i, sizeof(i)));
+    EXPECT_EQ(i, reply->signal);
+    EXPECT_EQ(i * 2, *(int*)reply->data);
+    reply->Release();
+  }
+  thread.StopThread(true);
+}
+
+TEST_F(TestActorProtocol, SyncMessageTimeout)
+{
+  Message *reply;
+  int value = 1;
+  EXPECT_FALSE(m_port.SendOutMessageSync(1, &reply, 10, &value, sizeof(value)));
+
+  // a late reply must not reach the sender
+  Message *msg;
+  ASSERT_TRUE(m_port.ReceiveOutMessage(&msg));
+  msg->Reply(2);
+  msg->Release();
+  EXPECT_FALSE(m_port.ReceiveInMessage(&msg));
+}
+
+TEST_F(TestActorProtocol, MultipleProducers)
+{
+  const int producers = 4;
+  const int count = 10000;
+  std::vector<CProducer*> runnables;
+  std::vector<CThread*> threads;
+  for (int i = 0; i < producers; i++)
+  {
+    runnables.push_back(new CProducer(m_port, i, count));
+    threads.push_back(new CThread(runnables.back(), "TestProducer"));
+    threads.back()->Create();
+  }
+
+  // messages of a single producer have to arrive in order
+  std::vector<int> expected(producers, 0);
+  int received = 0;
+  Message *msg;
+  while (received < producers * count)
+  {
+    if (!m_port.ReceiveOutMessage(&msg))
+    {
+      m_outEvent.WaitMSec(100);
+      continue;
+    }
+    TestPayload *payload = (TestPayload*)msg->data;
+    ASSERT_EQ(expected[payload->producer], payload->sequence);
+    expected[payload->producer]++;
+    received++;
+    msg->Release();
+  }
+
+  for (int i = 0; i < producers; i++)
+  {
+    threads[i]->StopThread(true);
+    delete threads[i];
+    delete runnables[i];
+  }
+}
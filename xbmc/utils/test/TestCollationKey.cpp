@@ -0,0 +1,101 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/CollationKey.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+
+namespace
+{
+int Sign(int64_t value)
+{
+  return value < 0 ? -1 : (value > 0 ? 1 : 0);
+}
+
+void ExpectSameOrder(const std::vector<std::wstring> &labels)
+{
+  std::vector<std::string> keys;
+  CCollationKeyGenerator().GetKeys(labels, keys);
+  ASSERT_EQ(labels.size(), keys.size());
+
+  for (size_t i = 0; i < labels.size(); i++)
+  {
+    for (size_t j = 0; j < labels.size(); j++)
+    {
+      EXPECT_EQ(Sign(StringUtils::AlphaNumericCompare(labels[i].c_str(), labels[j].c_str())),
+                Sign(keys[i].compare(keys[j])))
+        << "labels " << i << " and " << j;
+    }
+  }
+}
+}
+
+TEST(TestCollationKey, Numbers)
+{
+  std::vector<std::string> keys;
+  std::vector<std::wstring> labels = { L"Track 10", L"Track 9", L"Track 009", L"Track 9b", L"Track" };
+  CCollationKeyGenerator().GetKeys(labels, keys);
+
+  EXPECT_LT(keys[1], keys[0]);
+  EXPECT_EQ(keys[1], keys[2]);
+  EXPECT_LT(keys[1], keys[3]);
+  EXPECT_LT(keys[4], keys[1]);
+}
+
+TEST(TestCollationKey, IgnoresCase)
+{
+  std::vector<std::string> keys;
+  std::vector<std::wstring> labels = { L"abba", L"ABBA", L"Abc" };
+  CCollationKeyGenerator().GetKeys(labels, keys);
+
+  EXPECT_EQ(keys[0], keys[1]);
+  EXPECT_LT(keys[1], keys[2]);
+}
+
+TEST(TestCollationKey, MatchesAlphaNumericCompare)
+{
+  std::vector<std::wstring> labels = {
+    L"", L"a", L"A", L"a1", L"a01", L"a2", L"a10", L"a 10", L"a-10", L"a.10", L"10a", L"9 lives",
+    L"123456789012345678", L"123456789012345", L"1234567890123456", L"b", L"B side", L"été",
+    L"ete", L"Été", L"zürich", L"zurich", L"(live)", L"[live]", L"_", L"~"
+  };
+  ExpectSameOrder(labels);
+}
+
+TEST(TestCollationKey, MatchesAlphaNumericCompareRandom)
+{
+  const wchar_t alphabet[] = L"aAbBzZ019 -._(éÉü中";
+  const size_t alphabetSize = sizeof(alphabet) / sizeof(alphabet[0]) - 1;
+
+  srand(42);
+  std::vector<std::wstring> labels;
+  for (int i = 0; i < 200; i++)
+  {
+    std::wstring label;
+    int length = rand() % 8;
+    for (int c = 0; c < length; c++)
+      label += alphabet[rand() % alphabetSize];
+    labels.push_back(label);
+  }
+  ExpectSameOrder(labels);
+}
@@ -19,10 +19,72 @@
  */
 
 #include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+#include <clocale>
+
+static CVariant CreateItem(int index)
+{
+  CVariant item;
+  item["movieid"] = index;
+  item["label"] = StringUtils::Format("Movie %d", index);
+  item["rating"] = 6.5;
+  item["playcount"] = index % 3;
+  item["file"] = StringUtils::Format("/media/movies/Movie %d (2016).mkv", index);
+  item["genre"].append("Drama");
+  item["genre"].append("Thriller");
+  item["art"]["poster"] = StringUtils::Format("image://%%2fmedia%%2fmovies%%2fposter%d.jpg/", index);
+  return item;
+}
+
+static std::string WriteTree(int count, bool compact)
+{
+  CVariant response;
+  response["id"] = 1;
+  response["jsonrpc"] = "2.0";
+  response["result"]["limits"]["total"] = count;
+  for (int i = 0; i < count; i++)
+    response["result"]["movies"].append(CreateItem(i));
+
+  return CJSONVariantWriter::Write(response, compact);
+}
+
+static std::string WriteStreamed(int count, bool compact)
+{
+  std::string output;
+  CJSONVariantWriter writer(compact);
+
+  CVariant limits;
+  limits["total"] = count;
+
+  writer.BeginObject();
+  writer.Key("id");
+  writer.Value(1);
+  writer.Key("jsonrpc");
+  writer.Value("2.0");
+  writer.Key("result");
+  writer.BeginObject();
+  writer.Key("limits");
+  writer.Value(limits);
+  writer.Key("movies");
+  writer.BeginArray();
+  for (int i = 0; i < count; i++)
+  {
+    writer.Value(CreateItem(i));
+    if ((i + 1) % 64 == 0)
+      writer.Flush(output);
+  }
+  writer.EndArray();
+  writer.EndObject();
+  writer.EndObject();
+  writer.Flush(output);
+
+  return output;
+}
+
 TEST(TestJSONVariantWriter, Write)
 {
   CVariant variant;
@@ -31,3 +93,32 @@ TEST(TestJSONVariantWriter, Write)
   str = CJSONVariantWriter::Write(variant, false);
   EXPECT_STREQ("null\n", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, WriteIncremental)
+{
+  EXPECT_EQ(WriteTree(200, true), WriteStreamed(200, true));
+  EXPECT_EQ(WriteTree(200, false), WriteStreamed(200, false));
+}
+
+TEST(TestJSONVariantWriter, WriteDoubleIgnoresLocale)
+{
+  const char *current = setlocale(LC_NUMERIC, NULL);
+  std::string backupLocale = current != NULL ? current : "C";
+
+  // a locale with a decimal comma, if one is installed
+  const char* const locales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "German" };
+  for (size_t i = 0; i < sizeof(locales) / sizeof(locales[0]); i++)
+  {
+    if (setlocale(LC_NUMERIC, locales[i]) != NULL)
+      break;
+  }
+
+  CVariant value(CVariant::VariantTypeArray);
+  value.push_back(6.5);
+  value.push_back(-0.25);
+  std::string str = CJSONVariantWriter::Write(value, true);
+
+  setlocale(LC_NUMERIC, backupLocale.c_str());
+
+  EXPECT_EQ("[6.5,-0.25]", str);
+}
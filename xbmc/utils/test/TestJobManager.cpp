@@ -21,9 +21,13 @@
 #include "utils/JobManager.h"
 #include "settings/Settings.h"
 #include "utils/SystemInfo.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+
 /* CSysInfoJob::GetInternetState() will test for network connectivity. */
 class TestJobManager : public testing::Test
 {
@@ -178,3 +182,139 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class CompletionCounter : public IJobCallback
+{
+public:
+  CompletionCounter(unsigned int expected) : m_expected(expected), m_completed(0) {}
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    CSingleLock lock(m_section);
+    if (++m_completed >= m_expected)
+      m_done.notifyAll();
+  }
+
+  bool Wait(unsigned int milliseconds)
+  {
+    CSingleLock lock(m_section);
+    XbmcThreads::EndTime timeout(milliseconds);
+    while (m_completed < m_expected && !timeout.IsTimePast())
+      m_done.wait(lock, timeout.MillisLeft());
+    return m_completed >= m_expected;
+  }
+
+  class CountingJob : public CJob
+  {
+  public:
+    CountingJob(unsigned int spawn, CompletionCounter &counter)
+      : m_spawn(spawn), m_counter(counter) {}
+
+    const char *GetType() const { return "CountingJob"; }
+
+    bool DoWork()
+    {
+      volatile unsigned int sum = 0;
+      for (unsigned int i = 0; i < 1000; i++)
+        sum += i;
+      for (unsigned int i = 0; i < m_spawn; i++)
+        CJobManager::GetInstance().AddJob(new CountingJob(0, m_counter), &m_counter);
+      return true;
+    }
+
+  private:
+    unsigned int m_spawn;
+    CompletionCounter &m_counter;
+  };
+
+private:
+  unsigned int m_expected;
+  unsigned int m_completed;
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_done;
+};
+}
+
+TEST_F(TestJobManager, JobsAddedFromJobsComplete)
+{
+  const unsigned int parents = 50;
+  const unsigned int children = 4;
+  CompletionCounter counter(parents * (children + 1));
+
+  for (unsigned int i = 0; i < parents; i++)
+    CJobManager::GetInstance().AddJob(new CompletionCounter::CountingJob(children, counter), &counter);
+
+  EXPECT_TRUE(counter.Wait(10000));
+}
+
+TEST_F(TestJobManager, CancelQueuedJob)
+{
+  JobControlPackage package;
+  CJobManager::GetInstance().SetWorkerCount(1);
+  CJobManager::GetInstance().CancelJobs();
+  CJobManager::GetInstance().Restart();
+
+  BroadcastingJob *job(WaitForJobToStartProcessing(CJob::PRIORITY_HIGH, package));
+  CompletionCounter counter(1);
+  unsigned int id = CJobManager::GetInstance().AddJob(new CompletionCounter::CountingJob(0, counter), &counter);
+  CJobManager::GetInstance().CancelJob(id);
+  job->FinishAndStopBlocking();
+
+  EXPECT_FALSE(counter.Wait(200));
+  CJobManager::GetInstance().SetWorkerCount(0);
+}
+
+namespace
+{
+class BlockingJob : public CJob
+{
+public:
+  BlockingJob(std::atomic<int> &running, CEvent &release) : m_running(running), m_release(release) {}
+
+  const char *GetType() const { return "BlockingJob"; }
+
+  bool DoWork()
+  {
+    ++m_running;
+    m_release.Wait();
+    --m_running;
+    return true;
+  }
+
+private:
+  std::atomic<int> &m_running;
+  CEvent &m_release;
+};
+
+bool WaitForRunning(std::atomic<int> &running, int count)
+{
+  XbmcThreads::EndTime timeout(5000);
+  while (running < count && !timeout.IsTimePast())
+    XbmcThreads::ThreadSleep(1);
+  // give the pool the chance to start more than it should
+  XbmcThreads::ThreadSleep(50);
+  return running == count;
+}
+}
+
+TEST_F(TestJobManager, PriorityLimits)
+{
+  std::atomic<int> running(0);
+  CEvent release(true);
+  CompletionCounter counter(7);
+
+  // one worker less for each priority level below high
+  for (unsigned int i = 0; i < 4; i++)
+    CJobManager::GetInstance().AddJob(new BlockingJob(running, release), &counter, CJob::PRIORITY_LOW_PAUSABLE);
+  EXPECT_TRUE(WaitForRunning(running, 2));
+
+  // the slots left are enough for high priority jobs
+  for (unsigned int i = 0; i < 3; i++)
+    CJobManager::GetInstance().AddJob(new BlockingJob(running, release), &counter, CJob::PRIORITY_HIGH);
+  EXPECT_TRUE(WaitForRunning(running, 5));
+
+  release.Set();
+  EXPECT_TRUE(counter.Wait(10000));
+}
@@ -19,10 +19,52 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+namespace
+{
+const char* const Names[] = { "The Beatles", "ABBA", "beck", "Björk", "2Pac", "10cc", "Air", "the Who", "Zappa", "Éric" };
+
+// items with a mix of labels, numbers, folders and special sorting
+DatabaseResults CreateItems(size_t count)
+{
+  DatabaseResults items;
+  items.reserve(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    // spread the values with a multiplicative hash so the input isn't sorted
+    size_t hash = (i * 2654435761U) % 100003;
+
+    DatabaseResult item;
+    item[FieldId] = (int)i;
+    item[FieldLabel] = StringUtils::Format("%s %u", Names[hash % 10], (unsigned int)(hash % 997));
+    item[FieldTitle] = item[FieldLabel];
+    item[FieldArtist] = Names[(hash / 10) % 10];
+    item[FieldAlbum] = StringUtils::Format("Album %u", (unsigned int)(hash % 31));
+    item[FieldYear] = (int)(1960 + hash % 50);
+    item[FieldTrackNumber] = (int)(hash % 20);
+    item[FieldSize] = (int64_t)hash * 1024;
+    item[FieldFolder] = hash % 7 == 0;
+    if (hash % 101 == 0)
+      item[FieldSortSpecial] = (int)(hash % 2 == 0 ? SortSpecialOnTop : SortSpecialOnBottom);
+    items.push_back(item);
+  }
+  return items;
+}
+
+SortItems CreateSortItems(const DatabaseResults &results)
+{
+  SortItems items;
+  items.reserve(results.size());
+  for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); ++it)
+    items.push_back(SortItemPtr(new SortItem(*it)));
+  return items;
+}
+}
+
 TEST(TestSortUtils, Sort_SortBy)
 {
   SortItems items;
@@ -131,3 +173,73 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)4, fields.size());
 }
+
+TEST(TestSortUtils, SortKeys_MatchesSortItems)
+{
+  const SortBy methods[] = { SortByLabel, SortByArtist, SortByTrackNumber, SortBySize, SortByYear };
+  const SortOrder orders[] = { SortOrderAscending, SortOrderDescending };
+  const SortAttribute attributes[] = { SortAttributeNone, SortAttributeIgnoreFolders, SortAttributeIgnoreArticle };
+
+  for (size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++)
+  {
+    for (size_t o = 0; o < sizeof(orders) / sizeof(orders[0]); o++)
+    {
+      for (size_t a = 0; a < sizeof(attributes) / sizeof(attributes[0]); a++)
+      {
+        DatabaseResults results = CreateItems(500);
+        SortItems items = CreateSortItems(results);
+
+        SortUtils::Sort(methods[m], orders[o], attributes[a], results, 400, 50);
+        SortUtils::Sort(methods[m], orders[o], attributes[a], items, 400, 50);
+
+        ASSERT_EQ(items.size(), results.size());
+        for (size_t i = 0; i < results.size(); i++)
+          ASSERT_EQ(items[i]->at(FieldId).asInteger(), results[i].at(FieldId).asInteger())
+            << "sort method " << methods[m] << ", order " << orders[o] << ", attributes " << attributes[a] << ", index " << i;
+      }
+    }
+  }
+}
+
+TEST(TestSortUtils, SortKeys_NegativeNumbersUseLabel)
+{
+  CSortKeys keys(SortBySize, SortAttributeNone);
+  const int64_t sizes[] = { 5, -30, -4 };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    SortItem item;
+    item[FieldSize] = sizes[i];
+    keys.Add(item);
+  }
+
+  std::vector<size_t> order;
+  keys.Sort(SortOrderAscending, order);
+
+  // the labels compare "-4" before "-30"
+  ASSERT_EQ(3U, order.size());
+  EXPECT_EQ(2U, order[0]);
+  EXPECT_EQ(1U, order[1]);
+  EXPECT_EQ(0U, order[2]);
+  EXPECT_TRUE(keys.GetLabel(1) == L"-30");
+}
+
+TEST(TestSortUtils, SortKeys_NegativeNumbersCompareDigitRuns)
+{
+  CSortKeys keys(SortBySize, SortAttributeNone);
+  const int64_t sizes[] = { -30, -4, -100 };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    SortItem item;
+    item[FieldSize] = sizes[i];
+    keys.Add(item);
+  }
+
+  std::vector<size_t> order;
+  keys.Sort(SortOrderAscending, order);
+
+  // the digits after the sign compare by value, "-4" before "-30" before "-100"
+  ASSERT_EQ(3U, order.size());
+  EXPECT_EQ(1U, order[0]);
+  EXPECT_EQ(0U, order[1]);
+  EXPECT_EQ(2U, order[2]);
+}
@@ -18,10 +18,20 @@
  *
  */
 
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+namespace
+{
+template<typename T>
+bool IsWithin(const char *ptr, const T *object)
+{
+  return ptr >= reinterpret_cast<const char*>(object) && ptr < reinterpret_cast<const char*>(object + 1);
+}
+}
+
 TEST(TestVariant, VariantTypeInteger)
 {
   CVariant a((int)0), b((int64_t)1);
@@ -348,3 +358,53 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, map_order)
+{
+  CVariant a;
+  a["key3"] = "string3";
+  a["key1"] = "string1";
+  a["key4"] = CVariant::ConstNullVariant;
+  a["key2"] = "string2";
+
+  const char* const keys[] = { "key1", "key2", "key3", "key4" };
+  unsigned int index = 0;
+  for (CVariant::const_iterator_map it = a.begin_map(); it != a.end_map(); ++it, ++index)
+    EXPECT_STREQ(keys[index], it->first.c_str());
+  EXPECT_EQ(4u, index);
+
+  // members copied from ConstNullVariant must survive other members moving around
+  a["key0"] = "string0";
+  a.erase("key2");
+  EXPECT_TRUE(a.isMember("key4"));
+  EXPECT_TRUE(a["key4"].isNull());
+  EXPECT_STREQ("string0", a["key0"].c_str());
+  EXPECT_STREQ("string3", a["key3"].c_str());
+  EXPECT_EQ(4u, a.size());
+}
+
+TEST(TestVariant, storage)
+{
+  // short strings live in the variant itself wherever std::string keeps them inline
+  std::string str("short");
+  CVariant a(str);
+  if (IsWithin(str.c_str(), &str))
+    EXPECT_TRUE(IsWithin(a.c_str(), &a));
+
+  std::vector<std::pair<std::string, std::string> > members;
+  for (int i = 0; i < 8; i++)
+    members.push_back(std::make_pair(StringUtils::Format("key%d", i), StringUtils::Format("value%d", i)));
+
+  CVariant b;
+  for (size_t i = 0; i < members.size(); i++)
+    b[members[i].first] = members[i].second;
+
+  // all members of a copy share one block
+  CVariant c(b);
+  EXPECT_EQ(b, c);
+  const std::pair<std::string, CVariant> *first = &*c.begin_map();
+  size_t index = 0;
+  for (CVariant::const_iterator_map it = c.begin_map(); it != c.end_map(); ++it, ++index)
+    EXPECT_EQ(first + index, &*it);
+  EXPECT_EQ(members.size(), index);
+}
@@ -517,7 +517,6 @@ void CVideoDatabase::CreateViews()
 //********************************************************************************************************************************
 int CVideoDatabase::GetPathId(const std::string& strPath)
 {
-  std::string strSQL;
   try
   {
     int idPath=-1;
@@ -530,8 +529,9 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    sql_params params;
+    params.push_back(strPath1);
+    m_pDS->query("select idPath from path where strPath=?", params);
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -540,7 +540,7 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strSQL.c_str());
+    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strPath.c_str());
   }
   return -1;
 }
@@ -1062,9 +1062,10 @@ int CVideoDatabase::GetFileId(const std::string& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      std::string strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL);
+      sql_params params;
+      params.push_back(strFileName);
+      params.push_back(idPath);
+      m_pDS->query("select idFile from files where strFileName=? and idPath=?", params);
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -1409,6 +1410,16 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
+    std::string lookupKey;
+    if (InBatch())
+    {
+      lookupKey = table + '\n' + value.substr(0, 255);
+      std::map<std::string, int>::const_iterator cached = m_batchLookups.find(lookupKey);
+      if (cached != m_batchLookups.end())
+        return cached->second;
+    }
+
+    int id;
     std::string strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
     m_pDS->query(strSQL);
     if (m_pDS->num_rows() == 0)
@@ -1417,15 +1428,16 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
       // doesnt exists, add it
       strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
       m_pDS->exec(strSQL);
-      int id = (int)m_pDS->lastinsertid();
-      return id;
+      id = (int)m_pDS->lastinsertid();
     }
     else
     {
-      int id = m_pDS->fv(firstField.c_str()).get_asInt();
+      id = m_pDS->fv(firstField.c_str()).get_asInt();
       m_pDS->close();
-      return id;
     }
+    if (!lookupKey.empty())
+      m_batchLookups[lookupKey] = id;
+    return id;
   }
   catch (...)
   {
@@ -1612,7 +1624,29 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
     std::string trimmedName = name.c_str();
     StringUtils::Trim(trimmedName);
 
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
+    std::string lookupKey;
+    std::map<std::string, int>::const_iterator cached = m_batchLookups.end();
+    if (InBatch())
+    {
+      lookupKey = "actor\n" + trimmedName.substr(0, 255);
+      cached = m_batchLookups.find(lookupKey);
+    }
+
+    std::string strSQL;
+    if (cached != m_batchLookups.end())
+    {
+      idActor = cached->second;
+      if (!thumbURLs.empty())
+      {
+        strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
+        m_pDS->exec(strSQL);
+      }
+      if (!thumb.empty())
+        SetArtForItem(idActor, "actor", "thumb", thumb);
+      return idActor;
+    }
+
+    strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
     m_pDS->query(strSQL);
     if (m_pDS->num_rows() == 0)
     {
@@ -1633,6 +1667,8 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
         m_pDS->exec(strSQL);
       }
     }
+    if (!lookupKey.empty())
+      m_batchLookups[lookupKey] = idActor;
     // add artwork
     if (!thumb.empty())
       SetArtForItem(idActor, "actor", "thumb", thumb);
@@ -1680,15 +1716,18 @@ void CVideoDatabase::RemoveFromLinkTable(int mediaId, const std::string& mediaTy
 
 void CVideoDatabase::AddLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  std::vector<std::string> rows;
   for (const auto &i : values)
   {
     if (!i.empty())
     {
       int idValue = AddToTable(field, field + "_id", "name", i);
       if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue);
+        rows.push_back(PrepareSQL("%i,%i,'%s'", idValue, mediaId, mediaType.c_str()));
     }
   }
+  if (!rows.empty())
+    InsertRows(field + "_link", field + "_id,media_id,media_type", rows, true);
 }
 
 void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -1701,15 +1740,18 @@ void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType
 
 void CVideoDatabase::AddActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  std::vector<std::string> rows;
   for (const auto &i : values)
   {
     if (!i.empty())
     {
       int idValue = AddActor(i, "");
       if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue, "actor");
+        rows.push_back(PrepareSQL("%i,%i,'%s'", idValue, mediaId, mediaType.c_str()));
     }
   }
+  if (!rows.empty())
+    InsertRows(field + "_link", "actor_id,media_id,media_type", rows, true);
 }
 
 void CVideoDatabase::UpdateActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -1752,11 +1794,15 @@ void CVideoDatabase::AddCast(int mediaId, const char *mediaType, const std::vect
     return;
 
   int order = std::max_element(cast.begin(), cast.end())->order;
+  std::vector<std::string> rows;
   for (const auto &i : cast)
   {
     int idActor = AddActor(i.strName, i.thumbUrl.m_xml, i.thumb);
-    AddLinkToActor(mediaId, mediaType, idActor, i.strRole, i.order >= 0 ? i.order : ++order);
+    if (idActor > -1)
+      rows.push_back(PrepareSQL("%i,%i,'%s','%s',%i", idActor, mediaId, mediaType, i.strRole.c_str(), i.order >= 0 ? i.order : ++order));
   }
+  // a duplicate actor keeps its first role, as the existing link is left alone
+  InsertRows("actor_link", "actor_id,media_id,media_type,role,cast_order", rows, true);
 }
 
 //********************************************************************************************************************************
@@ -3634,8 +3680,9 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
   std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
   try
   {
-    std::string strSQL = PrepareSQL("SELECT * FROM streamdetails WHERE idFile = %i", tag.m_iFileId);
-    pDS->query(strSQL);
+    sql_params params;
+    params.push_back(tag.m_iFileId);
+    pDS->query("SELECT * FROM streamdetails WHERE idFile = ?", params);
 
     while (!pDS->eof())
     {
@@ -4036,19 +4083,21 @@ void CVideoDatabase::GetCast(int media_id, const std::string &media_type, std::v
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT actor.name,"
-                                 "  actor_link.role,"
-                                 "  actor_link.cast_order,"
-                                 "  actor.art_urls,"
-                                 "  art.url "
-                                 "FROM actor_link"
-                                 "  JOIN actor ON"
-                                 "    actor_link.actor_id=actor.actor_id"
-                                 "  LEFT JOIN art ON"
-                                 "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
-                                 "WHERE actor_link.media_id=%i AND actor_link.media_type='%s'"
-                                 "ORDER BY actor_link.cast_order", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    sql_params params;
+    params.push_back(media_id);
+    params.push_back(media_type);
+    m_pDS2->query("SELECT actor.name,"
+                  "  actor_link.role,"
+                  "  actor_link.cast_order,"
+                  "  actor.art_urls,"
+                  "  art.url "
+                  "FROM actor_link"
+                  "  JOIN actor ON"
+                  "    actor_link.actor_id=actor.actor_id"
+                  "  LEFT JOIN art ON"
+                  "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                  "WHERE actor_link.media_id=? AND actor_link.media_type=? "
+                  "ORDER BY actor_link.cast_order", params);
     while (!m_pDS2->eof())
     {
       SActorInfo info;
@@ -4087,8 +4136,10 @@ void CVideoDatabase::GetTags(int media_id, const std::string &media_type, std::v
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id = %i AND tag_link.media_type = '%s' ORDER BY tag.tag_id", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    sql_params params;
+    params.push_back(media_id);
+    params.push_back(media_type);
+    m_pDS2->query("SELECT tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id = ? AND tag_link.media_type = ? ORDER BY tag.tag_id", params);
     while (!m_pDS2->eof())
     {
       tags.emplace_back(m_pDS2->fv(0).get_asString());
@@ -4109,8 +4160,10 @@ void CVideoDatabase::GetRatings(int media_id, const std::string &media_type, Rat
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id = %i AND rating.media_type = '%s'", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    sql_params params;
+    params.push_back(media_id);
+    params.push_back(media_type);
+    m_pDS2->query("SELECT rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id = ? AND rating.media_type = ?", params);
     while (!m_pDS2->eof())
     {
       ratings[m_pDS2->fv(0).get_asString()] = CRating(m_pDS2->fv(1).get_asFloat(), m_pDS2->fv(2).get_asInt());
@@ -4131,8 +4184,10 @@ void CVideoDatabase::GetUniqueIDs(int media_id, const std::string &media_type, C
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT type, value FROM uniqueid WHERE media_id = %i AND media_type = '%s'", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    sql_params params;
+    params.push_back(media_id);
+    params.push_back(media_type);
+    m_pDS2->query("SELECT type, value FROM uniqueid WHERE media_id = ? AND media_type = ?", params);
     while (!m_pDS2->eof())
     {
       details.SetUniqueID(m_pDS2->fv(1).get_asString(), m_pDS2->fv(0).get_asString());
@@ -4280,8 +4335,11 @@ void CVideoDatabase::SetArtForItem(int mediaId, const MediaType &mediaType, cons
     if (artType.find('.') != std::string::npos)
       return;
 
-    std::string sql = PrepareSQL("SELECT art_id,url FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
-    m_pDS->query(sql);
+    sql_params params;
+    params.push_back(mediaId);
+    params.push_back(mediaType);
+    params.push_back(artType);
+    m_pDS->query("SELECT art_id,url FROM art WHERE media_id=? AND media_type=? AND type=?", params);
     if (!m_pDS->eof())
     { // update
       int artId = m_pDS->fv(0).get_asInt();
@@ -4289,15 +4347,17 @@ void CVideoDatabase::SetArtForItem(int mediaId, const MediaType &mediaType, cons
       m_pDS->close();
       if (oldUrl != url)
       {
-        sql = PrepareSQL("UPDATE art SET url='%s' where art_id=%d", url.c_str(), artId);
-        m_pDS->exec(sql);
+        params.clear();
+        params.push_back(url);
+        params.push_back(artId);
+        m_pDS->exec("UPDATE art SET url=? where art_id=?", params);
       }
     }
     else
     { // insert
       m_pDS->close();
-      sql = PrepareSQL("INSERT INTO art(media_id, media_type, type, url) VALUES (%d, '%s', '%s', '%s')", mediaId, mediaType.c_str(), artType.c_str(), url.c_str());
-      m_pDS->exec(sql);
+      params.push_back(url);
+      m_pDS->exec("INSERT INTO art(media_id, media_type, type, url) VALUES (?, ?, ?, ?)", params);
     }
   }
   catch (...)
@@ -4313,8 +4373,10 @@ bool CVideoDatabase::GetArtForItem(int mediaId, const MediaType &mediaType, std:
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS2.get()) return false; // using dataset 2 as we're likely called in loops on dataset 1
 
-    std::string sql = PrepareSQL("SELECT type,url FROM art WHERE media_id=%i AND media_type='%s'", mediaId, mediaType.c_str());
-    m_pDS2->query(sql);
+    sql_params params;
+    params.push_back(mediaId);
+    params.push_back(mediaType);
+    m_pDS2->query("SELECT type,url FROM art WHERE media_id=? AND media_type=?", params);
     while (!m_pDS2->eof())
     {
       art.insert(make_pair(m_pDS2->fv(0).get_asString(), m_pDS2->fv(1).get_asString()));
@@ -4332,8 +4394,11 @@ bool CVideoDatabase::GetArtForItem(int mediaId, const MediaType &mediaType, std:
 
 std::string CVideoDatabase::GetArtForItem(int mediaId, const MediaType &mediaType, const std::string &artType)
 {
-  std::string query = PrepareSQL("SELECT url FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
-  return GetSingleValue(query, m_pDS2);
+  sql_params params;
+  params.push_back(mediaId);
+  params.push_back(mediaType);
+  params.push_back(artType);
+  return GetSingleValue("SELECT url FROM art WHERE media_id=? AND media_type=? AND type=?", params, m_pDS2);
 }
 
 bool CVideoDatabase::RemoveArtForItem(int mediaId, const MediaType &mediaType, const std::string &artType)
@@ -9521,6 +9586,10 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
 
 bool CVideoDatabase::CommitTransaction()
 {
+  // the library flags are refreshed once the whole batch is committed
+  if (InBatch())
+    return CDatabase::CommitTransaction();
+
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
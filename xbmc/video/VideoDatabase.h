@@ -985,4 +985,11 @@ private:
 
   static void AnnounceRemove(std::string content, int id, bool scanning = false);
   static void AnnounceUpdate(std::string content, int id);
+
+  virtual void OnBatchInvalidated() { m_batchLookups.clear(); }
+
+  /*! \brief Ids of genres, studios, actors etc. looked up or added during
+   the current batch, keyed by table and name, to spare repeated queries.
+   */
+  std::map<std::string, int> m_batchLookups;
 };
@@ -415,6 +415,8 @@ namespace VIDEO
     }
 
     m_database.Open();
+    // write the whole directory in one transaction, each item in its own savepoint
+    m_database.BeginBatch();
 
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
@@ -497,6 +499,7 @@ namespace VIDEO
     if(pDlgProgress)
       pDlgProgress->ShowProgressBar(false);
 
+    m_database.CommitBatch();
     m_database.Close();
     return FoundSomeInfo;
   }
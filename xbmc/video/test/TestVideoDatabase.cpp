@@ -0,0 +1,187 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+
+using namespace XFILE;
+
+#define DATABASE_PATH "special://temp/test_video_database/"
+
+namespace
+{
+class CTestVideoDatabase : public CVideoDatabase
+{
+public:
+  using CVideoDatabase::GetFileId;
+
+  bool Create()
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath(DATABASE_PATH);
+    return Update(settings);
+  }
+
+  int Count(const char *table)
+  {
+    return atoi(GetSingleValue(PrepareSQL("SELECT COUNT(*) FROM %s", table)).c_str());
+  }
+};
+}
+
+class TestVideoDatabase : public testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    CDirectory::RemoveRecursive(DATABASE_PATH);
+    CDirectory::Create(DATABASE_PATH);
+  }
+
+  virtual void TearDown()
+  {
+    CDirectory::RemoveRecursive(DATABASE_PATH);
+  }
+
+  /* Add shows * episodes episodes the way the scanner does, each show
+     within one batch when batched is set. */
+  void AddEpisodes(CTestVideoDatabase &db, int shows, int episodes, bool batched)
+  {
+    std::map<std::string, std::string> art;
+    art["thumb"] = "thumb.jpg";
+    std::map<int, std::map<std::string, std::string> > seasonArt;
+
+    for (int show = 0; show < shows; show++)
+    {
+      if (batched)
+        db.BeginBatch();
+
+      std::string showPath = StringUtils::Format("/tmp/tv/show%i/", show);
+      std::vector<std::pair<std::string, std::string> > paths;
+      paths.push_back(std::make_pair(showPath, "/tmp/tv/"));
+      CVideoInfoTag showTag;
+      showTag.SetTitle(StringUtils::Format("Show %i", show));
+      int idShow = db.SetDetailsForTvShow(paths, showTag, art, seasonArt);
+
+      for (int episode = 0; episode < episodes; episode++)
+      {
+        CVideoInfoTag tag;
+        tag.SetTitle(StringUtils::Format("Episode %i", episode));
+        tag.m_iSeason = episode / 20 + 1;
+        tag.m_iEpisode = episode % 20 + 1;
+        tag.m_genre.push_back(StringUtils::Format("Genre %i", (show + episode) % 30));
+        tag.m_genre.push_back("Drama");
+        tag.m_director.push_back(StringUtils::Format("Director %i", episode % 50));
+        tag.m_writingCredits.push_back(StringUtils::Format("Writer %i", episode % 70));
+        for (int i = 0; i < 10; i++)
+        {
+          SActorInfo actor;
+          actor.strName = StringUtils::Format("Actor %i", (show * 7 + episode + i) % 500);
+          actor.strRole = StringUtils::Format("Role %i", i);
+          actor.order = i;
+          tag.m_cast.push_back(actor);
+        }
+        std::string file = StringUtils::Format("%sS%02dE%02d.mkv", showPath.c_str(), tag.m_iSeason, tag.m_iEpisode);
+        db.SetDetailsForEpisode(file, tag, art, idShow);
+      }
+
+      if (batched)
+        db.CommitBatch();
+    }
+  }
+};
+
+TEST_F(TestVideoDatabase, BatchedEpisodesMatchUnbatched)
+{
+  int counts[2][4];
+  for (int batched = 0; batched < 2; batched++)
+  {
+    CTestVideoDatabase db;
+    ASSERT_TRUE(db.Create());
+    AddEpisodes(db, 3, 25, batched != 0);
+
+    counts[batched][0] = db.Count("episode");
+    counts[batched][1] = db.Count("actor_link");
+    counts[batched][2] = db.Count("genre_link");
+    counts[batched][3] = db.Count("director_link");
+    db.Close();
+    CDirectory::RemoveRecursive(DATABASE_PATH);
+    CDirectory::Create(DATABASE_PATH);
+  }
+
+  EXPECT_EQ(75, counts[1][0]);
+  EXPECT_EQ(750, counts[1][1]);
+  EXPECT_EQ(150, counts[1][2]);
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(counts[0][i], counts[1][i]);
+}
+
+TEST_F(TestVideoDatabase, RollbackInBatchKeepsOtherItems)
+{
+  CTestVideoDatabase db;
+  ASSERT_TRUE(db.Create());
+
+  db.BeginBatch();
+  AddEpisodes(db, 1, 5, false);
+  db.BeginTransaction();
+  db.ExecuteQuery("DELETE FROM episode");
+  db.RollbackTransaction();
+  EXPECT_TRUE(db.CommitBatch());
+
+  EXPECT_EQ(5, db.Count("episode"));
+}
+
+TEST_F(TestVideoDatabase, ParameterizedQueriesKeepValuesVerbatim)
+{
+  CTestVideoDatabase db;
+  ASSERT_TRUE(db.Create());
+
+  // quotes and placeholders inside the values must survive the round trip
+  const std::string url = "/tmp/it's a \"thumb\"?.jpg";
+  db.SetArtForItem(1, MediaTypeMovie, "thumb", url);
+  db.SetArtForItem(1, MediaTypeMovie, "fanart", "fanart.jpg");
+  db.SetArtForItem(2, MediaTypeMovie, "thumb", "other.jpg");
+
+  std::map<std::string, std::string> art;
+  EXPECT_TRUE(db.GetArtForItem(1, MediaTypeMovie, art));
+  EXPECT_EQ(2U, art.size());
+  EXPECT_EQ(url, art["thumb"]);
+  EXPECT_EQ(url, db.GetArtForItem(1, MediaTypeMovie, "thumb"));
+
+  // reused statements see the new values
+  db.SetArtForItem(1, MediaTypeMovie, "thumb", "new.jpg");
+  EXPECT_EQ("new.jpg", db.GetArtForItem(1, MediaTypeMovie, "thumb"));
+  EXPECT_EQ("other.jpg", db.GetArtForItem(2, MediaTypeMovie, "thumb"));
+  EXPECT_EQ("", db.GetArtForItem(3, MediaTypeMovie, "thumb"));
+
+  int idFile = db.AddFile("/tmp/movies/it's here.mkv");
+  EXPECT_LT(0, idFile);
+  EXPECT_EQ(idFile, db.GetFileId("/tmp/movies/it's here.mkv"));
+  EXPECT_EQ(-1, db.GetFileId("/tmp/movies/its here.mkv"));
+}
@@ -169,7 +169,9 @@ bool CWinEventsLinux::MessagePump()
     int state = CInputManager::GetInstance().GetMouseState() - 1;
     if (m_mouse_state != state)
     {
-      if (state >= 0 && state < (int)(sizeof m_cursors/sizeof *m_cursors) && !m_cursors[state].m_texture.m_textures.empty())
+      // atlas pages hold more than the cursor image, so those can't be used as a hardware cursor
+      if (state >= 0 && state < (int)(sizeof m_cursors/sizeof *m_cursors) && !m_cursors[state].m_texture.m_textures.empty() &&
+          !m_cursors[state].m_texture.m_atlased)
       {
         CBaseTexture *t = (m_cursors[state].m_texture.m_textures)[0];
         if (t)
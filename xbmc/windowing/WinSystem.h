@@ -77,6 +77,8 @@ public:
   virtual bool UseLimitedColor();
   //the number of presentation buffers
   virtual int NoOfBuffers();
+  //the number of frames since the back buffer was last rendered to, 0 if its content is undefined, -1 if unknown
+  virtual int GetBufferAge() { return -1; }
 
   virtual bool Minimize() { return false; }
   virtual bool Restore() { return false; }
@@ -38,6 +38,7 @@ public:
   virtual void SetVSync(bool enable) = 0;
   virtual void SwapBuffers() = 0;
   virtual void QueryExtensions() = 0;
+  virtual int GetBufferAge() { return -1; }
   bool IsExtSupported(const char* extension) const;
 
   std::string ExtPrefix(){ return m_extPrefix; };
@@ -364,6 +364,21 @@ void CGLContextEGL::SwapBuffers()
   eglSwapBuffers(m_eglDisplay, m_eglSurface);
 }
 
+int CGLContextEGL::GetBufferAge()
+{
+  if (!IsExtSupported("EGL_EXT_buffer_age") ||
+      (m_eglDisplay == EGL_NO_DISPLAY) || (m_eglSurface == EGL_NO_SURFACE))
+    return -1;
+
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+  EGLint age = 0;
+  if (!eglQuerySurface(m_eglDisplay, m_eglSurface, EGL_BUFFER_AGE_EXT, &age))
+    return 0;
+  return age;
+}
+
 void CGLContextEGL::QueryExtensions()
 {
   std::string extensions = eglQueryString(m_eglDisplay, EGL_EXTENSIONS);
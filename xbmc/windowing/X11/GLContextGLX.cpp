@@ -267,6 +267,19 @@ void CGLContextGLX::SwapBuffers()
     glXSwapBuffers(m_dpy, m_glxWindow);
 }
 
+int CGLContextGLX::GetBufferAge()
+{
+  if (!IsExtSupported("GLX_EXT_buffer_age") || !m_glxWindow)
+    return -1;
+
+#ifndef GLX_BACK_BUFFER_AGE_EXT
+#define GLX_BACK_BUFFER_AGE_EXT 0x20F4
+#endif
+  unsigned int age = 0;
+  glXQueryDrawable(m_dpy, m_glxWindow, GLX_BACK_BUFFER_AGE_EXT, &age);
+  return age;
+}
+
 void CGLContextGLX::QueryExtensions()
 {
   m_extensions  = " ";
@@ -34,6 +34,7 @@ public:
   void SetVSync(bool enable) override;
   void SwapBuffers() override;
   void QueryExtensions() override;
+  int GetBufferAge() override;
   GLXWindow m_glxWindow;
   GLXContext m_glxContext;
 protected:
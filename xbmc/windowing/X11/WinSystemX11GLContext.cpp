@@ -64,6 +64,11 @@ void CWinSystemX11GLContext::SetVSyncImpl(bool enable)
   m_pGLContext->SetVSync(enable);
 }
 
+int CWinSystemX11GLContext::GetBufferAge()
+{
+  return m_pGLContext ? m_pGLContext->GetBufferAge() : -1;
+}
+
 bool CWinSystemX11GLContext::IsExtSupported(const char* extension)
 {
   if(strncmp(extension, m_pGLContext->ExtPrefix().c_str(), 4) != 0)
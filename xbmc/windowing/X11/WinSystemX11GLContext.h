@@ -42,6 +42,7 @@ public:
   bool DestroyWindow() override;
 
   bool IsExtSupported(const char* extension) override;
+  int GetBufferAge() override;
 
   GLXWindow GetWindow() const;
   GLXContext GetGlxContext() const;
@@ -38,6 +38,11 @@ void CWinSystemX11GLESContext::SetVSyncImpl(bool enable)
   m_pGLContext->SetVSync(enable);
 }
 
+int CWinSystemX11GLESContext::GetBufferAge()
+{
+  return m_pGLContext ? m_pGLContext->GetBufferAge() : -1;
+}
+
 bool CWinSystemX11GLESContext::IsExtSupported(const char* extension)
 {
   if(strncmp(extension, m_pGLContext->ExtPrefix().c_str(), 4) != 0)
@@ -40,6 +40,7 @@ public:
   bool DestroyWindow() override;
 
   bool IsExtSupported(const char* extension) override;
+  int GetBufferAge() override;
 
   EGLDisplay GetEGLDisplay() const { return  m_pGLContext->m_eglDisplay; }
   EGLSurface GetEGLSurface() const { return  m_pGLContext->m_eglSurface; }
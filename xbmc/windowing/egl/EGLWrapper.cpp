@@ -310,6 +310,18 @@ bool CEGLWrapper::GetSurfaceSize(EGLDisplay display, EGLSurface surface, EGLint
   return true;
 }
 
+bool CEGLWrapper::GetBufferAge(EGLDisplay display, EGLSurface surface, EGLint *age)
+{
+  if (!age || (display == EGL_NO_DISPLAY) || (surface == EGL_NO_SURFACE))
+    return false;
+
+  // part of EGL_EXT_buffer_age
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+  return eglQuerySurface(display, surface, EGL_BUFFER_AGE_EXT, age);
+}
+
 bool CEGLWrapper::BindContext(EGLDisplay display, EGLSurface surface, EGLContext context)
 {
   EGLBoolean status;
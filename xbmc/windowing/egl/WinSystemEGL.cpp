@@ -57,6 +57,7 @@ CWinSystemEGL::CWinSystemEGL() : CWinSystemBase()
   m_egl               = NULL;
   m_iVSyncMode        = 0;
   m_delayDispReset    = false;
+  m_bufferAge         = false;
 }
 
 CWinSystemEGL::~CWinSystemEGL()
@@ -106,10 +107,16 @@ bool CWinSystemEGL::InitWindowSystem()
     return false;
   }
 
+  m_extensions = m_egl->GetExtensions(m_display);
+
   EGLint surface_type = EGL_WINDOW_BIT;
-  // for the non-trivial dirty region modes, we need the EGL buffer to be preserved across updates
-  if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_COST_REDUCTION ||
-      g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_UNION)
+  // for the non-trivial dirty region modes, we need to know what is in the back buffer: either
+  // its age, so we can render what changed since, or the EGL buffer to be preserved across updates
+  m_bufferAge = m_extensions.find(" EGL_EXT_buffer_age ") != std::string::npos;
+  if (m_bufferAge)
+    CLog::Log(LOGDEBUG, "%s: Using EGL_EXT_buffer_age for partial updates",__FUNCTION__);
+  else if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_COST_REDUCTION ||
+           g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_UNION)
     surface_type |= EGL_SWAP_BEHAVIOR_PRESERVED_BIT;
 
   EGLint configAttrs [] = {
@@ -142,7 +149,6 @@ bool CWinSystemEGL::InitWindowSystem()
     CreateWindow(temp);
   }
 
-  m_extensions = m_egl->GetExtensions(m_display);
   return CWinSystemBase::InitWindowSystem();
 }
 
@@ -223,8 +229,9 @@ bool CWinSystemEGL::CreateWindow(RESOLUTION_INFO &res)
 
 
   // for the non-trivial dirty region modes, we need the EGL buffer to be preserved across updates
-  if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_COST_REDUCTION ||
-      g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_UNION)
+  if (!m_bufferAge &&
+      (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_COST_REDUCTION ||
+       g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_UNION))
   {
     if (!m_egl->SurfaceAttrib(m_display, m_surface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_PRESERVED))
       CLog::Log(LOGDEBUG, "%s: Could not set EGL_SWAP_BEHAVIOR",__FUNCTION__);
@@ -452,6 +459,17 @@ bool CWinSystemEGL::IsExtSupported(const char* extension)
   return (m_extensions.find(name) != std::string::npos || CRenderSystemGLES::IsExtSupported(extension));
 }
 
+int CWinSystemEGL::GetBufferAge()
+{
+  if (!m_bufferAge)
+    return -1;
+
+  EGLint age = 0;
+  if (!m_egl->GetBufferAge(m_display, m_surface, &age))
+    return 0;
+  return age;
+}
+
 void CWinSystemEGL::PresentRenderImpl(bool rendered)
 {
   if (m_delayDispReset && m_dispResetTimer.IsTimePast())
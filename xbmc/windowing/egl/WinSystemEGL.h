@@ -50,6 +50,7 @@ public:
   virtual void  UpdateResolutions();
   virtual bool  IsExtSupported(const char* extension);
   virtual bool  CanDoWindowed() { return false; }
+  virtual int   GetBufferAge();
 
   virtual void  ShowOSMouse(bool show);
   virtual bool  HasCursor();
@@ -86,6 +87,7 @@ protected:
 
   CEGLWrapper           *m_egl;
   std::string           m_extensions;
+  bool                  m_bufferAge;
   CCriticalSection             m_resourceSection;
   std::vector<IDispResource*>  m_resources;
   bool m_delayDispReset;
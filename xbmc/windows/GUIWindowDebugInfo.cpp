@@ -31,6 +31,7 @@
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/TextureManager.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
@@ -122,6 +123,13 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+    unsigned int drawCalls, vertices;
+    g_graphicsContext.GetRenderStats(drawCalls, vertices);
+    info += StringUtils::Format("\nGUI: %u draw calls, %u vertices", drawCalls, vertices);
+    unsigned int packed, loaded, pages;
+    g_TextureManager.GetAtlasStats(packed, loaded, pages);
+    info += StringUtils::Format(", atlas: %u/%u images in %u pages", packed, loaded, pages);
+    info += StringUtils::Format("\nInfo: %u conditions evaluated per frame", g_infoManager.GetBoolEvaluations());
   }
 
   // render the skin debug info